@@ -8,6 +8,8 @@
 
 #include "Compat.hh"
 #include "Charset.hh"
+#include "Ctrl.hh"
+#include "CtrlSocket.hh"
 #include "Daytime.hh"
 #include "Debug.hh"
 #include "Location.hh"
@@ -26,11 +28,10 @@ extern "C" {
 #include <unistd.h>
 }
 
-typedef bool(*send_message_fun)(Window, AtomName, int, const void*, size_t,
-                                void *opaque);
-
 enum CtrlAction {
 	PEKWM_CTRL_ACTION_RUN,
+	PEKWM_CTRL_ACTION_BATCH,
+	PEKWM_CTRL_ACTION_QUERY,
 	PEKWM_CTRL_ACTION_FOCUS,
 	PEKWM_CTRL_ACTION_RESTACK,
 	PEKWM_CTRL_ACTION_LIST,
@@ -43,8 +44,6 @@ enum CtrlAction {
 	PEKWM_CTRL_ACTION_NO
 };
 
-#ifndef UNITTEST
-
 static const char *progname = nullptr;
 static ObserverMapping* _observer_mapping = nullptr;
 
@@ -98,9 +97,9 @@ static void usage(const char *action, int ret)
 
 	std::cout << "usage: " << progname << " [-acdhs] [command]"
 		  << std::endl;
-	std::cout << "  -a --action [run|focus|restack|list|list-stacking"
-		  << "|list-children|list-all|util] Control action"
-		  << std::endl;
+	std::cout << "  -a --action [run|batch|query|focus|restack|list"
+		  << "|list-stacking|list-children|list-all|util]"
+		  << " Control action" << std::endl;
 	std::cout << "  -c --client pattern  Client pattern" << std::endl;
 	std::cout << "  -C pattern           Other client pattern" << std::endl;
 	std::cout << "  -d --display dpy     Display" << std::endl;
@@ -125,7 +124,11 @@ static std::string formatTime(time_t ts)
 
 static CtrlAction getAction(const std::string& name)
 {
-	if (name == "focus") {
+	if (name == "batch") {
+		return PEKWM_CTRL_ACTION_BATCH;
+	} else if (name == "query") {
+		return PEKWM_CTRL_ACTION_QUERY;
+	} else if (name == "focus") {
 		return PEKWM_CTRL_ACTION_FOCUS;
 	} else if (name == "restack") {
 		return PEKWM_CTRL_ACTION_RESTACK;
@@ -264,35 +267,6 @@ static bool restackWindow(int argc, char *argv[], Window win, Window sibling)
 	return true;
 }
 
-#endif // ! UNITTEST
-
-static bool sendCommand(const std::string& cmd, Window win,
-			send_message_fun send_message, void *opaque)
-{
-	XClientMessageEvent ev;
-	char buf[sizeof(ev.data.b)] = {0};
-	int chunk_size = sizeof(buf) - 1;
-
-	const char *src = cmd.c_str();
-	int left = cmd.size();
-	buf[chunk_size] = static_cast<int>(cmd.size()) <= chunk_size ? 0 : 1;
-	memcpy(buf, src, std::min(left, chunk_size));
-	bool res = send_message(win, PEKWM_CMD, 8, buf, sizeof(buf), opaque);
-	src += chunk_size;
-	left -= chunk_size;
-	while (res && left > 0) {
-		memset(buf, 0, sizeof(buf));
-		buf[chunk_size] = left <= chunk_size ? 3 : 2;
-		memcpy(buf, src, std::min(left, chunk_size));
-		src += chunk_size;
-		left -= chunk_size;
-		res = send_message(win, PEKWM_CMD, 8, buf, sizeof(buf), opaque);
-	}
-
-	return res;
-}
-
-#ifndef UNITTEST
 
 static void printClient(Window win, const char *indent = "")
 {
@@ -479,7 +453,50 @@ static void printRes(bool res)
 	}
 }
 
-static bool actionRun(int argc, char** argv, Window client)
+/**
+ * Send single request on the control socket, reading the reply.
+ */
+static bool ctrlRequest(int fd, const std::string &req, std::string &reply)
+{
+	if (! Ctrl::write(fd, req) || ! Ctrl::readLine(fd, reply)) {
+		std::cerr << "failed to send request on control socket"
+			  << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Forward requests read from stdin to the control socket.
+ */
+static bool actionBatch(int fd)
+{
+	if (fd == -1) {
+		std::cerr << "batch requires the control socket" << std::endl;
+		return false;
+	}
+	return Ctrl::batch(STDIN_FILENO, fd);
+}
+
+static bool actionQuery(int argc, char **argv, int fd)
+{
+	if (argc != 1) {
+		std::cerr << "must specify query, clients or stacking"
+			  << std::endl;
+		return false;
+	} else if (fd == -1) {
+		std::cerr << "query requires the control socket" << std::endl;
+		return false;
+	}
+	std::string reply;
+	if (! ctrlRequest(fd, std::string("?") + argv[0] + "\n", reply)) {
+		return false;
+	}
+	std::cout << reply << std::endl;
+	return Ctrl::isReplyOk(reply);
+}
+
+static bool actionRun(int argc, char** argv, Window client, int fd)
 {
 	if (client == None) {
 		client = X11::getRoot();
@@ -497,8 +514,18 @@ static bool actionRun(int argc, char** argv, Window client)
 		std::cerr << "empty command string" << std::endl;
 		usage(nullptr, 1);
 	}
+
+	// output is the same with and without the control socket.
+	bool res;
 	std::cout << "_PEKWM_CMD " << client << " " << cmd;
-	bool res = sendCommand(cmd, client, sendClientMessage, nullptr);
+	if (fd == -1) {
+		res = Ctrl::sendCommand(cmd, client, sendClientMessage,
+					nullptr);
+	} else {
+		std::string reply;
+		res = ctrlRequest(fd, Ctrl::mkRequest(cmd, client), reply)
+			&& Ctrl::isReplyOk(reply);
+	}
 	printRes(res);
 	return res;
 }
@@ -708,6 +735,17 @@ int main(int argc, char* argv[])
 		return 1;
 	}
 
+	// connect to the control socket before limiting access, run falls
+	// back to _PEKWM_CMD if the socket is unavailable.
+	int ctrl_fd = -1;
+	if (action == PEKWM_CTRL_ACTION_RUN
+	    || action == PEKWM_CTRL_ACTION_BATCH
+	    || action == PEKWM_CTRL_ACTION_QUERY) {
+		std::string path =
+			CtrlSocket::path(DisplayString(X11::getDpy()));
+		ctrl_fd = CtrlSocket::connect(path);
+	}
+
 	// X11 connection has been setup, limit access further
 	pledge_x("stdio", "");
 
@@ -719,7 +757,14 @@ int main(int argc, char* argv[])
 	bool res;
 	switch (action) {
 	case PEKWM_CTRL_ACTION_RUN:
-		res = actionRun(argc - optind, argv + optind, client);
+		res = actionRun(argc - optind, argv + optind, client,
+				ctrl_fd);
+		break;
+	case PEKWM_CTRL_ACTION_BATCH:
+		res = actionBatch(ctrl_fd);
+		break;
+	case PEKWM_CTRL_ACTION_QUERY:
+		res = actionQuery(argc - optind, argv + optind, ctrl_fd);
 		break;
 	case PEKWM_CTRL_ACTION_FOCUS:
 		std::cout << "_NET_ACTIVE_WINDOW " << client;
@@ -767,11 +812,12 @@ int main(int argc, char* argv[])
 		break;
 	}
 
+	if (ctrl_fd != -1) {
+		close(ctrl_fd);
+	}
 	X11::destruct();
 	Charset::destruct();
 	delete _observer_mapping;
 
 	return res ? 0 : 1;
 }
-
-#endif // ! UNITTEST
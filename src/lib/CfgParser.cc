@@ -20,6 +20,8 @@
 
 const std::string CfgParser::_root_source_name = std::string("");
 const char *CP_PARSE_BLANKS = " \t\n";
+/** Characters handled by parseSource, anything else is added to buf. */
+static const char *CP_PARSE_SPECIAL = "\n;{}=#/";
 
 bool
 TimeFiles::requireReload(const std::string &file)
@@ -585,6 +587,7 @@ CfgParser::parseSource(CfgParserSource *source, CfgParserState &ps)
 		}
 		default:
 			ps.buf += c;
+			_source->get_until(CP_PARSE_SPECIAL, ps.buf);
 			break;
 		}
 	}
@@ -649,13 +652,16 @@ CfgParser::parseValue(std::string &value)
 	}
 
 	// Parse until next ", and escape characters after \.
-	while ((c = _source->get_char()) != EOF && c != '"') {
+	while ((c = _source->get_until("\"\\", value)) != EOF) {
+		_source->get_char();
+		if (c == '"') {
+			break;
+		}
+
 		// Escape character after \, if newline drop it.
-		if (c == '\\') {
-			c = _source->get_char();
-			if (c == '\n' || c == EOF) {
-				continue;
-			}
+		c = _source->get_char();
+		if (c == '\n' || c == EOF) {
+			continue;
 		}
 		value += c;
 	}
@@ -11,11 +11,15 @@
 #include "Util.hh"
 
 #include <iostream>
+#include <cerrno>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 
 extern "C" {
+#include <fcntl.h>
 #include <stdio.h>
+#include <sys/stat.h>
 #include <unistd.h>
 }
 
@@ -25,7 +29,10 @@ CfgParserSource::CfgParserSource(const std::string &source)
 	: _name(source),
 	  _type(SOURCE_VIRTUAL),
 	  _line(0),
-	  _is_dynamic(false)
+	  _is_dynamic(false),
+	  _begin(nullptr),
+	  _pos(nullptr),
+	  _end(nullptr)
 {
 }
 
@@ -34,32 +41,92 @@ CfgParserSource::~CfgParserSource (void)
 }
 
 /**
- * Open file based configuration source.
+ * Append characters to buf until one of the characters in delims is
+ * found, the delimiter is not consumed. Reads spans of the buffer at a
+ * time instead of one character at a time.
+ *
+ * @return Delimiter found or EOF.
+ */
+int
+CfgParserSource::get_until(const char *delims, std::string &buf)
+{
+	while (_pos != _end || fill()) {
+		const char *start = _pos;
+		for (; _pos != _end
+			     && (*_pos == '\0' || ! strchr(delims, *_pos));
+		     ++_pos) {
+			if (*_pos == '\n') {
+				++_line;
+			}
+		}
+		buf.append(start, _pos - start);
+		if (_pos != _end) {
+			return static_cast<unsigned char>(*_pos);
+		}
+	}
+	return EOF;
+}
+
+void
+CfgParserSource::setBuffer(const char *begin, const char *pos,
+			   const char *end)
+{
+	_begin = begin;
+	_pos = pos;
+	_end = end;
+}
+
+/**
+ * Open file based configuration source, reading the file content into
+ * memory.
  */
 bool
 CfgParserSourceFile::open(void)
 {
-	if (_file) {
+	if (_is_open) {
 		throw std::string("TRYING TO OPEN ALREADY OPEN SOURCE");
 	}
 
-	_file = fopen(_name.c_str(), "r");
-	if (! _file) {
+	int fd = ::open(_name.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd == -1) {
 		throw std::string("failed to open file " + _name);
 	}
 
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0) {
+		_data.reserve(st.st_size);
+	}
+
+	char buf[4096];
+	ssize_t ret;
+	while ((ret = read(fd, buf, sizeof(buf))) != 0) {
+		if (ret == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			::close(fd);
+			_data.clear();
+			throw std::string("failed to read file " + _name);
+		}
+		_data.append(buf, ret);
+	}
+	::close(fd);
+
+	_is_open = true;
+	setBuffer(_data.data(), _data.data(), _data.data() + _data.size());
 	return true;
 }
 
 void
 CfgParserSourceFile::close(void)
 {
-	if (! _file) {
+	if (! _is_open) {
 		throw std::string("trying to close already closed source");
 	}
 
-	fclose(_file);
-	_file = 0;
+	_is_open = false;
+	setBuffer(nullptr, nullptr, nullptr);
+	std::string().swap(_data);
 }
 
 
@@ -68,7 +135,7 @@ CfgParserSourceString::CfgParserSourceString(const std::string &source,
 	: CfgParserSource(source),
 	  _data(data)
 {
-	_pos = _data.begin();
+	open();
 }
 
 CfgParserSourceString::~CfgParserSourceString(void)
@@ -78,31 +145,15 @@ CfgParserSourceString::~CfgParserSourceString(void)
 bool
 CfgParserSourceString::open(void)
 {
-	_pos = _data.begin();
+	setBuffer(_data.data(), _data.data(), _data.data() + _data.size());
 	return true;
 }
 
 void
 CfgParserSourceString::close(void)
 {
-	_pos = _data.end();
-}
-
-int
-CfgParserSourceString::get_char(void)
-{
-	if (_pos == _data.end()) {
-		return EOF;
-	}
-	return CfgParserSource::do_get_char(*_pos++);
-}
-
-void
-CfgParserSourceString::unget_char(int c)
-{
-	if (_pos != _data.begin()) {
-		CfgParserSource::unget_char(*_pos--);
-	}
+	const char *end = _data.data() + _data.size();
+	setBuffer(_data.data(), end, end);
 }
 
 /**
@@ -137,7 +188,36 @@ CfgParserSourceCommand::open(void)
 	if (! _process) {
 		return false;
 	}
-	_file = ::fdopen(_process->getReadFd(), "r");
+	_buf.clear();
+	setBuffer(nullptr, nullptr, nullptr);
+	return true;
+}
+
+/**
+ * Read next chunk of output from the command, keeping the last read
+ * character in front of the new data.
+ */
+bool
+CfgParserSourceCommand::fill(void)
+{
+	if (_process == nullptr) {
+		return false;
+	}
+
+	char last = _buf.empty() ? '\0' : _buf.back();
+	_buf.resize(4097);
+	_buf[0] = last;
+
+	ssize_t ret;
+	do {
+		ret = read(_process->getReadFd(), &_buf[1], _buf.size() - 1);
+	} while (ret == -1 && errno == EINTR);
+	if (ret <= 0) {
+		return false;
+	}
+
+	_buf.resize(ret + 1);
+	setBuffer(&_buf[0], &_buf[1], &_buf[0] + _buf.size());
 	return true;
 }
 
@@ -152,7 +232,7 @@ CfgParserSourceCommand::close(void)
 	}
 	_sigaction_counter--;
 
-	fclose(_file);
+	setBuffer(nullptr, nullptr, nullptr);
 	pid_t pid = _process->getPid();
 	int exitcode;
 	bool status = _process->wait(exitcode);
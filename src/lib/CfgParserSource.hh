@@ -9,6 +9,7 @@
 #define _PEKWM_CFGPARSERSOURCE_HH_
 
 #include <string>
+#include <vector>
 #include <cstdio>
 
 extern "C" {
@@ -43,13 +44,32 @@ public:
 	virtual bool open(void) = 0;
 	virtual void close(void) = 0;
 
-	virtual int get_char(void) = 0;
-	virtual void unget_char(int c) {
-		if (c == '\n') {
-			--_line;
+	/**
+	 * Get next character from the source buffer, increments line
+	 * count if \n.
+	 */
+	int get_char(void) {
+		if (_pos == _end && ! fill()) {
+			return EOF;
+		}
+		return do_get_char(static_cast<unsigned char>(*_pos++));
+	}
+
+	/**
+	 * Return the last read character to the source, decrements line
+	 * count if \n.
+	 */
+	void unget_char(int c) {
+		if (c != EOF && _pos != _begin) {
+			--_pos;
+			if (c == '\n') {
+				--_line;
+			}
 		}
 	}
 
+	int get_until(const char *delims, std::string &buf);
+
 	/**< Return name of source. */
 	const std::string &getName(void) const { return _name; }
 	/**< Return type of source. */
@@ -67,49 +87,38 @@ protected:
 		return c;
 	}
 
+	/**
+	 * Refill buffer when all data has been read, returns false at
+	 * end of source.
+	 */
+	virtual bool fill(void) { return false; }
+	void setBuffer(const char *begin, const char *pos, const char *end);
+
 protected:
 	std::string _name; /**< Name of source. */
 	CfgParserSource::Type _type; /**< Type of source. */
 	uint _line; /**< Line number. */
 	bool _is_dynamic; /**< Set to true if source has dynamic content. */
-};
-
-class CfgParserSourceFp : public CfgParserSource
-{
-public:
-	CfgParserSourceFp(const std::string& source)
-		: CfgParserSource(source),
-		  _file(nullptr)
-	{
-	}
 
-	/**
-	 * Gets a character from _file, increments line count if \n.
-	 */
-	virtual int get_char(void) {
-		return do_get_char(fgetc(_file));
-	}
-
-	/**
-	 * Returns a character to _op_file, decrements line count if \n.
-	 */
-	virtual void unget_char(int c) {
-		return CfgParserSource::unget_char(ungetc(c, _file));
-	}
-
-protected:
-	std::FILE *_file; /**< FILE object source is reading from. */
+private:
+	/** Start of buffer, characters before _pos can be returned. */
+	const char *_begin;
+	/** Next character to read. */
+	const char *_pos;
+	/** End of buffered data. */
+	const char *_end;
 };
 
 /**
  * File based configuration source, reads data from a plain file on
- * disk.
+ * disk. The file is read into memory at open.
  */
-class CfgParserSourceFile : public CfgParserSourceFp
+class CfgParserSourceFile : public CfgParserSource
 {
 public:
 	CfgParserSourceFile(const std::string &source)
-		: CfgParserSourceFp(source)
+		: CfgParserSource(source),
+		  _is_open(false)
 	{
 		_type = SOURCE_FILE;
 	}
@@ -117,6 +126,10 @@ public:
 
 	virtual bool open(void);
 	virtual void close(void);
+
+private:
+	bool _is_open;
+	std::string _data;
 };
 
 /**
@@ -132,24 +145,20 @@ public:
 	virtual bool open(void);
 	virtual void close(void);
 
-	virtual int get_char(void);
-	virtual void unget_char(int c);
-
 private:
 	std::string _data;
-	std::string::iterator _pos;
 };
 
 /**
  * Command based configuration source, executes a commands and parses
  * the output.
  */
-class CfgParserSourceCommand : public CfgParserSourceFp
+class CfgParserSourceCommand : public CfgParserSource
 {
 public:
 	CfgParserSourceCommand(const std::string &source, Os *os, 
 			       const std::string &command_path)
-		: CfgParserSourceFp(source),
+		: CfgParserSource(source),
 		  _os(os),
 		  _command_path(command_path),
 		  _process(nullptr)
@@ -162,10 +171,16 @@ public:
 	virtual bool open(void);
 	virtual void close(void);
 
+protected:
+	virtual bool fill(void);
+
 private:
 	Os *_os;
 	std::string _command_path; /**< PATH override for command. */
 	ChildProcess *_process; /**< Process generating output. */
+	/** Output read from process, first byte is the last character of
+	 * the previous read to support unget_char. */
+	std::vector<char> _buf;
 	struct sigaction _sigaction; /**< sigaction for restore. */
 	static unsigned int _sigaction_counter; /**< Counts open. */
 };
@@ -12,6 +12,7 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <cwctype>
 #include <iomanip>
 #include <stdexcept>
 
@@ -80,17 +81,17 @@ utf8_to_char(const char *utf8, T &wc)
 	if (len == 1) {
 		wc = utf8[0];
 	} else if (len == 2) {
-		wc = ((utf8[0] & 0x3f) << 6)
+		wc = ((utf8[0] & 0x1f) << 6)
 			| (utf8[1] & 0x3f);
 	} else if (len == 3) {
-		wc = ((utf8[0] & 0x3f) << 12)
+		wc = ((utf8[0] & 0x0f) << 12)
 			| ((utf8[1] & 0x3f) << 6)
 			| (utf8[2] & 0x3f);
 	} else if (len == 4) {
-		wc = ((utf8[0] & 0x3f) << 18)
+		wc = ((utf8[0] & 0x07) << 18)
 			| ((utf8[1] & 0x3f) << 12)
-			| ((utf8[1] & 0x3f) << 6)
-			| (utf8[2] & 0x3f);
+			| ((utf8[2] & 0x3f) << 6)
+			| (utf8[3] & 0x3f);
 	} else {
 		// 5 and 6 character sequences are invalid.
 		len = 0;
@@ -368,4 +369,28 @@ namespace Charset
 		utf8[utf8_len] = '\0';
 		str += utf8;
 	}
+
+	/**
+	 * Convert UTF-8 string to lowercase, non ASCII characters are
+	 * converted using the current locale.
+	 */
+	std::string toLower(const StringView &str)
+	{
+		std::string lower;
+		lower.reserve(str.size());
+
+		Utf8Iterator it(str);
+		for (; ! it.end(); ++it) {
+			const char *chr = *it;
+			uint32_t wc;
+			if (static_cast<uint8_t>(chr[0]) < 0x80) {
+				lower += pekwm::ascii_tolower(chr[0]);
+			} else if (utf8_to_char<uint32_t>(chr, wc) == 0) {
+				lower += chr;
+			} else {
+				toUtf8(towlower(wc), lower);
+			}
+		}
+		return lower;
+	}
 }
@@ -92,6 +92,7 @@ namespace Charset
 	std::string fromSystem(const StringView &str);
 
 	void toUtf8(uint32_t chr, std::string &str);
+	std::string toLower(const StringView &str);
 }
 
 #endif // _PEKWM_CHARSET_HH_
@@ -0,0 +1,178 @@
+//
+// Ctrl.cc for pekwm
+// Copyright (C) 2021-2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#include "Ctrl.hh"
+#include "Json.hh"
+#include "Mem.hh"
+#include "Os.hh"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+extern "C" {
+#include <sys/socket.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+}
+
+namespace Ctrl {
+
+	/**
+	 * Send cmd to win as one or more _PEKWM_CMD client messages, the
+	 * last byte of each message tells if more messages follow.
+	 */
+	bool
+	sendCommand(const std::string& cmd, Window win,
+		    send_message_fun send_message, void *opaque)
+	{
+		XClientMessageEvent ev;
+		char buf[sizeof(ev.data.b)] = {0};
+		int chunk_size = sizeof(buf) - 1;
+
+		const char *src = cmd.c_str();
+		int left = cmd.size();
+		buf[chunk_size] =
+			static_cast<int>(cmd.size()) <= chunk_size ? 0 : 1;
+		memcpy(buf, src, std::min(left, chunk_size));
+		bool res = send_message(win, PEKWM_CMD, 8, buf, sizeof(buf),
+					opaque);
+		src += chunk_size;
+		left -= chunk_size;
+		while (res && left > 0) {
+			memset(buf, 0, sizeof(buf));
+			buf[chunk_size] = left <= chunk_size ? 3 : 2;
+			memcpy(buf, src, std::min(left, chunk_size));
+			src += chunk_size;
+			left -= chunk_size;
+			res = send_message(win, PEKWM_CMD, 8, buf, sizeof(buf),
+					   opaque);
+		}
+
+		return res;
+	}
+
+	/**
+	 * Format control socket request running cmd on client, root or
+	 * None runs the command without a client.
+	 */
+	std::string
+	mkRequest(const std::string &cmd, Window client)
+	{
+		std::ostringstream req;
+		if (client != None && client != X11::getRoot()) {
+			req << "@" << client << " ";
+		}
+		for (size_t i = 0; i < cmd.size(); i++) {
+			req << (cmd[i] == '\n' ? ' ' : cmd[i]);
+		}
+		req << "\n";
+		return req.str();
+	}
+
+	/**
+	 * Check if the status of a JSON reply line is ok.
+	 */
+	bool
+	isReplyOk(const std::string &reply)
+	{
+		JsonParser parser(reply);
+		Destruct<JsonValueObject> value(parser.parse());
+		if (*value == nullptr) {
+			return false;
+		}
+		JsonValueString *status = jsonGetString(*value, "status");
+		return status != nullptr && *(*status) == "ok";
+	}
+
+	bool
+	write(int fd, const std::string &data)
+	{
+		const char *buf = data.c_str();
+		size_t left = data.size();
+		while (left > 0) {
+			ssize_t len = ::write(fd, buf, left);
+			if (len == -1) {
+				if (errno == EINTR) {
+					continue;
+				}
+				return false;
+			}
+			buf += len;
+			left -= len;
+		}
+		return true;
+	}
+
+	/**
+	 * Read single reply line from the control socket.
+	 */
+	bool
+	readLine(int fd, std::string &line)
+	{
+		line = "";
+		char c;
+		ssize_t len;
+		while ((len = read(fd, &c, 1)) == 1 && c != '\n') {
+			line += c;
+		}
+		return len == 1;
+	}
+
+	/**
+	 * Forward requests read from in_fd to the control socket, one
+	 * request per line, and print the replies. Requests are
+	 * pipelined, in_fd is read while replies arrive.
+	 */
+	bool
+	batch(int in_fd, int fd)
+	{
+		bool res = true;
+		OsSelect *select = mkOsSelect();
+		select->add(in_fd, OsSelect::OS_SELECT_READ);
+		select->add(fd, OsSelect::OS_SELECT_READ);
+
+		bool eof = false;
+		std::string reply;
+		char buf[4096];
+		while (! eof && select->wait()) {
+			int sfd, mask;
+			while (select->next(sfd, mask)) {
+				ssize_t len = read(sfd, buf, sizeof(buf));
+				if (sfd == in_fd) {
+					if (len > 0) {
+						std::string req(buf, len);
+						write(fd, req);
+					} else {
+						select->remove(in_fd);
+						shutdown(fd, SHUT_WR);
+					}
+					continue;
+				}
+
+				if (len <= 0) {
+					eof = true;
+					break;
+				}
+				reply.append(buf, len);
+				std::string::size_type pos;
+				while ((pos = reply.find('\n'))
+				       != std::string::npos) {
+					std::string line = reply.substr(0, pos);
+					std::cout << line << std::endl;
+					res = res && isReplyOk(line);
+					reply.erase(0, pos + 1);
+				}
+			}
+		}
+		delete select;
+		return res;
+	}
+
+}
@@ -0,0 +1,35 @@
+//
+// Ctrl.hh for pekwm
+// Copyright (C) 2021-2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#ifndef _PEKWM_CTRL_HH_
+#define _PEKWM_CTRL_HH_
+
+#include "Compat.hh"
+#include "X11.hh"
+
+#include <string>
+
+/**
+ * Client side of the pekwm_ctrl protocol, commands are sent either as
+ * _PEKWM_CMD client messages or as request lines on the control socket.
+ */
+namespace Ctrl {
+	typedef bool(*send_message_fun)(Window, AtomName, int,
+					const void*, size_t, void *opaque);
+
+	bool sendCommand(const std::string& cmd, Window win,
+			 send_message_fun send_message, void *opaque);
+
+	std::string mkRequest(const std::string &cmd, Window client);
+	bool isReplyOk(const std::string &reply);
+	bool write(int fd, const std::string &data);
+	bool readLine(int fd, std::string &line);
+	bool batch(int in_fd, int fd);
+}
+
+#endif // _PEKWM_CTRL_HH_
@@ -0,0 +1,353 @@
+//
+// CtrlSocket.cc for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#include "CtrlSocket.hh"
+#include "Debug.hh"
+#include "Types.hh"
+
+#include <sstream>
+
+extern "C" {
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+}
+
+static bool
+_setFdFlags(int fd, bool nonblock)
+{
+	if (fcntl(fd, F_SETFD, FD_CLOEXEC) == -1) {
+		return false;
+	}
+	if (nonblock) {
+		int flags = fcntl(fd, F_GETFL);
+		if (flags == -1
+		    || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool
+_initAddr(const std::string &path, struct sockaddr_un &addr)
+{
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+		P_DBG("invalid control socket path " << path);
+		return false;
+	}
+	memcpy(addr.sun_path, path.c_str(), path.size());
+	return true;
+}
+
+namespace CtrlSocket {
+
+	/**
+	 * Get path to the control socket for display, placed in
+	 * XDG_RUNTIME_DIR if set and /tmp otherwise. The screen part of
+	 * the display name is ignored as pekwm manages a single screen.
+	 */
+	std::string
+	path(const std::string &display)
+	{
+		std::string name(display);
+		std::string::size_type colon = name.rfind(':');
+		std::string::size_type dot = name.rfind('.');
+		if (colon != std::string::npos && dot != std::string::npos
+		    && dot > colon) {
+			name.erase(dot);
+		}
+		for (size_t i = 0; i < name.size(); i++) {
+			if (! isalnum(static_cast<uchar>(name[i]))
+			    && name[i] != '.' && name[i] != '-') {
+				name[i] = '_';
+			}
+		}
+
+		std::ostringstream path;
+		const char *runtime_dir = getenv("XDG_RUNTIME_DIR");
+		if (runtime_dir && runtime_dir[0] == '/') {
+			path << runtime_dir << "/pekwm-ctrl-" << name
+			     << ".sock";
+		} else {
+			path << "/tmp/pekwm-" << getuid() << "-ctrl-" << name
+			     << ".sock";
+		}
+		return path.str();
+	}
+
+	/**
+	 * Connect to the control socket at path, the socket must be owned
+	 * by the current user.
+	 *
+	 * @return connected fd, -1 on error.
+	 */
+	int
+	connect(const std::string &path)
+	{
+		struct sockaddr_un addr;
+		if (! _initAddr(path, addr)) {
+			return -1;
+		}
+
+		struct stat sb;
+		if (lstat(path.c_str(), &sb) == -1
+		    || ! S_ISSOCK(sb.st_mode) || sb.st_uid != getuid()) {
+			return -1;
+		}
+
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd == -1) {
+			return -1;
+		}
+		struct sockaddr *sa = reinterpret_cast<struct sockaddr*>(&addr);
+		if (! _setFdFlags(fd, false)
+		    || ::connect(fd, sa, sizeof(addr)) == -1) {
+			::close(fd);
+			return -1;
+		}
+		return fd;
+	}
+
+}
+
+CtrlServer::CtrlServer(OsSelect *select, Handler *handler)
+	: _select(select),
+	  _handler(handler),
+	  _fd(-1)
+{
+}
+
+CtrlServer::~CtrlServer()
+{
+	close();
+}
+
+/**
+ * Create and listen on socket at path, a stale socket left by a previous
+ * instance is replaced.
+ */
+bool
+CtrlServer::open(const std::string &path)
+{
+	close();
+
+	struct sockaddr_un addr;
+	if (! _initAddr(path, addr)) {
+		return false;
+	}
+
+	struct stat sb;
+	if (lstat(path.c_str(), &sb) == 0) {
+		if (! S_ISSOCK(sb.st_mode)) {
+			P_ERR("not replacing " << path << ", not a socket");
+			return false;
+		}
+		unlink(path.c_str());
+	}
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd == -1) {
+		P_ERR("failed to create control socket: " << strerror(errno));
+		return false;
+	}
+
+	// restrict access to the current user from the start.
+	mode_t old_umask = umask(0077);
+	int ret = bind(fd, reinterpret_cast<struct sockaddr*>(&addr),
+		       sizeof(addr));
+	umask(old_umask);
+	if (ret == -1 || listen(fd, 8) == -1 || ! _setFdFlags(fd, true)) {
+		P_ERR("failed to listen on " << path << ": "
+		      << strerror(errno));
+		::close(fd);
+		return false;
+	}
+
+	_fd = fd;
+	_path = path;
+	_select->add(_fd, OsSelect::OS_SELECT_READ);
+	P_DBG("listening on control socket " << _path);
+	return true;
+}
+
+/**
+ * Close listen socket and all clients, removing the socket file.
+ */
+void
+CtrlServer::close()
+{
+	while (! _clients.empty()) {
+		closeClient(_clients.begin()->first);
+	}
+	if (_fd != -1) {
+		_select->remove(_fd);
+		::close(_fd);
+		unlink(_path.c_str());
+		_fd = -1;
+		_path = "";
+	}
+}
+
+/**
+ * Handle I/O on fd.
+ *
+ * @return true if fd belongs to the server, false if not.
+ */
+bool
+CtrlServer::handle(int fd, int mask)
+{
+	if (fd == -1) {
+		return false;
+	} else if (fd == _fd) {
+		accept();
+		return true;
+	}
+
+	std::map<int, Conn>::iterator it(_clients.find(fd));
+	if (it == _clients.end()) {
+		return false;
+	}
+
+	Conn &conn = it->second;
+	if ((mask & OsSelect::OS_SELECT_READ) && ! read(fd, conn)) {
+		closeClient(fd);
+	} else if (! write(fd, conn)) {
+		closeClient(fd);
+	} else if (conn.eof && conn.out.empty()) {
+		closeClient(fd);
+	} else if (conn.out.empty()) {
+		_select->add(fd, OsSelect::OS_SELECT_READ);
+	} else {
+		_select->add(fd, conn.eof
+			     ? OsSelect::OS_SELECT_WRITE
+			     : OsSelect::OS_SELECT_ALL);
+	}
+	return true;
+}
+
+void
+CtrlServer::accept()
+{
+	int fd;
+	while ((fd = ::accept(_fd, nullptr, nullptr)) != -1) {
+		if (! _setFdFlags(fd, true)) {
+			::close(fd);
+			continue;
+		}
+		_clients[fd] = Conn();
+		_select->add(fd, OsSelect::OS_SELECT_READ);
+		P_TRACE("control socket client " << fd << " connected");
+	}
+}
+
+/**
+ * Read all available data from fd, handling complete lines.
+ *
+ * @return false on error or if the client must be dropped.
+ */
+bool
+CtrlServer::read(int fd, Conn &conn)
+{
+	char buf[4096];
+	ssize_t len;
+	while ((len = ::read(fd, buf, sizeof(buf))) > 0) {
+		conn.in.append(buf, len);
+	}
+	if (len == 0) {
+		conn.eof = true;
+	} else if (errno != EAGAIN && errno != EWOULDBLOCK
+		   && errno != EINTR) {
+		return false;
+	}
+
+	std::string line;
+	std::string::size_type start = 0, end;
+	while ((end = conn.in.find('\n', start)) != std::string::npos) {
+		line = conn.in.substr(start, end - start);
+		start = end + 1;
+		handleLine(line, conn);
+		if (conn.out.size() > OUT_MAX_SIZE
+		    && (! write(fd, conn) || conn.out.size() > OUT_MAX_SIZE)) {
+			P_DBG("control socket client " << fd << " not reading "
+			      "replies, dropping client");
+			return false;
+		}
+	}
+	conn.in.erase(0, start);
+
+	if (conn.eof && ! conn.in.empty()) {
+		// last request without a trailing newline
+		handleLine(conn.in, conn);
+		conn.in = "";
+	} else if (conn.in.size() > LINE_MAX_SIZE) {
+		P_DBG("control socket line too long, dropping client " << fd);
+		return false;
+	}
+	return true;
+}
+
+void
+CtrlServer::handleLine(std::string &line, Conn &conn)
+{
+	if (! line.empty() && line[line.size() - 1] == '\r') {
+		line.erase(line.size() - 1);
+	}
+	if (line.empty()) {
+		return;
+	}
+
+	std::string reply;
+	_handler->handleCtrlLine(line, reply);
+	conn.out += reply;
+	conn.out += '\n';
+}
+
+/**
+ * Write as much of the pending output as possible without blocking.
+ *
+ * @return false on error.
+ */
+bool
+CtrlServer::write(int fd, Conn &conn)
+{
+	while (! conn.out.empty()) {
+		// avoid SIGPIPE if the client went away before reading
+		// the reply.
+#ifdef MSG_NOSIGNAL
+		ssize_t len = send(fd, conn.out.c_str(), conn.out.size(),
+				   MSG_NOSIGNAL);
+#else // ! MSG_NOSIGNAL
+		ssize_t len = ::write(fd, conn.out.c_str(), conn.out.size());
+#endif // MSG_NOSIGNAL
+		if (len == -1) {
+			return errno == EAGAIN || errno == EWOULDBLOCK
+				|| errno == EINTR;
+		}
+		conn.out.erase(0, len);
+	}
+	return true;
+}
+
+void
+CtrlServer::closeClient(int fd)
+{
+	P_TRACE("control socket client " << fd << " closed");
+	_select->remove(fd);
+	::close(fd);
+	_clients.erase(fd);
+}
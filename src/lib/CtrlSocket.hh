@@ -0,0 +1,92 @@
+//
+// CtrlSocket.hh for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#ifndef _PEKWM_CTRL_SOCKET_HH_
+#define _PEKWM_CTRL_SOCKET_HH_
+
+#include "Compat.hh"
+#include "Os.hh"
+
+#include <map>
+#include <string>
+
+/**
+ * Local control socket, AF_UNIX stream socket used by pekwm_ctrl to send
+ * newline separated requests to the window manager and get one line
+ * replies back.
+ */
+namespace CtrlSocket {
+	std::string path(const std::string &display);
+	int connect(const std::string &path);
+}
+
+/**
+ * Server side of the control socket, listen and client fds are
+ * registered in the provided OsSelect and all I/O is non-blocking.
+ * Requests are handed to the Handler one line at a time, replies are
+ * written in the same order as the requests.
+ */
+class CtrlServer {
+public:
+	class Handler {
+	public:
+		virtual ~Handler() { }
+		virtual void handleCtrlLine(const std::string &line,
+					    std::string &reply) = 0;
+	};
+
+	/** Maximum length of a request line, longer lines drop the client. */
+	static const size_t LINE_MAX_SIZE = 1024 * 1024;
+	/**
+	 * Maximum size of pending replies, clients not reading their
+	 * replies are dropped.
+	 */
+	static const size_t OUT_MAX_SIZE = 4 * 1024 * 1024;
+
+	CtrlServer(OsSelect *select, Handler *handler);
+	~CtrlServer();
+
+	bool open(const std::string &path);
+	void close();
+
+	bool isOpen() const { return _fd != -1; }
+	size_t numClients() const { return _clients.size(); }
+
+	bool handle(int fd, int mask);
+
+private:
+	CtrlServer(const CtrlServer&);
+	CtrlServer &operator=(const CtrlServer&);
+
+	class Conn {
+	public:
+		Conn()
+			: eof(false)
+		{
+		}
+
+		std::string in;
+		std::string out;
+		/** Set when the client has closed its write end. */
+		bool eof;
+	};
+
+	void accept();
+	bool read(int fd, Conn &conn);
+	void handleLine(std::string &line, Conn &conn);
+	bool write(int fd, Conn &conn);
+	void closeClient(int fd);
+
+	OsSelect *_select;
+	Handler *_handler;
+	int _fd;
+	std::string _path;
+	std::map<int, Conn> _clients;
+};
+
+#endif // _PEKWM_CTRL_SOCKET_HH_
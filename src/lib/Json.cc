@@ -14,6 +14,8 @@
 
 extern "C" {
 #include <locale.h>
+#include <math.h>
+#include <stdio.h>
 }
 
 JsonValueNull _null_value = JsonValueNull();
@@ -32,6 +34,63 @@ _is_space(char chr)
 	}
 }
 
+/**
+ * Write string quoted and escaped, control characters are written as
+ * \uXXXX as they are not allowed in strings.
+ */
+static void
+_writeString(std::ostream &os, const std::string &str)
+{
+	os << "\"";
+	std::string::const_iterator it(str.begin());
+	for (; it != str.end(); ++it) {
+		switch (*it) {
+		case '"':
+			os << "\\\"";
+			break;
+		case '\\':
+			os << "\\\\";
+			break;
+		case '\n':
+			os << "\\n";
+			break;
+		case '\r':
+			os << "\\r";
+			break;
+		case '\t':
+			os << "\\t";
+			break;
+		default:
+			if (static_cast<uchar>(*it) < 0x20) {
+				char buf[8];
+				snprintf(buf, sizeof(buf), "\\u%04x",
+					 static_cast<uchar>(*it));
+				os << buf;
+			} else {
+				os << *it;
+			}
+			break;
+		}
+	}
+	os << "\"";
+}
+
+/**
+ * Write number, integral values are written without exponent to keep
+ * ids such as X11 window ids intact.
+ */
+static void
+_writeNumber(std::ostream &os, double val)
+{
+	if (val == floor(val) && fabs(val) < 1e15) {
+		char buf[32];
+		snprintf(buf, sizeof(buf), "%.0f", val);
+		os << buf;
+	} else {
+		os << val;
+	}
+}
+
 std::ostream&
 operator<<(std::ostream &os, const JsonValueObject& val)
 {
@@ -41,7 +100,8 @@ operator<<(std::ostream &os, const JsonValueObject& val)
 		if (it != val.begin()) {
 			os << ", ";
 		}
-		os << "\"" << it->first << "\": " << *it->second;
+		_writeString(os, it->first);
+		os << ": " << *it->second;
 	}
 	os << "}";
 	return os;
@@ -73,11 +133,10 @@ operator<<(std::ostream &os, const JsonValue& val)
 		os << static_cast<const JsonValueArray&>(val);
 		break;
 	case JSON_TYPE_STRING:
-		os << "\"" << *static_cast<const JsonValueString&>(val)
-		   << "\"";
+		_writeString(os, *static_cast<const JsonValueString&>(val));
 		break;
 	case JSON_TYPE_NUMBER:
-		os << *static_cast<const JsonValueNumber&>(val);
+		_writeNumber(os, *static_cast<const JsonValueNumber&>(val));
 		break;
 	case JSON_TYPE_BOOLEAN:
 		if (*static_cast<const JsonValueBoolean&>(val)) {
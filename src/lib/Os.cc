@@ -9,6 +9,8 @@
 #include "Debug.hh"
 #include "Os.hh"
 
+#include <algorithm>
+
 extern "C" {
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -17,6 +19,13 @@ extern "C" {
 #include <signal.h>
 #include <string.h>
 #include <unistd.h>
+
+#ifdef PEKWM_HAVE_EPOLL
+#include <sys/epoll.h>
+#endif // PEKWM_HAVE_EPOLL
+#ifdef PEKWM_HAVE_POSIX_SPAWN
+#include <spawn.h>
+#endif // PEKWM_HAVE_POSIX_SPAWN
 }
 
 OsEnv::OsEnv()
@@ -128,6 +137,7 @@ OsEnv::setEnvVar(std::map<std::string, std::string> &env, const char *envp)
 	}
 }
 
+#if ! defined(PEKWM_HAVE_POSIX_SPAWN) || ! defined(POSIX_SPAWN_SETSID)
 static void
 _exec_args(const std::vector<std::string> &args, OsEnv *env)
 {
@@ -147,6 +157,42 @@ _exec_args(const std::vector<std::string> &args, OsEnv *env)
 	// error occured, exit with failure
 	exit(1);
 }
+#endif // ! PEKWM_HAVE_POSIX_SPAWN || ! POSIX_SPAWN_SETSID
+
+#ifdef PEKWM_HAVE_POSIX_SPAWN
+/**
+ * Spawn process running args without forking the calling process, fork
+ * latency grows with the resident size of the calling process.
+ *
+ * @return pid of the new process, -1 on failure.
+ */
+static pid_t
+_spawn_args(const std::vector<std::string> &args, OsEnv *env,
+	    posix_spawn_file_actions_t *actions, short flags)
+{
+	std::vector<char*> argv;
+	std::vector<std::string>::const_iterator it = args.begin();
+	for (; it != args.end(); ++it) {
+		argv.push_back(const_cast<char*>(it->c_str()));
+	}
+	argv.push_back(nullptr);
+
+	posix_spawnattr_t attr;
+	posix_spawnattr_init(&attr);
+	posix_spawnattr_setflags(&attr, flags);
+
+	pid_t pid;
+	char **envp = env ? env->getCEnv() : environ;
+	int err = posix_spawnp(&pid, argv[0], actions, &attr, &argv[0],
+			       envp);
+	posix_spawnattr_destroy(&attr);
+	if (err) {
+		P_ERR("failed to spawn " << argv[0] << ": " << strerror(err));
+		return -1;
+	}
+	return pid;
+}
+#endif // PEKWM_HAVE_POSIX_SPAWN
 
 /**
  * Default implementation of the OsSelect interface.
@@ -164,6 +210,14 @@ public:
 
 	virtual void add(int fd, int select_mask)
 	{
+		fd_vector::iterator it(_fds.begin());
+		for (; it != _fds.end(); ++it) {
+			if (it->first == fd) {
+				it->second = select_mask;
+				return;
+			}
+		}
+
 		_fds.push_back(std::pair<int,int>(fd, select_mask));
 		if (fd > _max_fd) {
 			_max_fd = fd;
@@ -172,10 +226,14 @@ public:
 
 	virtual void remove(int fd)
 	{
-		fd_vector::iterator it(_fds.begin());
-		for (; it != _fds.end(); ++it) {
-			if (it->first == fd) {
-				_fds.erase(it);
+		for (size_t i = 0; i < _fds.size(); i++) {
+			if (_fds[i].first == fd) {
+				_fds.erase(_fds.begin() + i);
+				// keep next() from skipping an entry when
+				// removing while iterating.
+				if (i < _pos) {
+					_pos--;
+				}
 				break;
 			}
 		}
@@ -254,6 +312,193 @@ private:
 	fd_set _wfds;
 };
 
+#ifdef PEKWM_HAVE_EPOLL
+
+/**
+ * epoll based implementation of the OsSelect interface, avoids rebuilding
+ * the fd sets on every wait and the FD_SETSIZE limit of select.
+ */
+class OsSelectEpoll : public OsSelect {
+public:
+	OsSelectEpoll()
+		: _epfd(epoll_create1(EPOLL_CLOEXEC)),
+		  _num_events(0),
+		  _pos(0)
+	{
+		if (_epfd == -1) {
+			P_ERR("epoll_create1 failed: " << strerror(errno));
+		}
+	}
+
+	virtual ~OsSelectEpoll()
+	{
+		if (_epfd != -1) {
+			::close(_epfd);
+		}
+	}
+
+	bool isOk() const { return _epfd != -1; }
+
+	virtual void add(int fd, int select_mask)
+	{
+		struct epoll_event ev;
+		memset(&ev, 0, sizeof(ev));
+		if (select_mask & OS_SELECT_READ) {
+			ev.events |= EPOLLIN;
+		}
+		if (select_mask & OS_SELECT_WRITE) {
+			ev.events |= EPOLLOUT;
+		}
+		ev.data.fd = fd;
+
+		int ret = epoll_ctl(_epfd, EPOLL_CTL_ADD, fd, &ev);
+		if (ret == -1 && errno == EEXIST) {
+			ret = epoll_ctl(_epfd, EPOLL_CTL_MOD, fd, &ev);
+		}
+		if (ret == -1 && errno == EPERM) {
+			// regular files and /dev/null can not be polled,
+			// they are always ready as reported by select.
+			setAlways(fd, ev.events);
+		} else if (ret == -1) {
+			P_ERR("failed to add fd " << fd << " to epoll: "
+			      << strerror(errno));
+		} else if (std::find(_fds.begin(), _fds.end(), fd)
+			   == _fds.end()) {
+			_fds.push_back(fd);
+			_events.resize(_fds.size());
+		}
+	}
+
+	virtual void remove(int fd)
+	{
+		std::vector<int>::iterator it =
+			std::find(_fds.begin(), _fds.end(), fd);
+		if (it != _fds.end()) {
+			_fds.erase(it);
+
+			// the fd might already be closed, removing it from
+			// the epoll set, ignore errors.
+			struct epoll_event ev;
+			epoll_ctl(_epfd, EPOLL_CTL_DEL, fd, &ev);
+		} else if (! setAlways(fd, 0)) {
+			return;
+		}
+
+		// forget about pending events for the removed fd
+		for (int i = 0; i < _num_events; i++) {
+			if (_events[i].data.fd == fd) {
+				_events[i].events = 0;
+			}
+		}
+	}
+
+	virtual bool isSet(int fd, enum Type type)
+	{
+		uint32_t mask = type == OS_SELECT_READ ? EPOLLIN : EPOLLOUT;
+		if (type == OS_SELECT_READ) {
+			// hangup and errors are reported as readable, as
+			// done by select, for read to get the EOF/error.
+			mask |= EPOLLHUP | EPOLLERR;
+		}
+		for (int i = 0; i < _num_events; i++) {
+			if (_events[i].data.fd == fd) {
+				return _events[i].events & mask;
+			}
+		}
+		return false;
+	}
+
+	virtual bool wait(struct timeval *tv)
+	{
+		_pos = 0;
+		_num_events = 0;
+		int max_events = std::max(_fds.size(), size_t(1));
+		_events.resize(max_events + _always.size());
+
+		int timeout = -1;
+		if (! _always.empty()) {
+			timeout = 0;
+		} else if (tv) {
+			// round up, waking up before the timeout expires
+			// causes a busy loop until it does.
+			timeout = tv->tv_sec * 1000
+				+ (tv->tv_usec + 999) / 1000;
+		}
+		int ret = epoll_wait(_epfd, &_events[0], max_events, timeout);
+		if (ret > 0) {
+			_num_events = ret;
+		}
+
+		event_vector::iterator it(_always.begin());
+		for (; it != _always.end(); ++it) {
+			_events[_num_events++] = *it;
+		}
+		return _num_events > 0;
+	}
+
+	virtual bool next(int &fd, int &mask)
+	{
+		while (_pos < _num_events) {
+			const struct epoll_event &ev = _events[_pos++];
+			fd = ev.data.fd;
+			mask = 0;
+			if (ev.events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+				mask |= OS_SELECT_READ;
+			}
+			if (ev.events & EPOLLOUT) {
+				mask |= OS_SELECT_WRITE;
+			}
+			if (mask) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+private:
+	typedef std::vector<struct epoll_event> event_vector;
+
+	/**
+	 * Set events for fd not supported by epoll, events 0 removes
+	 * the fd. Returns true if the fd was set before.
+	 */
+	bool setAlways(int fd, uint32_t events)
+	{
+		event_vector::iterator it(_always.begin());
+		for (; it != _always.end(); ++it) {
+			if (it->data.fd == fd) {
+				break;
+			}
+		}
+
+		bool found = it != _always.end();
+		if (events == 0) {
+			if (found) {
+				_always.erase(it);
+			}
+		} else if (found) {
+			it->events = events;
+		} else {
+			struct epoll_event ev;
+			memset(&ev, 0, sizeof(ev));
+			ev.events = events;
+			ev.data.fd = fd;
+			_always.push_back(ev);
+		}
+		return found;
+	}
+
+	int _epfd;
+	std::vector<int> _fds;
+	/** fds epoll rejects, such as regular files, always ready. */
+	event_vector _always;
+	event_vector _events;
+	int _num_events;
+	int _pos;
+};
+
+#endif // PEKWM_HAVE_EPOLL
+
 /**
  * Default implementation of the ChildProcess interface.
  */
@@ -272,9 +517,30 @@ public:
 			return;
 		}
 
+#ifdef PEKWM_HAVE_POSIX_SPAWN
+		posix_spawn_file_actions_t actions;
+		posix_spawn_file_actions_init(&actions);
+		if (flags & CHILD_IO_STDOUT) {
+			posix_spawn_file_actions_adddup2(&actions,
+							 getWriteFd(),
+							 STDOUT_FILENO);
+		} else {
+			posix_spawn_file_actions_addclose(&actions,
+							  getWriteFd());
+		}
+		if (flags & CHILD_IO_STDIN) {
+			posix_spawn_file_actions_adddup2(&actions,
+							 getReadFd(),
+							 STDIN_FILENO);
+		} else {
+			posix_spawn_file_actions_addclose(&actions,
+							  getReadFd());
+		}
+		_pid = _spawn_args(args, env, &actions, 0);
+		posix_spawn_file_actions_destroy(&actions);
+#else // ! PEKWM_HAVE_POSIX_SPAWN
 		_pid = fork();
 		if (_pid == -1) {
-			// throw error
 			P_ERR("fork failed: " << strerror(errno));
 		} else if (_pid == 0) {
 			// child process
@@ -290,7 +556,10 @@ public:
 			}
 
 			_exec_args(args, env);
-		} else {
+		}
+#endif // PEKWM_HAVE_POSIX_SPAWN
+
+		if (_pid != -1) {
 			P_TRACE("started child process " << _pid);
 			// inverse, no output means no input and vice versa
 			if (! (flags & CHILD_IO_STDOUT)) {
@@ -315,7 +584,8 @@ public:
 
 		int pid_status;
 		int status = waitpid(_pid, &pid_status, 0);
-		if (status == -1) {
+		// ECHILD, already reaped by a SIGCHLD handler
+		if (status == -1 && errno != ECHILD) {
 			P_ERR("failed to wait for pid " << _pid);
 		}
 		_pid = -1;
@@ -324,6 +594,17 @@ public:
 		return _pid == -1;
 	}
 
+	virtual void detach()
+	{
+		if (_pid != -1) {
+			int pid_status;
+			waitpid(_pid, &pid_status, WNOHANG);
+			_pid = -1;
+		}
+		closeFd(_pipe[0]);
+		closeFd(_pipe[1]);
+	}
+
 	virtual pid_t getPid() const { return _pid; }
 	virtual int getReadFd() const { return _pipe[0]; }
 	virtual int getWriteFd() const { return _pipe[1]; }
@@ -388,13 +669,20 @@ public:
 	}
 
 	/**
-	 * Fork and exec, return pid if successful, log on error.
+	 * Spawn, or fork and exec, in a new session, return pid if
+	 * successful, log on error.
 	 */
 	virtual pid_t processExec(const std::vector<std::string> &args,
 				  OsEnv *env)
 	{
 		assert(! args.empty());
 
+#if defined(PEKWM_HAVE_POSIX_SPAWN) && defined(POSIX_SPAWN_SETSID)
+		pid_t pid = _spawn_args(args, env, nullptr,
+					POSIX_SPAWN_SETSID);
+		P_TRACE_IF(pid != -1, "started child " << pid);
+		return pid;
+#else // ! PEKWM_HAVE_POSIX_SPAWN || ! POSIX_SPAWN_SETSID
 		pid_t pid = fork();
 		switch (pid) {
 		case 0:
@@ -406,6 +694,7 @@ public:
 			P_TRACE("started child " << pid);
 			return pid;
 		}
+#endif // PEKWM_HAVE_POSIX_SPAWN && POSIX_SPAWN_SETSID
 	}
 
 	/**
@@ -463,5 +752,12 @@ Os *mkOs()
  */
 OsSelect *mkOsSelect()
 {
+#ifdef PEKWM_HAVE_EPOLL
+	OsSelectEpoll *select = new OsSelectEpoll();
+	if (select->isOk()) {
+		return select;
+	}
+	delete select;
+#endif // PEKWM_HAVE_EPOLL
 	return new OsSelectImpl();
 }
@@ -96,6 +96,11 @@ public:
 	virtual ~ChildProcess() { }
 
 	virtual bool wait(int &exitcode) = 0;
+	/**
+	 * Close pipes and forget the process without waiting for it to
+	 * finish, it is reaped here if done, else by a SIGCHLD handler.
+	 */
+	virtual void detach() = 0;
 
 	virtual pid_t getPid() const = 0;
 	virtual int getReadFd() const = 0;
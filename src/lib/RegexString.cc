@@ -17,13 +17,17 @@
 
 extern "C" {
 #include <stdlib.h>
+#include <string.h>
 }
 
 const char RegexString::SEPARATOR = '/';
+/** Characters with special meaning in extended regular expressions. */
+static const char *REGEX_SPECIAL = ".[]()*+?{}|^$\\";
 
 RegexString::RegexString(void)
 	: _reg_ok(false),
 	  _reg_inverted(false),
+	  _match_type(MATCH_REGEX),
 	  _ref_max(1)
 {
 }
@@ -34,6 +38,7 @@ RegexString::RegexString(void)
 RegexString::RegexString(const std::string &str, bool full)
 	: _reg_ok(false),
 	  _reg_inverted(false),
+	  _match_type(MATCH_REGEX),
 	  _ref_max(1)
 {
 	parse_match(str, full);
@@ -108,7 +113,7 @@ RegexString::parse_match(const std::string &match, bool full)
 	}
 
 	int flags = REG_EXTENDED;
-	std::string expression;
+	std::string expression, expression_utf8(match);
 
 	// Full regular expression syntax, parse out flags etc
 	std::string::size_type pos;
@@ -116,6 +121,7 @@ RegexString::parse_match(const std::string &match, bool full)
 	    && (pos = match.find_last_of(SEPARATOR)) != std::string::npos) {
 		// Main expression
 		std::string expression_str = match.substr(1, pos - 1);
+		expression_utf8 = expression_str;
 
 		// Expression flags
 		for (std::string::size_type i = pos + 1;
@@ -146,6 +152,9 @@ RegexString::parse_match(const std::string &match, bool full)
 
 	_reg_ok = ! regcomp(&_regex, expression.c_str(), flags);
 	_pattern = match;
+	if (_reg_ok && ! (flags & REG_ICASE)) {
+		parse_literal(expression_utf8);
+	}
 
 	return _reg_ok;
 }
@@ -250,12 +259,87 @@ RegexString::operator==(const std::string &rhs) const
 		return false;
 	}
 
-	std::string mb_rhs = Charset::toSystem(rhs);
-	bool match = regexec(&_regex, mb_rhs.c_str(), 0, 0, 0) == 0;
+	bool match;
+	if (_match_type == MATCH_REGEX) {
+		std::string mb_rhs = Charset::toSystem(rhs);
+		match = regexec(&_regex, mb_rhs.c_str(), 0, 0, 0) == 0;
+	} else {
+		match = match_literal(rhs);
+	}
 
 	return _reg_inverted ? ! match : match;
 }
 
+/**
+ * Detect if expression is a plain string, optionally anchored at the
+ * beginning and/or end, enabling matching without regexec and conversion
+ * to the system charset. Only ASCII literals are considered.
+ */
+void
+RegexString::parse_literal(const std::string &expression)
+{
+	std::string::size_type begin = 0, end = expression.size();
+	bool anchor_begin = end > 0 && expression[0] == '^';
+	if (anchor_begin) {
+		begin++;
+	}
+
+	bool anchor_end = false;
+	if (end > begin && expression[end - 1] == '$') {
+		// $ is literal if preceded by an odd number of backslashes
+		std::string::size_type escapes = 0;
+		while (end - 1 - escapes > begin
+		       && expression[end - 2 - escapes] == '\\') {
+			escapes++;
+		}
+		if (escapes % 2 == 0) {
+			anchor_end = true;
+			end--;
+		}
+	}
+
+	std::string literal;
+	for (std::string::size_type i = begin; i < end; i++) {
+		char c = expression[i];
+		if (c == '\\' && i + 1 < end && expression[i + 1] != '\0'
+		    && strchr(REGEX_SPECIAL, expression[i + 1])) {
+			literal += expression[++i];
+		} else if (c == '\0' || (c & 0x80)
+			   || strchr(REGEX_SPECIAL, c)) {
+			return;
+		} else {
+			literal += c;
+		}
+	}
+
+	_literal = literal;
+	if (anchor_begin) {
+		_match_type = anchor_end ? MATCH_EXACT : MATCH_PREFIX;
+	} else {
+		_match_type = anchor_end ? MATCH_SUFFIX : MATCH_SUBSTRING;
+	}
+}
+
+bool
+RegexString::match_literal(const std::string &rhs) const
+{
+	switch (_match_type) {
+	case MATCH_EXACT:
+		return rhs == _literal;
+	case MATCH_PREFIX:
+		return rhs.compare(0, _literal.size(), _literal) == 0;
+	case MATCH_SUFFIX:
+		return rhs.size() >= _literal.size()
+			&& rhs.compare(rhs.size() - _literal.size(),
+				       _literal.size(), _literal) == 0;
+	case MATCH_SUBSTRING:
+		return rhs.find(_literal) != std::string::npos;
+	case MATCH_REGEX:
+	default:
+		return false;
+	}
+}
+
 //! @brief Free resources used by RegexString.
 void
 RegexString::free_regex(void)
@@ -266,4 +350,6 @@ RegexString::free_regex(void)
 		_pattern = "";
 	}
 	_reg_inverted = false;
+	_match_type = MATCH_REGEX;
+	_literal = "";
 }
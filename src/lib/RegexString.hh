@@ -26,6 +26,18 @@ extern "C" {
 class RegexString
 {
 public:
+	/**
+	 * Type of match, patterns without special characters are matched
+	 * without using regexec.
+	 */
+	enum MatchType {
+		MATCH_REGEX,
+		MATCH_EXACT, /**< ^literal$ */
+		MATCH_PREFIX, /**< ^literal */
+		MATCH_SUFFIX, /**< literal$ */
+		MATCH_SUBSTRING /**< literal */
+	};
+
 	//! @brief Part of parsed replace data.
 	class Part
 	{
@@ -56,6 +68,10 @@ public:
 	//! @brief Returns parse_match data status.
 	bool is_match_ok(void) { return _reg_ok; }
 	const std::string& getPattern(void) const { return _pattern; }
+	bool isInverted(void) const { return _reg_inverted; }
+	MatchType getMatchType(void) const { return _match_type; }
+	/** Literal string matched, only valid if match type is not regex. */
+	const std::string& getLiteral(void) const { return _literal; }
 
 	bool ed_s(std::string &str);
 
@@ -69,6 +85,8 @@ private:
 	RegexString(const RegexString &);
 	RegexString &operator=(const RegexString &);
 	void free_regex(void);
+	void parse_literal(const std::string &expression);
+	bool match_literal(const std::string &rhs) const;
 
 private:
 	regex_t _regex; //!< Compiled regular expression holder.
@@ -76,6 +94,8 @@ private:
 	std::string _pattern; /**< String regex was compiled from. */
 	/** If true, a non-matching regexp is considered a match. */
 	bool _reg_inverted;
+	MatchType _match_type; /**< How operator== matches. */
+	std::string _literal; /**< Literal part of the pattern. */
 
 	int _ref_max; //!< Highest reference used.
 	/** Vector of RegexString::Part holding data generated by
@@ -95,6 +95,26 @@ pekwm::str_hash(const char* str)
 	return hash;
 }
 
+uint
+pekwm::ascii_ncase_hash(const std::string& str)
+{
+	return ascii_ncase_hash(str.c_str());
+}
+
+/**
+ * Compute hash for C string ignoring case, ASCII only.
+ */
+uint
+pekwm::ascii_ncase_hash(const char* str)
+{
+	uint hash = 0;
+	const uchar *p = reinterpret_cast<const uchar*>(str);
+	for (; *p != '\0'; p++) {
+	    hash = 31 * hash + ascii_tolower(*p);
+	}
+	return hash;
+}
+
 std::string
 pekwm::to_string(double val, int precision)
 {
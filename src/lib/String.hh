@@ -118,6 +118,8 @@ namespace pekwm {
 
 	uint str_hash(const std::string& str);
 	uint str_hash(const char* str);
+	uint ascii_ncase_hash(const std::string& str);
+	uint ascii_ncase_hash(const char* str);
 
 	std::string to_string(double val, int precision);
 
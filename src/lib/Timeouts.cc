@@ -8,6 +8,8 @@
 
 #include "Timeouts.hh"
 
+#include <algorithm>
+
 /**
  * Populate timespec with the current time + timeout_ms milliseconds added to
  * the timeout.
@@ -43,18 +45,29 @@ timespec_diff_to_timeval(struct timespec &ts, struct timespec &ts_end,
 }
 
 /**
- * Add TimeoutAction to list of future actions.
+ * Add TimeoutAction to list of future actions, replacing any action with
+ * the same key.
  */
 void
 Timeouts::add(const TimeoutAction &action)
 {
-	ta_vector::iterator it(_actions.begin());
-	for (; it != _actions.end(); ++it) {
-		if (*it < action) {
-			break;
+	std::map<int, size_t>::iterator it = _key_pos.find(action.getKey());
+	if (it != _key_pos.end()) {
+		// update in place and restore heap order
+		size_t pos = it->second;
+		bool earlier = action < _actions[pos];
+		_actions[pos] = action;
+		if (earlier) {
+			siftUp(pos);
+		} else {
+			siftDown(pos);
 		}
+		return;
 	}
-	_actions.insert(it, action);
+
+	_actions.push_back(action);
+	_key_pos[action.getKey()] = _actions.size() - 1;
+	siftUp(_actions.size() - 1);
 }
 
 /**
@@ -70,22 +83,31 @@ Timeouts::replaceTime(int key, time_t end_time)
 }
 
 /**
- * Add TimeoutAction, replacing first occurance of any action with the same
- * id as the given action.
+ * Add TimeoutAction, replacing any action with the same key as the given
+ * action.
  */
 void
 Timeouts::replace(const TimeoutAction &action)
 {
-	ta_vector::iterator it(_actions.begin());
-	for (; it != _actions.end(); ++it) {
-		if (it->getKey() == action.getKey()) {
-			_actions.erase(it);
-			break;
-		}
-	}
 	add(action);
 }
 
+/**
+ * Remove action with key.
+ *
+ * @return true if an action was removed.
+ */
+bool
+Timeouts::remove(int key)
+{
+	std::map<int, size_t>::iterator it = _key_pos.find(key);
+	if (it == _key_pos.end()) {
+		return false;
+	}
+	removeAt(it->second);
+	return true;
+}
+
 /**
  * Fill in timeval/action to run next. Returns true if action was set, else
  * false.
@@ -102,15 +124,76 @@ Timeouts::getNextTimeout(struct timeval **tv, TimeoutAction &action)
 	clock_gettime(CLOCK_REALTIME, &ts);
 
 	struct timespec ts_end = _actions.front().getTimeEnd();
-	if (ts.tv_sec > ts_end.tv_sec
-	    || (ts.tv_sec == ts_end.tv_sec
-		&& ts.tv_nsec > ts_end.tv_nsec)) {
+	TimeoutAction now(-1, ts);
+	if (! (now < _actions.front())) {
+		_stats.fired++;
 		action = _actions.front();
-		_actions.erase(_actions.begin());
+		removeAt(0);
 		return true;
 	}
 
+	_stats.waits++;
 	timespec_diff_to_timeval(ts, ts_end, _tv);
 	*tv = &_tv;
 	return false;
 }
+
+void
+Timeouts::removeAt(size_t pos)
+{
+	_key_pos.erase(_actions[pos].getKey());
+	size_t last = _actions.size() - 1;
+	if (pos != last) {
+		_actions[pos] = _actions[last];
+		_key_pos[_actions[pos].getKey()] = pos;
+	}
+	_actions.pop_back();
+
+	if (pos < _actions.size()) {
+		siftUp(pos);
+		siftDown(pos);
+	}
+}
+
+void
+Timeouts::siftUp(size_t pos)
+{
+	while (pos > 0) {
+		size_t parent = (pos - 1) / 2;
+		if (! (_actions[pos] < _actions[parent])) {
+			break;
+		}
+		swap(pos, parent);
+		pos = parent;
+	}
+}
+
+void
+Timeouts::siftDown(size_t pos)
+{
+	size_t size = _actions.size();
+	for (;;) {
+		size_t first = pos;
+		size_t left = pos * 2 + 1;
+		size_t right = left + 1;
+		if (left < size && _actions[left] < _actions[first]) {
+			first = left;
+		}
+		if (right < size && _actions[right] < _actions[first]) {
+			first = right;
+		}
+		if (first == pos) {
+			break;
+		}
+		swap(pos, first);
+		pos = first;
+	}
+}
+
+void
+Timeouts::swap(size_t pos1, size_t pos2)
+{
+	std::swap(_actions[pos1], _actions[pos2]);
+	_key_pos[_actions[pos1].getKey()] = pos1;
+	_key_pos[_actions[pos2].getKey()] = pos2;
+}
@@ -3,6 +3,7 @@
 
 #include "Compat.hh"
 
+#include <map>
 #include <vector>
 
 extern "C" {
@@ -42,7 +43,7 @@ public:
 
 	virtual ~TimeoutAction() { }
 
-	bool operator<(const TimeoutAction &rhs)
+	bool operator<(const TimeoutAction &rhs) const
 	{
 		if (_ts.tv_sec == rhs.getTimeEnd().tv_sec) {
 			return _ts.tv_nsec < rhs.getTimeEnd().tv_nsec;
@@ -64,20 +65,51 @@ private:
 /**
  * Timeout manager, tracks TimeoutAction instances in order of timeout and
  * provides timeval for select timeouts.
+ *
+ * Actions are kept in a binary heap indexed on the action key, keys are
+ * unique and adding an action with a key already present replaces it.
  */
 class Timeouts {
 public:
-	typedef std::vector<TimeoutAction> ta_vector;
+	/**
+	 * Counters for tuning the timeouts.
+	 */
+	class Stats {
+	public:
+		Stats()
+			: waits(0),
+			  fired(0)
+		{
+		}
+
+		/** Number of times a wait for the next timeout was returned. */
+		uint waits;
+		/** Number of actions fired. */
+		uint fired;
+	};
 
 	void add(const TimeoutAction &action);
 	void replaceTime(int key, time_t end_time);
 	void replace(const TimeoutAction &action);
+	bool remove(int key);
 
 	bool getNextTimeout(struct timeval **tv, TimeoutAction &action);
 
+	size_t size() const { return _actions.size(); }
+	const Stats &getStats() const { return _stats; }
+
 private:
+	void removeAt(size_t pos);
+	void siftUp(size_t pos);
+	void siftDown(size_t pos);
+	void swap(size_t pos1, size_t pos2);
+
 	struct timeval _tv;
-	ta_vector _actions;
+	/** Binary heap with the first action to end at the top. */
+	std::vector<TimeoutAction> _actions;
+	/** Position in _actions for action key. */
+	std::map<int, size_t> _key_pos;
+	Stats _stats;
 };
 
 #endif // _PEKWM_TIMEOUTS_HH_
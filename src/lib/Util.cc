@@ -34,6 +34,7 @@ extern "C" {
 #include "CfgParser.hh"
 #include "Charset.hh"
 #include "Debug.hh"
+#include "Os.hh"
 #include "Util.hh"
 
 namespace StringUtil
@@ -173,7 +174,7 @@ namespace Util {
 	}
 
 	/**
-	 * Fork and execute command with PEKWM_SH and execlp
+	 * Execute command with PEKWM_SH in a new session.
 	 */
 	void
 	forkExec(const std::string& command)
@@ -184,21 +185,13 @@ namespace Util {
 		}
 		P_TRACE(command);
 
-		pid_t pid = fork();
-		switch (pid) {
-		case 0:
-			setsid();
-			execlp(PEKWM_SH, PEKWM_SH, "-c", command.c_str(),
-			       (void*) 0);
-			P_ERR("execlp failed: " << strerror(errno));
-			exit(1);
-		case -1:
-			P_ERR("fork failed: " << strerror(errno));
-			break;
-		default:
-			P_TRACE("started child " << pid);
-			break;
-		}
+		std::vector<std::string> args;
+		args.push_back(PEKWM_SH);
+		args.push_back("-c");
+		args.push_back(command);
+		Os *os = mkOs();
+		os->processExec(args);
+		delete os;
 	}
 
 	/**
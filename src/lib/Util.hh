@@ -212,6 +212,80 @@ namespace Util {
 		return map[i].value;
 	}
 
+	/**
+	 * Case insensitive hash index for StringTo tables, used instead of
+	 * StringToGet for larger tables. The index is built on first
+	 * lookup, the table must not change after that.
+	 */
+	template<typename T>
+	class StringToIndex {
+	public:
+		StringToIndex(const Util::StringTo<T> *map)
+			: _map(map),
+			  _end(0),
+			  _mask(0)
+		{
+		}
+
+		/**
+		 * Lookup key, returns the value of the terminating entry
+		 * if not found same as StringToGet.
+		 */
+		const T& get(const std::string &key)
+		{
+			if (_slots.empty()) {
+				build();
+			}
+
+			uint i = pekwm::ascii_ncase_hash(key) & _mask;
+			for (; _slots[i] != -1; i = (i + 1) & _mask) {
+				const StringTo<T> &entry = _map[_slots[i]];
+				if (pekwm::ascii_ncase_equal(entry.name, key)) {
+					return entry.value;
+				}
+			}
+			return _map[_end].value;
+		}
+
+	private:
+		void build()
+		{
+			for (_end = 0; _map[_end].name != nullptr; _end++)
+				;
+
+			// keep load below 50% for short probe sequences
+			size_t size = 1;
+			while (size < _end * 2) {
+				size <<= 1;
+			}
+			_mask = size - 1;
+			_slots.assign(size, -1);
+
+			for (size_t i = 0; i < _end; i++) {
+				uint h = pekwm::ascii_ncase_hash(_map[i].name);
+				for (h &= _mask; _slots[h] != -1;
+				     h = (h + 1) & _mask) {
+					if (pekwm::ascii_ncase_equal(
+						_map[_slots[h]].name,
+						_map[i].name)) {
+						// first entry wins, as with
+						// StringToGet
+						break;
+					}
+				}
+				if (_slots[h] == -1) {
+					_slots[h] = i;
+				}
+			}
+		}
+
+		const Util::StringTo<T> *_map;
+		/** Index of the terminating nullptr entry. */
+		size_t _end;
+		uint _mask;
+		std::vector<int> _slots;
+	};
+
 }
 
 #endif // _PEKWM_UTIL_HH_
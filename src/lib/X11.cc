@@ -12,7 +12,9 @@
 
 #include <string>
 #include <iostream>
+#include <algorithm>
 #include <cassert>
+#include <cctype>
 #ifdef PEKWM_HAVE_LIMITS
 #include <limits>
 #endif // PEKWM_HAVE_LIMITS
@@ -307,23 +309,30 @@ X11_GC::~X11_GC()
  */
 class X11::ColorEntry {
 public:
-	ColorEntry(const std::string &name) : _name(name), _ref(0) { }
+	ColorEntry(const std::string &name)
+		: _name(name),
+		  _ref(0),
+		  _allocated(false)
+	{
+	}
 	~ColorEntry(void) { }
 
+	inline const std::string &getName(void) const { return _name; }
 	inline XColor *getColor(void) { return &_xc; }
 
 	inline uint getRef(void) const { return _ref; }
 	inline void incRef(void) { _ref++; }
 	inline void decRef(void) { if (_ref > 0) { _ref--; } }
 
-	inline bool operator==(const std::string &name) {
-		return pekwm::ascii_ncase_equal(_name, name);
-	}
+	/** true if the pixel was allocated on the server. */
+	inline bool isAllocated(void) const { return _allocated; }
+	inline void setAllocated(bool allocated) { _allocated = allocated; }
 
 private:
 	std::string _name;
 	XColor _xc;
 	uint _ref;
+	bool _allocated;
 };
 
 /**
@@ -376,6 +385,12 @@ X11::init(Display *dpy, bool synchronous, bool honour_randr)
 	_depth = DefaultDepth(_dpy, _screen);
 	_max_request_size = XMaxRequestSize(_dpy) << 2;
 	_visual = DefaultVisual(_dpy, _screen);
+	if (_visual->c_class == TrueColor) {
+		setTrueColorMasks(_visual->red_mask, _visual->green_mask,
+				  _visual->blue_mask);
+	} else {
+		setTrueColorMasks(0, 0, 0);
+	}
 	_gc = DefaultGC(_dpy, _screen);
 	XGCValues gv;
 	gv.function = GXcopy;
@@ -472,14 +487,21 @@ X11::destruct(void) {
 	}
 
 	if (_colors.size() > 0) {
-		ulong *pixels = new ulong[_colors.size()];
-		for (uint i=0; i < _colors.size(); ++i) {
-			pixels[i] = _colors[i]->getColor()->pixel;
-			delete _colors[i];
+		std::vector<ulong> pixels;
+		std::map<std::string, ColorEntry*>::iterator it =
+			_colors.begin();
+		for (; it != _colors.end(); ++it) {
+			if (it->second->isAllocated()) {
+				pixels.push_back(it->second->getColor()->pixel);
+			}
+			delete it->second;
+		}
+		if (! pixels.empty()) {
+			XFreeColors(_dpy, X11::getColormap(),
+				    &pixels[0], pixels.size(), 0);
 		}
-		XFreeColors(_dpy, X11::getColormap(),
-			    pixels, _colors.size(), 0);
-		delete [] pixels;
+		_colors.clear();
+		_colors_by_xc.clear();
 	}
 
 	if (_modifier_map) {
@@ -530,6 +552,13 @@ X11::setSelectionOwner(Atom atom, Window owner, Time timestamp)
 	}
 }
 
+/**
+ * Get color, colors are reference counted and must be returned with
+ * returnColor.
+ *
+ * Hex colors are resolved locally on TrueColor visuals, other colors
+ * are allocated on the server once and then shared between all users.
+ */
 XColor *
 X11::getColor(const std::string &color)
 {
@@ -537,30 +566,33 @@ X11::getColor(const std::string &color)
 		return &_xc_default;
 	}
 
-	std::vector<ColorEntry*>::iterator it = _colors.begin();
-	for (; it != _colors.end(); ++it) {
-		if (*(*it) == color) {
-			(*it)->incRef();
-			return (*it)->getColor();
-		}
+	std::string name = normalizeColorName(color);
+	std::map<std::string, ColorEntry*>::iterator it = _colors.find(name);
+	if (it != _colors.end()) {
+		it->second->incRef();
+		return it->second->getColor();
 	}
 
-	// create new entry
-	ColorEntry *entry = new ColorEntry(color);
-
-	// X alloc
-	XColor dummy;
-	if (XAllocNamedColor(_dpy, X11::getColormap(),
-			     color.c_str(), entry->getColor(), &dummy) == 0) {
-		P_ERR("failed to alloc color: " << color);
-		delete entry;
-		entry = 0;
+	ColorEntry *entry = new ColorEntry(name);
+	XColor *xc = entry->getColor();
+	if (_true_color && parseHexColor(name, *xc)
+	    && getTrueColorPixel(*xc)) {
+		entry->setAllocated(false);
 	} else {
-		_colors.push_back(entry);
-		entry->incRef();
+		XColor dummy;
+		if (XAllocNamedColor(_dpy, X11::getColormap(),
+				     color.c_str(), xc, &dummy) == 0) {
+			P_ERR("failed to alloc color: " << color);
+			delete entry;
+			return &_xc_default;
+		}
+		entry->setAllocated(true);
 	}
 
-	return entry ? entry->getColor() : &_xc_default;
+	entry->incRef();
+	_colors[name] = entry;
+	_colors_by_xc[xc] = entry;
+	return xc;
 }
 
 void
@@ -571,25 +603,145 @@ X11::returnColor(XColor*& xc)
 		return;
 	}
 
-	std::vector<ColorEntry*>::iterator it = _colors.begin();
-	for (; it != _colors.end(); ++it) {
-		if ((*it)->getColor() == xc) {
-			(*it)->decRef();
-			if (((*it)->getRef() == 0)) {
-				ulong pixels[1] = { (*it)->getColor()->pixel };
+	std::map<const XColor*, ColorEntry*>::iterator it =
+		_colors_by_xc.find(xc);
+	if (it != _colors_by_xc.end()) {
+		ColorEntry *entry = it->second;
+		entry->decRef();
+		if (entry->getRef() == 0) {
+			if (entry->isAllocated()) {
+				ulong pixels[1] = { xc->pixel };
 				XFreeColors(X11::getDpy(), X11::getColormap(),
 					    pixels, 1, 0);
-
-				delete *it;
-				_colors.erase(it);
 			}
-			break;
+
+			_colors_by_xc.erase(it);
+			_colors.erase(entry->getName());
+			delete entry;
 		}
 	}
 
 	xc = nullptr;
 }
 
+/**
+ * Normalize color name for use as cache key, X color names are case
+ * insensitive and ignore white space.
+ */
+std::string
+X11::normalizeColorName(const std::string &color)
+{
+	std::string name;
+	name.reserve(color.size());
+	std::string::const_iterator it = color.begin();
+	for (; it != color.end(); ++it) {
+		unsigned char c = static_cast<unsigned char>(*it);
+		if (! isspace(c)) {
+			name += static_cast<char>(tolower(c));
+		}
+	}
+	return name;
+}
+
+/**
+ * Parse #rgb, #rrggbb, #rrrgggbbb and #rrrrggggbbbb colors the same way
+ * as XParseColor without a round-trip to the server.
+ */
+bool
+X11::parseHexColor(const std::string &color, XColor &xc)
+{
+	if (color.size() < 4 || color[0] != '#') {
+		return false;
+	}
+
+	size_t len = color.size() - 1;
+	if (len % 3 || len > 12) {
+		return false;
+	}
+
+	size_t n = len / 3;
+	ushort *comps[3] = { &xc.red, &xc.green, &xc.blue };
+	for (int i = 0; i < 3; i++) {
+		uint val = 0;
+		for (size_t j = 0; j < n; j++) {
+			char c = color[1 + i * n + j];
+			if (c >= '0' && c <= '9') {
+				val = (val << 4) | (c - '0');
+			} else if (c >= 'a' && c <= 'f') {
+				val = (val << 4) | (c - 'a' + 10);
+			} else if (c >= 'A' && c <= 'F') {
+				val = (val << 4) | (c - 'A' + 10);
+			} else {
+				return false;
+			}
+		}
+		*comps[i] = val << (16 - n * 4);
+	}
+	xc.flags = DoRed | DoGreen | DoBlue;
+	return true;
+}
+
+/**
+ * Set masks used to compute pixel values for TrueColor visuals, all 0
+ * disables local pixel computation.
+ */
+void
+X11::setTrueColorMasks(ulong red_mask, ulong green_mask, ulong blue_mask)
+{
+	ulong masks[3] = { red_mask, green_mask, blue_mask };
+	_true_color = true;
+	for (int i = 0; i < 3; i++) {
+		uint shift = 0, bits = 0;
+		ulong mask = masks[i];
+		if (mask) {
+			while (! (mask & 1)) {
+				mask >>= 1;
+				shift++;
+			}
+			while (mask & 1) {
+				mask >>= 1;
+				bits++;
+			}
+		}
+		// non-contiguous masks or more precision than XColor has
+		if (bits == 0 || bits > 16 || mask) {
+			_true_color = false;
+		}
+		_true_color_shift[i] = shift;
+		_true_color_bits[i] = bits;
+	}
+}
+
+/**
+ * Compute pixel value for the red, green and blue values of xc, the
+ * components are updated to the values the visual can represent.
+ */
+bool
+X11::getTrueColorPixel(XColor &xc)
+{
+	if (! _true_color) {
+		return false;
+	}
+
+	ushort *comps[3] = { &xc.red, &xc.green, &xc.blue };
+	xc.pixel = 0;
+	for (int i = 0; i < 3; i++) {
+		uint bits = _true_color_bits[i];
+		ulong val = *comps[i] >> (16 - bits);
+		xc.pixel |= val << _true_color_shift[i];
+
+		// replicate the bits into 16 bits, matching the hardware
+		// values XAllocColor returns, #ff gives 0xffff not 0xff00.
+		uint comp = 0;
+		for (int shift = 16 - bits; shift > -static_cast<int>(bits);
+		     shift -= bits) {
+			comp |= shift >= 0 ? val << shift : val >> -shift;
+		}
+		*comps[i] = comp;
+	}
+	return true;
+}
+
 ulong
 X11::getWhitePixel(void)
 {
@@ -1251,6 +1403,18 @@ X11::getAtomName(const std::string& name)
 	return MAX_NR_ATOMS;
 }
 
+/**
+ * Get name of atom, does not require a X11 connection.
+ */
+const char*
+X11::getAtomNameString(AtomName name)
+{
+	if (name < 0 || name >= MAX_NR_ATOMS) {
+		return nullptr;
+	}
+	return atomnames[name];
+}
+
 /**
  * Return Atom from provided string.
  */
@@ -1523,11 +1687,74 @@ X11::listProperties(Window win, std::vector<Atom>& atoms)
 	return c_atoms != nullptr;
 }
 
+/**
+ * Cache the list of properties set on win, making reads of properties
+ * not set on the window return without a round-trip to the server.
+ *
+ * Only valid while the server is grabbed as property changes are not
+ * tracked, clear with clearPropertyCache before ungrabbing.
+ */
+void
+X11::setPropertyCache(Window win)
+{
+	clearPropertyCache();
+	if (listProperties(win, _prop_cache_atoms)) {
+		std::sort(_prop_cache_atoms.begin(), _prop_cache_atoms.end());
+		_prop_cache_win = win;
+	}
+}
+
+void
+X11::clearPropertyCache(void)
+{
+	_prop_cache_win = None;
+	_prop_cache_atoms.clear();
+}
+
+/**
+ * Keep cached property list in sync with changes done by ourselves.
+ */
+void
+X11::updatePropertyCache(Window win, Atom atom, bool set)
+{
+	if (win == None || win != _prop_cache_win) {
+		return;
+	}
+
+	std::vector<Atom>::iterator it =
+		std::lower_bound(_prop_cache_atoms.begin(),
+				 _prop_cache_atoms.end(), atom);
+	bool found = it != _prop_cache_atoms.end() && *it == atom;
+	if (set && ! found) {
+		_prop_cache_atoms.insert(it, atom);
+	} else if (! set && found) {
+		_prop_cache_atoms.erase(it);
+	}
+}
+
+/**
+ * Check if property is set on window, always true unless the property
+ * list of the window is cached.
+ */
+bool
+X11::hasProperty(Window win, Atom atom)
+{
+	if (win != _prop_cache_win || win == None) {
+		return true;
+	}
+	return std::binary_search(_prop_cache_atoms.begin(),
+				  _prop_cache_atoms.end(), atom);
+}
+
 bool
 X11::getProperty(Window win, Atom atom, Atom type,
 		 ulong expected, uchar **data_ret, ulong *actual)
 {
-	if (! _dpy) {
+	if (! _dpy || ! hasProperty(win, atom)) {
+		if (actual) {
+			*actual = 0;
+		}
+		*data_ret = nullptr;
 		return false;
 	}
 
@@ -1571,6 +1798,10 @@ X11::getProperty(Window win, Atom atom, Atom type,
 bool
 X11::getTextProperty(Window win, Atom atom, std::string &value)
 {
+	if (! hasProperty(win, atom)) {
+		return false;
+	}
+
 	// Read text property, return if it fails.
 	XTextProperty text_property;
 	if (! XGetTextProperty(_dpy, win, &text_property, atom)
@@ -1604,6 +1835,11 @@ X11::getEwmhPropData(Window win, AtomName prop, Atom type, int &num)
 	ulong items_ret, after_ret;
 	uchar *prop_data = 0;
 
+	if (! hasProperty(win, _atoms[prop])) {
+		num = 0;
+		return nullptr;
+	}
+
 	XGetWindowProperty(_dpy, win, _atoms[prop], 0, 0x7fffffff,
 			   False, type, &type_ret, &format_ret, &items_ret,
 			   &after_ret, &prop_data);
@@ -1618,7 +1854,8 @@ bool
 X11::getClassHint(Window win, X11::ClassHint &class_hint)
 {
 	XClassHint xclass_hint;
-	if (_dpy && XGetClassHint(_dpy, win, &xclass_hint)) {
+	if (_dpy && hasProperty(win, XA_WM_CLASS)
+	    && XGetClassHint(_dpy, win, &xclass_hint)) {
 		class_hint = xclass_hint;
 		return true;
 	}
@@ -1629,6 +1866,7 @@ void
 X11::unsetProperty(Window win, AtomName aname)
 {
 	if (_dpy) {
+		updatePropertyCache(win, _atoms[aname], false);
 		XDeleteProperty(_dpy, win, _atoms[aname]);
 	}
 }
@@ -1710,6 +1948,7 @@ X11::changeProperty(Window win, Atom prop, Atom type, int format,
 	if (! _dpy) {
 		return false;
 	}
+	updatePropertyCache(win, prop, true);
 
 	size_t e_size = format / 8;
 	size_t req_size = e_size * num_e;
@@ -1741,6 +1980,7 @@ int
 X11::deleteProperty(Window win, Atom prop)
 {
 	if (_dpy) {
+		updatePropertyCache(win, prop, false);
 		return XDeleteProperty(_dpy, win, prop);
 	}
 	return BadImplementation;
@@ -1771,7 +2011,7 @@ X11::getWindowAttributes(Window win, XWindowAttributes &wa)
 bool
 X11::getWMHints(Window win, XWMHints &hints)
 {
-	if (_dpy) {
+	if (_dpy && hasProperty(win, XA_WM_HINTS)) {
 		XWMHints *hints_ptr = XGetWMHints(_dpy, win);
 		if (hints_ptr) {
 			hints = *hints_ptr;
@@ -2775,9 +3015,15 @@ Time X11::_last_event_time;
 Window X11::_last_click_id = None;
 Time X11::_last_click_time[BUTTON_NO];
 Pixmap X11::_pixmap_checker = None;
-std::vector<X11::ColorEntry*> X11::_colors;
+std::map<std::string, X11::ColorEntry*> X11::_colors;
+std::map<const XColor*, X11::ColorEntry*> X11::_colors_by_xc;
+bool X11::_true_color = false;
+uint X11::_true_color_shift[3];
+uint X11::_true_color_bits[3];
 XColor X11::_xc_default;
 Cursor X11::_cursor_map[CURSOR_NONE];
 XrmDatabase X11::_xrm_db = 0;
 std::map<std::string, std::string> X11::_ref_resources =
 	std::map<std::string, std::string>();
+Window X11::_prop_cache_win = None;
+std::vector<Atom> X11::_prop_cache_atoms;
@@ -545,6 +545,7 @@ public:
 
 	static Atom getAtom(AtomName name) { return _atoms[name]; }
 	static AtomName getAtomName(const std::string& str);
+	static const char *getAtomNameString(AtomName name);
 	static Atom getAtomId(const std::string& str);
 	static std::string getAtomIdString(Atom id);
 	static const char *getEventTypeString(int type);
@@ -576,6 +577,9 @@ public:
 			      const std::string &value);
 
 	static bool listProperties(Window win, std::vector<Atom>& atoms);
+	static void setPropertyCache(Window win);
+	static void clearPropertyCache(void);
+	static bool hasProperty(Window win, Atom atom);
 
 	static bool getProperty(Window win, Atom atom, Atom type,
 				ulong expected, uchar **data, ulong *actual);
@@ -710,10 +714,18 @@ protected:
 	static int parseGeometryVal(const char *c_str, const char *e_end,
 				    int &val_ret);
 
+	static std::string normalizeColorName(const std::string &color);
+	static bool parseHexColor(const std::string &color, XColor &xc);
+	static void setTrueColorMasks(ulong red_mask, ulong green_mask,
+				      ulong blue_mask);
+	static bool getTrueColorPixel(XColor &xc);
+
 private:
 	static uint calcDistance(int x1, int y1, int x2, int y2);
 	static uint calcDistance(int p1, int p2);
 
+	static void updatePropertyCache(Window win, Atom atom, bool set);
+
 	static void initHeads(void);
 	static void initHeadsRandr(void);
 	static void initHeadsXinerama(void);
@@ -764,11 +776,23 @@ private:
 
 	static Pixmap _pixmap_checker;
 	class ColorEntry;
-	static std::vector<ColorEntry*> _colors;
+	/** Allocated colors, keyed on normalized color name. */
+	static std::map<std::string, ColorEntry*> _colors;
+	/** Allocated colors, keyed on the XColor handed out by getColor. */
+	static std::map<const XColor*, ColorEntry*> _colors_by_xc;
+	/** Set if pixel values can be computed without the server. */
+	static bool _true_color;
+	static uint _true_color_shift[3];
+	static uint _true_color_bits[3];
 	static XColor _xc_default; // when allocating fails
 	static XrmDatabase _xrm_db;
 	static std::map<std::string, std::string> _ref_resources;
 
+	/** Window with cached property list, None if not active. */
+	static Window _prop_cache_win;
+	/** Sorted list of properties set on _prop_cache_win. */
+	static std::vector<Atom> _prop_cache_atoms;
+
 	static Atom _atoms[MAX_NR_ATOMS];
 };
 
@@ -13,6 +13,7 @@ BarWidget::BarWidget(const PanelWidgetData &data, const PWinObj* parent,
 		     const std::string& field_extra)
 	: PanelWidget(data, parent, cfg.getSizeReq(), cfg.getIf()),
 	  _field(field),
+	  _field_id(data.var_data.getFieldId(field)),
 	  _field_extra(field_extra),
 	  _checker_color(nullptr)
 {
@@ -20,13 +21,13 @@ BarWidget::BarWidget(const PanelWidgetData &data, const PWinObj* parent,
 	if (! _field_extra.empty()) {
 		_checker_color = X11::getColor("#999999");
 	}
-	pekwm::observerMapping()->addObserver(&_var_data, this, 100);
+	_var_data.addFieldObserver(_field_id, this);
 }
 
 BarWidget::~BarWidget()
 {
 	X11::returnColor(_checker_color);
-	pekwm::observerMapping()->removeObserver(&_var_data, this);
+	_var_data.removeFieldObserver(_field_id, this);
 }
 
 void
@@ -70,7 +70,7 @@ public:
 	{
 		FieldObservation *efo =
 			dynamic_cast<FieldObservation*>(observation);
-		if (efo != nullptr && efo->getField() == _field) {
+		if (efo != nullptr && efo->getFieldId() == _field_id) {
 			_dirty = true;
 		}
 		PanelWidget::notify(observable, observation);
@@ -90,6 +90,8 @@ private:
 	void addColor(float percent, XColor* color);
 
 	std::string _field;
+	/** id of _field in VarData. */
+	uint _field_id;
 	/** extra field value rendered on-top of field */
 	std::string _field_extra;
 	std::string _text;
@@ -9,6 +9,9 @@
 #include "Debug.hh"
 #include "ExternalCommandData.hh"
 
+#include <algorithm>
+#include <climits>
+
 extern "C" {
 #include <assert.h>
 #include <errno.h>
@@ -17,12 +20,17 @@ extern "C" {
 
 // ExternalCommandData::CommandProcess
 
+const uint ExternalCommandData::CommandProcess::PERSISTENT_BACKOFF_MAX_S;
+
 ExternalCommandData::CommandProcess::CommandProcess(const std::string& command,
 						    uint interval_s,
-						    const std::string& assign)
+						    const std::string& assign,
+						    bool persistent)
 	: _command(command),
 	  _interval_s(interval_s),
 	  _assign(assign),
+	  _persistent(persistent),
+	  _backoff_s(1),
 	  _pid(-1),
 	  _fd(-1)
 {
@@ -31,6 +39,7 @@ ExternalCommandData::CommandProcess::CommandProcess(const std::string& command,
 	int ret = clock_gettime(CLOCK_MONOTONIC, &_next_interval);
 	assert(ret == 0);
 	_next_interval.tv_sec--;
+	_started = _next_interval;
 }
 
 ExternalCommandData::CommandProcess::~CommandProcess()
@@ -78,6 +87,7 @@ ExternalCommandData::CommandProcess::start()
 	}
 
 	// parent, close write end just going to read
+	clock_gettime(CLOCK_MONOTONIC, &_started);
 	_fd = fd[0];
 	close(fd[1]);
 	Util::setNonBlock(_fd);
@@ -101,7 +111,22 @@ ExternalCommandData::CommandProcess::reset(void)
 	int ret = clock_gettime(CLOCK_MONOTONIC,
 				&_next_interval);
 	assert(ret == 0);
-	_next_interval.tv_sec += _interval_s;
+	if (! _persistent) {
+		_next_interval.tv_sec += _interval_s;
+		return;
+	}
+
+	// restart persistent commands with exponential backoff, a command
+	// that has been running for longer than the maximum backoff is
+	// restarted right away.
+	uint backoff_max = _interval_s == UINT_MAX
+		? PERSISTENT_BACKOFF_MAX_S : std::max(_interval_s, 1u);
+	if (_next_interval.tv_sec - _started.tv_sec
+	    >= static_cast<time_t>(backoff_max)) {
+		_backoff_s = 1;
+	}
+	_next_interval.tv_sec += _backoff_s;
+	_backoff_s = std::min(_backoff_s * 2, backoff_max);
 }
 
 
@@ -116,7 +141,7 @@ ExternalCommandData::ExternalCommandData(const PanelConfig& cfg,
 	for (; it != _cfg.commandsEnd(); ++it) {
 		_command_processes.push_back(
 			CommandProcess(it->getCommand(), it->getIntervalS(),
-				       it->getAssign()));
+				       it->getAssign(), it->isPersistent()));
 	}
 }
 
@@ -131,15 +156,45 @@ ExternalCommandData::refresh(fdFun addFd, void *opaque)
 	int ret = clock_gettime(CLOCK_MONOTONIC, &now);
 	assert(ret == 0);
 
+	// persistent commands do not affect the refresh interval, use
+	// SIGALRM to wake up when the next restart is due. alarm replaces
+	// any pending alarm so it is set once, for the earliest restart.
+	time_t restart_in = 0;
 	std::vector<CommandProcess>::iterator it =
 		_command_processes.begin();
 	for (; it != _command_processes.end(); ++it) {
-		if (it->getPid() == -1
-		    && it->checkInterval(&now)
-		    && it->start()) {
-			addFd(it->getFd(), opaque);
+		if (it->getPid() != -1) {
+			continue;
 		}
+		if (it->checkInterval(&now)) {
+			if (it->start()) {
+				addFd(it->getFd(), opaque);
+			}
+		} else if (it->isPersistent()) {
+			time_t in = getAlarmS(now, it->getNextInterval());
+			if (restart_in == 0 || in < restart_in) {
+				restart_in = in;
+			}
+		}
+	}
+	if (restart_in > 0) {
+		alarm(restart_in);
+	}
+}
+
+/**
+ * Get seconds until next, rounded up and at least 1 as alarm(0)
+ * cancels the alarm.
+ */
+time_t
+ExternalCommandData::getAlarmS(const struct timespec &now,
+			       const struct timespec &next)
+{
+	time_t in = next.tv_sec - now.tv_sec;
+	if (next.tv_nsec > now.tv_nsec) {
+		in++;
 	}
+	return in > 0 ? in : 1;
 }
 
 bool
@@ -24,6 +24,8 @@
  *
  * key data
  *
+ * Persistent commands are started once and restarted, with exponential
+ * backoff, if they exit.
  */
 class ExternalCommandData : public Observable
 {
@@ -31,14 +33,24 @@ public:
 	class CommandProcess
 	{
 	public:
+		/** Maximum restart backoff if no interval is set. */
+		static const uint PERSISTENT_BACKOFF_MAX_S = 60;
+
 		CommandProcess(const std::string& command, uint interval_s,
-			       const std::string& assign);
+			       const std::string& assign,
+			       bool persistent = false);
 		~CommandProcess();
 
 		int getFd() const { return _fd; }
 		pid_t getPid() const { return _pid; }
 		std::string& getBuf() { return _buf; }
 		const std::string& getAssign() const { return _assign; }
+		bool isPersistent() const { return _persistent; }
+		uint getBackoffS() const { return _backoff_s; }
+		const struct timespec& getNextInterval() const
+		{
+			return _next_interval;
+		}
 
 		bool start();
 
@@ -55,6 +67,12 @@ public:
 		std::string _assign;
 		struct timespec _next_interval;
 
+		bool _persistent;
+		/** Delay before the next restart of a persistent command. */
+		uint _backoff_s;
+		/** Time the command was last started. */
+		struct timespec _started;
+
 		pid_t _pid;
 		int _fd;
 		std::string _buf;
@@ -67,6 +85,9 @@ public:
 	bool input(int fd);
 	void done(pid_t pid, fdFun removeFd, void *opaque);
 
+	static time_t getAlarmS(const struct timespec &now,
+				const struct timespec &next);
+
 protected:
 	void append(std::string &buf, const char *data, size_t size,
 		    const std::string &assign);
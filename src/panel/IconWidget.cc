@@ -20,19 +20,25 @@ IconWidget::IconWidget(const PanelWidgetData &data,
 		       const std::string& field)
 	: PanelWidget(data, parent, cfg.getSizeReq(), cfg.getIf()),
 	  _field(field),
+	  _field_id(0),
 	  _scale(false),
 	  _icon(nullptr),
 	  _icon_scaled(nullptr)
 {
 	parseIcon(cfg.getCfgSection());
 
-	pekwm::observerMapping()->addObserver(&_var_data, this, 100);
+	if (! _field.empty()) {
+		_field_id = _var_data.getFieldId(_field);
+		_var_data.addFieldObserver(_field_id, this);
+	}
 	load();
 }
 
 IconWidget::~IconWidget()
 {
-	pekwm::observerMapping()->removeObserver(&_var_data, this);
+	if (! _field.empty()) {
+		_var_data.removeFieldObserver(_field_id, this);
+	}
 	if (_icon) {
 		pekwm::imageHandler()->returnImage(_icon);
 	}
@@ -43,7 +49,8 @@ void
 IconWidget::notify(Observable *observable, Observation *observation)
 {
 	FieldObservation *fo = dynamic_cast<FieldObservation*>(observation);
-	if (fo != nullptr && fo->getField() == _field) {
+	if (fo != nullptr && ! _field.empty()
+	    && fo->getFieldId() == _field_id) {
 		_dirty = true;
 		load();
 	}
@@ -118,7 +125,7 @@ IconWidget::load()
 {
 	std::string value;
 	if (! _field.empty()) {
-		value = Charset::toSystem(_var_data.get(_field));
+		value = Charset::toSystem(_var_data.get(_field_id));
 	}
 	if (_transform.is_match_ok()) {
 		_transform.ed_s(value);
@@ -41,6 +41,8 @@ private:
 
 private:
 	std::string _field;
+	/** id of _field in VarData, only valid if _field is set. */
+	uint _field_id;
 	/** icon name, no file extension. */
 	std::string _name;
 	/** file extension. */
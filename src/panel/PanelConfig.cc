@@ -96,10 +96,12 @@ WidgetConfig::getArg(uint arg) const
 // CommandConfig
 
 CommandConfig::CommandConfig(const std::string& command,
-			     uint interval_s, const std::string &assign)
+			     uint interval_s, const std::string &assign,
+			     bool persistent)
 	: _command(command),
 	  _interval_s(interval_s),
-	  _assign(assign)
+	  _assign(assign),
+	  _persistent(persistent)
 {
 }
 
@@ -111,7 +113,9 @@ CommandConfig::~CommandConfig(void)
 
 PanelConfig::PanelConfig()
 	: _placement(DEFAULT_PLACEMENT),
-	  _head(-1)
+	  _head(-1),
+	  _sysinfo_interval_s(1),
+	  _refresh_interval_s(UINT_MAX)
 {
 }
 
@@ -131,6 +135,7 @@ PanelConfig::load(const std::string &panel_file)
 	CfgParser::Entry *root = cfg.getEntryRoot();
 	loadPanel(root->findSection("PANEL"));
 	loadCommands(root->findSection("COMMANDS"));
+	loadSysInfo(root->findSection("SYSINFO"));
 	loadWidgets(root->findSection("WIDGETS"));
 	_refresh_interval_s = calculateRefreshIntervalS();
 	return true;
@@ -165,20 +170,40 @@ PanelConfig::loadCommands(CfgParser::Entry *section)
 	for (; it != section->end(); ++it) {
 		uint interval = UINT_MAX;
 		std::string assign;
+		bool persistent = false;
 
 		if ((*it)->getSection()) {
 			CfgParserKeys keys;
 			keys.add_numeric<uint>("INTERVAL", interval, UINT_MAX);
 			keys.add_string("ASSIGN", assign);
+			keys.add_bool("PERSISTENT", persistent, false);
 			(*it)->getSection()->parseKeyValues(keys.begin(),
 							    keys.end());
 			keys.clear();
 		}
 		_commands.push_back(CommandConfig((*it)->getValue(), interval,
-						  assign));
+						  assign, persistent));
 	}
 }
 
+void
+PanelConfig::loadSysInfo(CfgParser::Entry *section)
+{
+	_sysinfo_providers.clear();
+	if (section == nullptr) {
+		return;
+	}
+
+	std::string providers;
+	CfgParserKeys keys;
+	keys.add_numeric<uint>("INTERVAL", _sysinfo_interval_s, 1, 1);
+	keys.add_string("PROVIDERS", providers, "cpu net disk power thermal");
+	section->parseKeyValues(keys.begin(), keys.end());
+	keys.clear();
+
+	Util::splitString(providers, _sysinfo_providers, " \t");
+}
+
 void
 PanelConfig::loadWidgets(CfgParser::Entry *section)
 {
@@ -290,10 +315,15 @@ PanelConfig::calculateRefreshIntervalS(void) const
 	uint min = UINT_MAX;
 	command_config_vector::const_iterator it = _commands.begin();
 	for (; it != _commands.end(); ++it) {
-		if (it->getIntervalS() < min) {
+		// persistent commands are restarted using SIGALRM, no need
+		// to wake up at their interval.
+		if (! it->isPersistent() && it->getIntervalS() < min) {
 			min = it->getIntervalS();
 		}
 	}
+	if (! _sysinfo_providers.empty() && _sysinfo_interval_s < min) {
+		min = _sysinfo_interval_s;
+	}
 	std::vector<WidgetConfig>::const_iterator w_it = _widgets.begin();
 	for (; w_it != _widgets.end(); ++w_it) {
 		if (w_it->getIntervalS() < min) {
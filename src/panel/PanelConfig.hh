@@ -98,12 +98,14 @@ private:
 class CommandConfig {
 public:
 	CommandConfig(const std::string& command,
-		      uint interval_s, const std::string& assign);
+		      uint interval_s, const std::string& assign,
+		      bool persistent = false);
 	~CommandConfig();
 
 	const std::string& getCommand() const { return _command; }
 	uint getIntervalS() const { return _interval_s; }
 	const std::string& getAssign() const { return _assign; }
+	bool isPersistent() const { return _persistent; }
 
 private:
 	/** Command to run (using the shell) */
@@ -112,6 +114,11 @@ private:
 	uint _interval_s;
 	/** If non-empty, assign all line output to variable. */
 	std::string _assign;
+	/**
+	 * If true, the command is expected to keep running and is restarted
+	 * with backoff when it exits. _interval_s is the maximum backoff.
+	 */
+	bool _persistent;
 };
 
 /**
@@ -140,12 +147,18 @@ public:
 	}
 	command_config_it commandsEnd(void) const { return _commands.end(); }
 
+	uint getSysInfoIntervalS(void) const { return _sysinfo_interval_s; }
+	const std::vector<std::string>& getSysInfoProviders(void) const {
+		return _sysinfo_providers;
+	}
+
 	widget_config_it widgetsBegin(void) const { return _widgets.begin(); }
 	widget_config_it widgetsEnd(void) const { return _widgets.end(); }
 
 private:
 	void loadPanel(CfgParser::Entry *section);
 	void loadCommands(CfgParser::Entry *section);
+	void loadSysInfo(CfgParser::Entry *section);
 	void loadWidgets(CfgParser::Entry *section);
 	void loadWidgetClicks(CfgParser::Entry *section,
 			      std::vector<WidgetConfigClick> &clicks);
@@ -165,6 +178,10 @@ private:
 
 	/** List of commands to run. */
 	command_config_vector _commands;
+	/** Interval between updates of the native sysinfo providers. */
+	uint _sysinfo_interval_s;
+	/** Native sysinfo providers to enable. */
+	std::vector<std::string> _sysinfo_providers;
 	/** List of widgets to instantiate. */
 	std::vector<WidgetConfig> _widgets;
 	/** At what given interval is refresh required at a minimum. */
@@ -0,0 +1,528 @@
+//
+// SysInfoData.cc for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#include "Debug.hh"
+#include "String.hh"
+#include "SysInfoData.hh"
+
+#include <algorithm>
+#include <sstream>
+
+extern "C" {
+#include <assert.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+}
+
+/** Size of a sector in /proc/diskstats, independent of the device. */
+static const uint64_t DISKSTATS_SECTOR_SIZE = 512;
+
+static double
+_elapsed(const struct timespec &from, const struct timespec &to)
+{
+	return (to.tv_sec - from.tv_sec)
+		+ (to.tv_nsec - from.tv_nsec) / 1000000000.0;
+}
+
+static void
+_trim(std::string& str)
+{
+	std::string::size_type first = str.find_first_not_of(" \t\n");
+	if (first == std::string::npos) {
+		str.clear();
+	} else {
+		std::string::size_type last = str.find_last_not_of(" \t\n");
+		str = str.substr(first, last - first + 1);
+	}
+}
+
+static unsigned long
+_rate(uint64_t prev, uint64_t curr, double elapsed_s)
+{
+	if (curr < prev || elapsed_s <= 0.0) {
+		// counter wrapped or was reset
+		return 0;
+	}
+	return static_cast<unsigned long>((curr - prev) / elapsed_s);
+}
+
+// SysInfoFile
+
+SysInfoFile::SysInfoFile()
+	: _fd(-1),
+	  _buf(4096)
+{
+}
+
+SysInfoFile::~SysInfoFile()
+{
+	if (_fd != -1) {
+		close(_fd);
+	}
+}
+
+bool
+SysInfoFile::open(const std::string& path)
+{
+	if (_fd != -1) {
+		close(_fd);
+	}
+	_fd = ::open(path.c_str(), O_RDONLY);
+	if (_fd == -1) {
+		P_TRACE("failed to open " << path << ": " << strerror(errno));
+		return false;
+	}
+	fcntl(_fd, F_SETFD, FD_CLOEXEC);
+	return true;
+}
+
+/**
+ * Read the full content of the file, the buffer is grown if the content
+ * does not fit.
+ */
+bool
+SysInfoFile::read(std::string& data)
+{
+	if (_fd == -1) {
+		return false;
+	}
+
+	size_t len = 0;
+	for (;;) {
+		ssize_t nread = pread(_fd, &_buf[len], _buf.size() - len, len);
+		if (nread == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		} else if (nread == 0) {
+			break;
+		}
+		len += nread;
+		if (len == _buf.size()) {
+			_buf.resize(_buf.size() * 2);
+		}
+	}
+	data.assign(&_buf[0], len);
+	return true;
+}
+
+// SysInfoProvider
+
+SysInfoProvider::SysInfoProvider(VarData& var_data)
+	: _var_data(var_data)
+{
+}
+
+SysInfoProvider::~SysInfoProvider()
+{
+}
+
+void
+SysInfoProvider::set(const std::string& field, unsigned long value)
+{
+	_var_data.set(field, std::to_string(value));
+}
+
+// SysInfoCpu
+
+SysInfoCpu::SysInfoCpu(VarData& var_data, const std::string& path)
+	: SysInfoProvider(var_data),
+	  _path(path)
+{
+}
+
+SysInfoCpu::~SysInfoCpu()
+{
+}
+
+void
+SysInfoCpu::update(double)
+{
+	std::string data;
+	if (_file.read(data)) {
+		parse(data);
+	}
+}
+
+/**
+ * Parse cpu lines from /proc/stat, usage is calculated from the
+ * difference to the previous parse. Idle time includes iowait.
+ */
+void
+SysInfoCpu::parse(const std::string& data)
+{
+	std::istringstream is(data);
+	std::string line;
+	while (std::getline(is, line)) {
+		if (line.compare(0, 3, "cpu") != 0) {
+			continue;
+		}
+
+		std::istringstream ls(line);
+		std::string name;
+		ls >> name;
+
+		Times times;
+		uint64_t value;
+		for (int i = 0; ls >> value; i++) {
+			// user nice system idle iowait irq softirq steal,
+			// guest time is included in user time.
+			if (i < 8) {
+				times.total += value;
+			}
+			if (i == 3 || i == 4) {
+				times.idle += value;
+			}
+		}
+
+		std::map<std::string, Times>::iterator it = _prev.find(name);
+		if (it != _prev.end()) {
+			uint64_t total = times.total - it->second.total;
+			uint64_t idle = times.idle - it->second.idle;
+			unsigned long percent = 0;
+			if (total > 0 && times.total >= it->second.total
+			    && idle <= total) {
+				percent = ((total - idle) * 100) / total;
+			}
+			set("sysinfo_" + name + "_percent", percent);
+		}
+		_prev[name] = times;
+	}
+}
+
+// SysInfoNet
+
+SysInfoNet::SysInfoNet(VarData& var_data, const std::string& path)
+	: SysInfoProvider(var_data),
+	  _path(path)
+{
+}
+
+SysInfoNet::~SysInfoNet()
+{
+}
+
+void
+SysInfoNet::update(double elapsed_s)
+{
+	std::string data;
+	if (_file.read(data)) {
+		parse(data, elapsed_s);
+	}
+}
+
+/**
+ * Parse interface lines from /proc/net/dev, the two first lines are
+ * headers.
+ */
+void
+SysInfoNet::parse(const std::string& data, double elapsed_s)
+{
+	std::istringstream is(data);
+	std::string line;
+	while (std::getline(is, line)) {
+		std::string::size_type colon = line.find(':');
+		if (colon == std::string::npos) {
+			continue;
+		}
+
+		std::string name = line.substr(0, colon);
+		_trim(name);
+
+		std::istringstream ls(line.substr(colon + 1));
+		uint64_t rx = 0, tx = 0, value;
+		for (int i = 0; i < 9 && ls >> value; i++) {
+			if (i == 0) {
+				rx = value;
+			} else if (i == 8) {
+				tx = value;
+			}
+		}
+
+		std::map<std::string, std::pair<uint64_t, uint64_t> >::iterator
+			it = _prev.find(name);
+		if (it != _prev.end()) {
+			set("sysinfo_net_" + name + "_rx",
+			    _rate(it->second.first, rx, elapsed_s));
+			set("sysinfo_net_" + name + "_tx",
+			    _rate(it->second.second, tx, elapsed_s));
+		}
+		_prev[name] = std::make_pair(rx, tx);
+	}
+}
+
+// SysInfoDisk
+
+SysInfoDisk::SysInfoDisk(VarData& var_data, const std::string& path)
+	: SysInfoProvider(var_data),
+	  _path(path)
+{
+}
+
+SysInfoDisk::~SysInfoDisk()
+{
+}
+
+void
+SysInfoDisk::update(double elapsed_s)
+{
+	std::string data;
+	if (_file.read(data)) {
+		parse(data, elapsed_s);
+	}
+}
+
+/**
+ * Parse /proc/diskstats, sectors read is the 6th field and sectors
+ * written the 10th. loop and ram devices are ignored.
+ */
+void
+SysInfoDisk::parse(const std::string& data, double elapsed_s)
+{
+	std::istringstream is(data);
+	std::string line;
+	while (std::getline(is, line)) {
+		std::istringstream ls(line);
+		unsigned long major, minor;
+		std::string name;
+		if (! (ls >> major >> minor >> name)
+		    || name.compare(0, 4, "loop") == 0
+		    || name.compare(0, 3, "ram") == 0) {
+			continue;
+		}
+
+		uint64_t read = 0, written = 0, value;
+		for (int i = 0; i < 7 && ls >> value; i++) {
+			if (i == 2) {
+				read = value * DISKSTATS_SECTOR_SIZE;
+			} else if (i == 6) {
+				written = value * DISKSTATS_SECTOR_SIZE;
+			}
+		}
+
+		std::map<std::string, std::pair<uint64_t, uint64_t> >::iterator
+			it = _prev.find(name);
+		if (it != _prev.end()) {
+			set("sysinfo_disk_" + name + "_read",
+			    _rate(it->second.first, read, elapsed_s));
+			set("sysinfo_disk_" + name + "_write",
+			    _rate(it->second.second, written, elapsed_s));
+		}
+		_prev[name] = std::make_pair(read, written);
+	}
+}
+
+// SysInfoClass
+
+SysInfoClass::SysInfoClass(VarData& var_data, const char *name,
+			   const std::string& path,
+			   const std::string& prefix)
+	: SysInfoProvider(var_data),
+	  _name(name),
+	  _path(path),
+	  _prefix(prefix)
+{
+}
+
+SysInfoClass::~SysInfoClass()
+{
+	std::vector<Entry>::iterator it = _entries.begin();
+	for (; it != _entries.end(); ++it) {
+		delete it->file;
+	}
+}
+
+/**
+ * Add file to read in each sub-directory, published as
+ * sysinfo_NAME_DIR_SUFFIX where a leading NAME_ in DIR is removed.
+ */
+void
+SysInfoClass::addFile(const std::string& file, const std::string& suffix,
+		      unsigned long divisor)
+{
+	_files.push_back(File(file, suffix, divisor));
+}
+
+/**
+ * Open files in all sub-directories of path, the set of devices is
+ * fixed until the panel is restarted.
+ */
+bool
+SysInfoClass::open()
+{
+	DIR *dh = opendir(_path.c_str());
+	if (dh == nullptr) {
+		return false;
+	}
+
+	std::vector<std::string> dirs;
+	struct dirent *entry;
+	while ((entry = readdir(dh)) != nullptr) {
+		std::string dir(entry->d_name);
+		if (dir[0] != '.'
+		    && dir.compare(0, _prefix.size(), _prefix) == 0) {
+			dirs.push_back(dir);
+		}
+	}
+	closedir(dh);
+	std::sort(dirs.begin(), dirs.end());
+
+	std::string name_prefix = std::string(_name) + "_";
+	std::vector<std::string>::iterator it = dirs.begin();
+	for (; it != dirs.end(); ++it) {
+		std::string dir_name(*it);
+		if (dir_name.compare(0, name_prefix.size(), name_prefix) == 0) {
+			dir_name.erase(0, name_prefix.size());
+		}
+
+		std::vector<File>::iterator fit = _files.begin();
+		for (; fit != _files.end(); ++fit) {
+			Entry entry("sysinfo_" + name_prefix + dir_name
+				    + fit->suffix, fit->divisor);
+			if (entry.file->open(_path + "/" + *it + "/"
+					     + fit->name)) {
+				_entries.push_back(entry);
+			} else {
+				delete entry.file;
+			}
+		}
+	}
+	return ! _entries.empty();
+}
+
+void
+SysInfoClass::update(double)
+{
+	std::string data;
+	std::vector<Entry>::iterator it = _entries.begin();
+	for (; it != _entries.end(); ++it) {
+		if (! it->file->read(data)) {
+			continue;
+		}
+
+		_trim(data);
+		if (it->divisor == 0) {
+			_var_data.set(it->field, data);
+		} else {
+			char *endptr;
+			long value = strtol(data.c_str(), &endptr, 10);
+			if (! data.empty() && *endptr == '\0') {
+				set(it->field, value / static_cast<long>(
+						it->divisor));
+			}
+		}
+	}
+}
+
+// SysInfoPower
+
+SysInfoPower::SysInfoPower(VarData& var_data, const std::string& path)
+	: SysInfoClass(var_data, "power", path, "")
+{
+	addFile("capacity", "_capacity", 1);
+	addFile("status", "_status", 0);
+	addFile("online", "_online", 1);
+}
+
+SysInfoPower::~SysInfoPower()
+{
+}
+
+// SysInfoThermal
+
+SysInfoThermal::SysInfoThermal(VarData& var_data, const std::string& path)
+	: SysInfoClass(var_data, "thermal", path, "thermal_zone")
+{
+	addFile("temp", "", 1000);
+}
+
+SysInfoThermal::~SysInfoThermal()
+{
+}
+
+// SysInfoData
+
+SysInfoData::SysInfoData(const PanelConfig& cfg, VarData& var_data)
+	: _interval_s(cfg.getSysInfoIntervalS())
+{
+	int ret = clock_gettime(CLOCK_MONOTONIC, &_last_update);
+	assert(ret == 0);
+
+	const std::vector<std::string>& providers = cfg.getSysInfoProviders();
+	std::vector<std::string>::const_iterator it = providers.begin();
+	for (; it != providers.end(); ++it) {
+		SysInfoProvider *provider = mkProvider(*it, var_data);
+		if (provider == nullptr) {
+			USER_WARN("unknown sysinfo provider " << *it);
+		} else if (provider->open()) {
+			_providers.push_back(provider);
+			// initial update to have a previous sample for
+			// providers publishing deltas.
+			provider->update(0.0);
+		} else {
+			P_LOG("sysinfo provider " << *it
+			      << " not available on this system");
+			delete provider;
+		}
+	}
+}
+
+SysInfoData::~SysInfoData()
+{
+	std::vector<SysInfoProvider*>::iterator it = _providers.begin();
+	for (; it != _providers.end(); ++it) {
+		delete *it;
+	}
+}
+
+/**
+ * Update all providers if the interval has passed since the last update.
+ */
+void
+SysInfoData::refresh()
+{
+	if (_providers.empty()) {
+		return;
+	}
+
+	struct timespec now;
+	int ret = clock_gettime(CLOCK_MONOTONIC, &now);
+	assert(ret == 0);
+	double elapsed_s = _elapsed(_last_update, now);
+	if (elapsed_s < _interval_s) {
+		return;
+	}
+
+	std::vector<SysInfoProvider*>::iterator it = _providers.begin();
+	for (; it != _providers.end(); ++it) {
+		(*it)->update(elapsed_s);
+	}
+	_last_update = now;
+}
+
+SysInfoProvider*
+SysInfoData::mkProvider(const std::string& name, VarData& var_data)
+{
+	if (pekwm::ascii_ncase_equal(name, "cpu")) {
+		return new SysInfoCpu(var_data);
+	} else if (pekwm::ascii_ncase_equal(name, "net")) {
+		return new SysInfoNet(var_data);
+	} else if (pekwm::ascii_ncase_equal(name, "disk")) {
+		return new SysInfoDisk(var_data);
+	} else if (pekwm::ascii_ncase_equal(name, "power")) {
+		return new SysInfoPower(var_data);
+	} else if (pekwm::ascii_ncase_equal(name, "thermal")) {
+		return new SysInfoThermal(var_data);
+	}
+	return nullptr;
+}
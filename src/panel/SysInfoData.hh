@@ -0,0 +1,258 @@
+//
+// SysInfoData.hh for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+#ifndef _PEKWM_PANEL_SYS_INFO_DATA_HH_
+#define _PEKWM_PANEL_SYS_INFO_DATA_HH_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "pekwm_panel.hh"
+#include "PanelConfig.hh"
+#include "Types.hh"
+#include "VarData.hh"
+
+extern "C" {
+#include <time.h>
+}
+
+/**
+ * File kept open and re-read from the start using pread, avoiding an
+ * open/close of files in /proc and /sys for every update.
+ */
+class SysInfoFile {
+public:
+	SysInfoFile();
+	~SysInfoFile();
+
+	bool isOpen() const { return _fd != -1; }
+	bool open(const std::string& path);
+	bool read(std::string& data);
+
+private:
+	SysInfoFile(const SysInfoFile&);
+	SysInfoFile& operator=(const SysInfoFile&);
+
+	int _fd;
+	/** Read buffer, grows to fit the file content. */
+	std::vector<char> _buf;
+};
+
+/**
+ * Native system information provider, publishing values directly to
+ * VarData without running an external command.
+ */
+class SysInfoProvider {
+public:
+	SysInfoProvider(VarData& var_data);
+	virtual ~SysInfoProvider();
+
+	virtual const char *getName() const = 0;
+	/** Open data sources, false if not available on this system. */
+	virtual bool open() = 0;
+	/** Read data sources, elapsed_s is the time since last update. */
+	virtual void update(double elapsed_s) = 0;
+
+protected:
+	void set(const std::string& field, unsigned long value);
+
+	VarData& _var_data;
+
+private:
+	SysInfoProvider(const SysInfoProvider&);
+	SysInfoProvider& operator=(const SysInfoProvider&);
+};
+
+/**
+ * CPU usage in percent, total and per core, from /proc/stat.
+ *
+ * sysinfo_cpu_percent, sysinfo_cpuN_percent
+ */
+class SysInfoCpu : public SysInfoProvider {
+public:
+	SysInfoCpu(VarData& var_data, const std::string& path = "/proc/stat");
+	virtual ~SysInfoCpu();
+
+	virtual const char *getName() const { return "cpu"; }
+	virtual bool open() { return _file.open(_path); }
+	virtual void update(double elapsed_s);
+
+	void parse(const std::string& data);
+
+private:
+	class Times {
+	public:
+		Times()
+			: total(0),
+			  idle(0)
+		{
+		}
+
+		uint64_t total;
+		uint64_t idle;
+	};
+
+	std::string _path;
+	SysInfoFile _file;
+	std::map<std::string, Times> _prev;
+};
+
+/**
+ * Network throughput in bytes per second from /proc/net/dev.
+ *
+ * sysinfo_net_IFACE_rx, sysinfo_net_IFACE_tx
+ */
+class SysInfoNet : public SysInfoProvider {
+public:
+	SysInfoNet(VarData& var_data,
+		   const std::string& path = "/proc/net/dev");
+	virtual ~SysInfoNet();
+
+	virtual const char *getName() const { return "net"; }
+	virtual bool open() { return _file.open(_path); }
+	virtual void update(double elapsed_s);
+
+	void parse(const std::string& data, double elapsed_s);
+
+private:
+	std::string _path;
+	SysInfoFile _file;
+	std::map<std::string, std::pair<uint64_t, uint64_t> > _prev;
+};
+
+/**
+ * Disk I/O in bytes per second from /proc/diskstats.
+ *
+ * sysinfo_disk_DEVICE_read, sysinfo_disk_DEVICE_write
+ */
+class SysInfoDisk : public SysInfoProvider {
+public:
+	SysInfoDisk(VarData& var_data,
+		    const std::string& path = "/proc/diskstats");
+	virtual ~SysInfoDisk();
+
+	virtual const char *getName() const { return "disk"; }
+	virtual bool open() { return _file.open(_path); }
+	virtual void update(double elapsed_s);
+
+	void parse(const std::string& data, double elapsed_s);
+
+private:
+	std::string _path;
+	SysInfoFile _file;
+	std::map<std::string, std::pair<uint64_t, uint64_t> > _prev;
+};
+
+/**
+ * Values read from a single file in each sub-directory of a /sys class
+ * directory, such as capacity of power supplies.
+ */
+class SysInfoClass : public SysInfoProvider {
+public:
+	SysInfoClass(VarData& var_data, const char *name,
+		     const std::string& path, const std::string& prefix);
+	virtual ~SysInfoClass();
+
+	virtual const char *getName() const { return _name; }
+	virtual bool open();
+	virtual void update(double elapsed_s);
+
+protected:
+	void addFile(const std::string& file, const std::string& suffix,
+		     unsigned long divisor);
+
+private:
+	class Entry {
+	public:
+		Entry(const std::string& field_, unsigned long divisor_)
+			: field(field_),
+			  divisor(divisor_),
+			  file(new SysInfoFile())
+		{
+		}
+
+		std::string field;
+		/** divisor for numeric values, 0 for string values. */
+		unsigned long divisor;
+		SysInfoFile *file;
+	};
+
+	class File {
+	public:
+		File(const std::string& name_, const std::string& suffix_,
+		     unsigned long divisor_)
+			: name(name_),
+			  suffix(suffix_),
+			  divisor(divisor_)
+		{
+		}
+
+		std::string name;
+		std::string suffix;
+		unsigned long divisor;
+	};
+
+	const char *_name;
+	std::string _path;
+	/** Only sub-directories starting with prefix are read. */
+	std::string _prefix;
+	std::vector<File> _files;
+	std::vector<Entry> _entries;
+};
+
+/**
+ * Battery and AC status from /sys/class/power_supply.
+ *
+ * sysinfo_power_NAME_capacity, sysinfo_power_NAME_status,
+ * sysinfo_power_NAME_online
+ */
+class SysInfoPower : public SysInfoClass {
+public:
+	SysInfoPower(VarData& var_data,
+		     const std::string& path = "/sys/class/power_supply");
+	virtual ~SysInfoPower();
+};
+
+/**
+ * Temperature in degrees celsius from /sys/class/thermal.
+ *
+ * sysinfo_thermal_zoneN
+ */
+class SysInfoThermal : public SysInfoClass {
+public:
+	SysInfoThermal(VarData& var_data,
+		       const std::string& path = "/sys/class/thermal");
+	virtual ~SysInfoThermal();
+};
+
+/**
+ * Collection of native system information providers updated at the
+ * configured interval.
+ */
+class SysInfoData {
+public:
+	SysInfoData(const PanelConfig& cfg, VarData& var_data);
+	~SysInfoData();
+
+	size_t size() const { return _providers.size(); }
+
+	void refresh();
+
+	static SysInfoProvider *mkProvider(const std::string& name,
+					   VarData& var_data);
+
+private:
+	SysInfoData(const SysInfoData&);
+	SysInfoData& operator=(const SysInfoData&);
+
+	uint _interval_s;
+	struct timespec _last_update;
+	std::vector<SysInfoProvider*> _providers;
+};
+
+#endif // _PEKWM_PANEL_SYS_INFO_DATA_HH_
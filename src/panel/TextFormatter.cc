@@ -9,6 +9,7 @@
 #include "Charset.hh"
 #include "TextFormatter.hh"
 
+#include <algorithm>
 #include <set>
 
 /** empty string, used as default return value. */
@@ -45,18 +46,97 @@ TextFormatter::format(const std::string& pp_format)
 	return format(pp_format, TextFormatter::tfExpandVar);
 }
 
+/**
+ * compile previously pre-processed format string into segments, resolving
+ * field names to ids.
+ */
+void
+TextFormatter::compile(const std::string& pp_format, segment_vector& segments)
+{
+	segment_vector tokens;
+	tokenize(pp_format, tokens);
+
+	segments.clear();
+	segment_vector::iterator it(tokens.begin());
+	for (; it != tokens.end(); ++it) {
+		if (it->type == SEGMENT_TEXT) {
+			if (! segments.empty()
+			    && segments.back().type == SEGMENT_TEXT) {
+				segments.back().text += it->text;
+			} else {
+				segments.push_back(*it);
+			}
+		} else if (it->text.empty()) {
+			// empty variable, always expands to nothing
+		} else if (it->text[0] == ':') {
+			segments.push_back(Segment(SEGMENT_WM_STATE,
+						   it->text));
+		} else {
+			uint field_id = _var_data.getFieldId(it->text);
+			segments.push_back(Segment(SEGMENT_FIELD, it->text,
+						   field_id));
+		}
+	}
+}
+
+/**
+ * format compiled format string, only field and wm state segments are
+ * expanded.
+ */
+std::string
+TextFormatter::format(const segment_vector& segments)
+{
+	std::string formatted;
+	segment_vector::const_iterator it(segments.begin());
+	for (; it != segments.end(); ++it) {
+		switch (it->type) {
+		case SEGMENT_TEXT:
+			formatted += it->text;
+			break;
+		case SEGMENT_FIELD:
+			formatted += _var_data.get(it->field_id);
+			break;
+		case SEGMENT_VAR:
+		case SEGMENT_WM_STATE:
+			formatted += expandVar(it->text);
+			break;
+		}
+	}
+	return formatted;
+}
+
 std::string
 TextFormatter::format(const std::string& pp_format, formatFun exp)
+{
+	segment_vector segments;
+	tokenize(pp_format, segments);
+
+	std::string formatted;
+	segment_vector::iterator it(segments.begin());
+	for (; it != segments.end(); ++it) {
+		if (it->type == SEGMENT_TEXT) {
+			formatted += it->text;
+		} else {
+			formatted += exp(this, it->text);
+		}
+	}
+	return formatted;
+}
+
+/**
+ * split format into text and variable segments, handling escapes.
+ */
+void
+TextFormatter::tokenize(const std::string& format, segment_vector& segments)
 {
 	static std::set<char> var_end_chars;
 	if (var_end_chars.empty()) {
 		var_end_chars.insert('\'');
 		var_end_chars.insert('"');
 	}
-	std::string formatted;
 
 	bool in_escape = false, in_var = false;
-	Charset::Utf8Iterator it(pp_format);
+	Charset::Utf8Iterator it(format);
 	std::string buf;
 	for (; it.ok(); ++it) {
 		if (in_escape) {
@@ -68,12 +148,12 @@ TextFormatter::format(const std::string& pp_format, formatFun exp)
 			   && it.charLen() == 1
 			   && (isspace((*it)[0])
 			       || var_end_chars.count((*it)[0]) != 0)) {
-			formatted += exp(this, buf);
+			segments.push_back(Segment(SEGMENT_VAR, buf));
 			buf = *it;
 			in_var = false;
 		} else if (! in_var && it == '%') {
 			if (! buf.empty()) {
-				formatted += buf;
+				segments.push_back(Segment(SEGMENT_TEXT, buf));
 				buf = _empty_string;
 			}
 			in_var = true;
@@ -82,14 +162,9 @@ TextFormatter::format(const std::string& pp_format, formatFun exp)
 		}
 	}
 	if (! buf.empty()) {
-		if (in_var) {
-			formatted += exp(this, buf);
-		} else {
-			formatted += buf;
-		}
+		segments.push_back(Segment(in_var ? SEGMENT_VAR : SEGMENT_TEXT,
+					   buf));
 	}
-
-	return formatted;
 }
 
 std::string
@@ -149,9 +224,20 @@ TextFormatObserver::TextFormatObserver(VarData& var_data, WmState& wm_state,
 	  _observer(observer),
 	  _pp_format(_tf.preprocess(format))
 {
-	if (! _tf.getFields().empty()) {
-		pekwm::observerMapping()->addObserver(
-			_tf.getVarData(), _observer, 100);
+	_tf.compile(_pp_format, _segments);
+
+	const std::vector<std::string> &fields = _tf.getFields();
+	std::vector<std::string>::const_iterator it(fields.begin());
+	for (; it != fields.end(); ++it) {
+		_field_ids.push_back(var_data.getFieldId(*it));
+	}
+	std::sort(_field_ids.begin(), _field_ids.end());
+	_field_ids.erase(std::unique(_field_ids.begin(), _field_ids.end()),
+			 _field_ids.end());
+
+	std::vector<uint>::iterator fit(_field_ids.begin());
+	for (; fit != _field_ids.end(); ++fit) {
+		var_data.addFieldObserver(*fit, _observer);
 	}
 	if (_tf.referenceWmState()) {
 		pekwm::observerMapping()->addObserver(
@@ -165,9 +251,9 @@ TextFormatObserver::~TextFormatObserver()
 		pekwm::observerMapping()->removeObserver(
 			_tf.getWmState(), _observer);
 	}
-	if (! _tf.getFields().empty()) {
-		pekwm::observerMapping()->removeObserver(
-			_tf.getVarData(), _observer);
+	std::vector<uint>::iterator it(_field_ids.begin());
+	for (; it != _field_ids.end(); ++it) {
+		_tf.getVarData()->removeFieldObserver(*it, _observer);
 	}
 }
 
@@ -182,14 +268,7 @@ TextFormatObserver::match(Observation *observation)
 	}
 
 	FieldObservation *fo = dynamic_cast<FieldObservation*>(observation);
-	if (fo != nullptr) {
-		const std::vector<std::string> &fields = _tf.getFields();
-		std::vector<std::string>::const_iterator it(fields.begin());
-		for (; it != fields.end(); ++it) {
-			if (*it == fo->getField()) {
-				return true;
-			}
-		}
-	}
-	return false;
+	return fo != nullptr
+		&& std::binary_search(_field_ids.begin(), _field_ids.end(),
+				      fo->getFieldId());
 }
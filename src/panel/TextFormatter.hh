@@ -1,6 +1,6 @@
 //
 // TextFormatter.hh for pekwm
-// Copyright (C) 2022 Claes Nästén <pekdon@gmail.com>
+// Copyright (C) 2022-2025 Claes Nästén <pekdon@gmail.com>
 //
 // This program is licensed under the GNU GPL.
 // See the LICENSE file for more information.
@@ -21,6 +21,33 @@ public:
 	typedef std::string(*formatFun)(TextFormatter *tf,
 			    const std::string& buf);
 
+	enum SegmentType {
+		SEGMENT_TEXT,
+		SEGMENT_VAR,
+		SEGMENT_FIELD,
+		SEGMENT_WM_STATE
+	};
+
+	/**
+	 * Part of a compiled format string, either static text or a
+	 * variable expanded when formatting.
+	 */
+	class Segment {
+	public:
+		Segment(SegmentType type_, const std::string& text_,
+			uint field_id_ = 0)
+			: type(type_),
+			  text(text_),
+			  field_id(field_id_)
+		{
+		}
+
+		SegmentType type;
+		std::string text;
+		uint field_id;
+	};
+	typedef std::vector<Segment> segment_vector;
+
 	TextFormatter(VarData& var_data, WmState& wm_state);
 	~TextFormatter();
 
@@ -33,8 +60,12 @@ public:
 	std::string preprocess(const std::string& raw_format);
 	std::string format(const std::string& pp_format);
 
+	void compile(const std::string& pp_format, segment_vector& segments);
+	std::string format(const segment_vector& segments);
+
 private:
 	std::string format(const std::string& pp_format, formatFun exp);
+	void tokenize(const std::string& format, segment_vector& segments);
 
 	std::string preprocessVar(const std::string& var);
 	std::string expandVar(const std::string& var);
@@ -69,7 +100,7 @@ public:
 	{
 		return _tf.getFields().empty() && ! _tf.referenceWmState();
 	}
-	std::string format() { return _tf.format(_pp_format); }
+	std::string format() { return _tf.format(_segments); }
 	const std::string& getPpFormat() const { return _pp_format; }
 	bool match(Observation* observation);
 
@@ -80,6 +111,10 @@ private:
 	TextFormatter _tf;
 	Observer* _observer;
 	std::string _pp_format;
+	/** _pp_format compiled for formatting without parsing. */
+	TextFormatter::segment_vector _segments;
+	/** Sorted ids of the fields referenced in the format. */
+	std::vector<uint> _field_ids;
 };
 
 #endif // _PEKWM_PANEL_TEXT_FORMATTER_HH_
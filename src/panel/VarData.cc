@@ -8,11 +8,14 @@
 
 #include "VarData.hh"
 
+#include <algorithm>
+
 /** empty string, used as default return value. */
 static std::string _empty_string;
 
-FieldObservation::FieldObservation(const std::string& field)
-	: _field(field)
+FieldObservation::FieldObservation(uint field_id, const std::string& field)
+	: _field_id(field_id),
+	  _field(field)
 {
 }
 
@@ -20,24 +23,92 @@ FieldObservation::~FieldObservation(void)
 {
 }
 
+VarData::VarData()
+{
+}
+
+VarData::~VarData()
+{
+}
+
+/**
+ * Get id for field, allocating a new id if the field has not been seen
+ * before.
+ */
+uint
+VarData::getFieldId(const std::string& field)
+{
+	std::map<std::string, uint>::iterator it = _field_ids.find(field);
+	if (it != _field_ids.end()) {
+		return it->second;
+	}
+
+	uint field_id = _names.size();
+	_field_ids[field] = field_id;
+	_names.push_back(field);
+	_values.push_back("");
+	_observers.push_back(std::vector<Observer*>());
+	return field_id;
+}
+
+const std::string&
+VarData::get(uint field_id) const
+{
+	return field_id < _values.size() ? _values[field_id] : _empty_string;
+}
+
 const std::string&
 VarData::get(const std::string& field) const
 {
-	std::map<std::string, std::string>::const_iterator it =
-	  _vars.find(field);
-	return it == _vars.end() ? _empty_string : it->second;
+	std::map<std::string, uint>::const_iterator it =
+		_field_ids.find(field);
+	return it == _field_ids.end() ? _empty_string : _values[it->second];
 }
 
 void
 VarData::set(const std::string& field, const std::string& value)
 {
-	// update the value in the map before notifying in case the
-	// value is read by the obvserver
-	std::map<std::string, std::string>::iterator it = _vars.find(field);
-	if (it == _vars.end() || it->second != value) {
-		_vars[field] = value;
+	uint field_id = getFieldId(field);
+	if (_values[field_id] == value) {
+		return;
+	}
+
+	// update the value before notifying in case the value is read by
+	// the obvserver
+	_values[field_id] = value;
+
+	FieldObservation field_obs(field_id, _names[field_id]);
+	// observers may unsubscribe while being notified, do not hold on
+	// to iterators.
+	for (size_t i = 0; i < _observers[field_id].size(); i++) {
+		_observers[field_id][i]->notify(this, &field_obs);
+	}
+	pekwm::observerMapping()->notifyObservers(this, &field_obs);
+}
+
+/**
+ * Subscribe observer to changes of field_id, an observer subscribed
+ * multiple times is notified multiple times.
+ */
+void
+VarData::addFieldObserver(uint field_id, Observer* observer)
+{
+	if (field_id < _observers.size()) {
+		_observers[field_id].push_back(observer);
+	}
+}
+
+void
+VarData::removeFieldObserver(uint field_id, Observer* observer)
+{
+	if (field_id >= _observers.size()) {
+		return;
+	}
 
-		FieldObservation field_obs(field);
-		pekwm::observerMapping()->notifyObservers(this, &field_obs);
+	std::vector<Observer*> &observers = _observers[field_id];
+	std::vector<Observer*>::iterator it =
+		std::find(observers.begin(), observers.end(), observer);
+	if (it != observers.end()) {
+		observers.erase(it);
 	}
 }
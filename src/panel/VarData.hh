@@ -1,6 +1,6 @@
 //
 // VarData.hh for pekwm
-// Copyright (C) 2022-2023 Claes Nästén <pekdon@gmail.com>
+// Copyright (C) 2022-2025 Claes Nästén <pekdon@gmail.com>
 //
 // This program is licensed under the GNU GPL.
 // See the LICENSE file for more information.
@@ -10,33 +10,57 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "Observable.hh"
+#include "Types.hh"
 
 class FieldObservation : public Observation
 {
 public:
-	FieldObservation(const std::string& field);
+	FieldObservation(uint field_id, const std::string& field);
 	virtual ~FieldObservation(void);
 
+	uint getFieldId(void) const { return _field_id; }
 	const std::string& getField(void) const { return _field; }
 
 private:
+	uint _field_id;
 	std::string _field;
 };
 
 /**
  * Variable data storage, used by WmState and ExternalCommandData to
  * store and notify data.
+ *
+ * Field names are interned to ids, observers subscribed to a field id are
+ * notified when that field changes before the observers of the VarData
+ * itself.
  */
 class VarData : public Observable
 {
 public:
+	VarData();
+	virtual ~VarData();
+
+	uint getFieldId(const std::string& field);
+
+	const std::string& get(uint field_id) const;
 	const std::string& get(const std::string& field) const;
 	void set(const std::string& field, const std::string& value);
 
+	void addFieldObserver(uint field_id, Observer* observer);
+	void removeFieldObserver(uint field_id, Observer* observer);
+
 private:
-	std::map<std::string, std::string> _vars;
+	/** Field name to field id. */
+	std::map<std::string, uint> _field_ids;
+	/** Field names, indexed by field id. */
+	std::vector<std::string> _names;
+	/** Field values, indexed by field id. */
+	std::vector<std::string> _values;
+	/** Field observers, indexed by field id. */
+	std::vector<std::vector<Observer*> > _observers;
 };
 
 #endif // _PEKWM_PANEL_VAR_DATA_HH_
@@ -22,12 +22,14 @@
 #include "PanelConfig.hh"
 #include "PanelTheme.hh"
 #include "PanelWidget.hh"
+#include "SysInfoData.hh"
 #include "VarData.hh"
 #include "WidgetFactory.hh"
 #include "WmState.hh"
 
 #include "../tk/CfgUtil.hh"
 #include "../tk/FontHandler.hh"
+#include "../tk/ImageCache.hh"
 #include "../tk/ImageHandler.hh"
 #include "../tk/TextureHandler.hh"
 #include "../tk/ThemeUtil.hh"
@@ -295,6 +297,7 @@ private:
 	PanelTheme& _theme;
 	VarData _var_data;
 	ExternalCommandData _ext_data;
+	SysInfoData _sysinfo_data;
 	WmState _wm_state;
 	std::vector<PanelWidget*> _widgets;
 	uint _widgets_visible;
@@ -314,6 +317,7 @@ PekwmPanel::PekwmPanel(const PanelConfig &cfg, PanelTheme &theme,
 	  _cfg(cfg),
 	  _theme(theme),
 	  _ext_data(cfg, _var_data),
+	  _sysinfo_data(cfg, _var_data),
 	  _wm_state(_var_data),
 	  _widgets_visible(0),
 	  _background(sh->width, sh->height)
@@ -419,6 +423,7 @@ void
 PekwmPanel::refresh(bool timed_out)
 {
 	_ext_data.refresh(ppAddFd, reinterpret_cast<void*>(this));
+	_sysinfo_data.refresh();
 	if (timed_out) {
 		renderPred(renderPredAlways, nullptr);
 	}
@@ -672,6 +677,7 @@ static void init(Display* dpy, float scale)
 	// options setup in loadTheme later on
 	_font_handler = new FontHandler(scale, false, "");
 	_image_handler = new ImageHandler(scale);
+	_image_handler->setCacheDir(ImageCache::getDefaultDir());
 	_texture_handler = new TextureHandler(scale);
 }
 
@@ -6,6 +6,8 @@
 // See the LICENSE file for more information.
 //
 
+#include "config.h"
+
 #include "Compat.hh"
 #include "Util.hh"
 #include "X11.hh"
@@ -23,8 +25,16 @@ extern "C" {
 #include <time.h>
 #include <unistd.h>
 #include <X11/Xutil.h>
+#ifdef PEKWM_HAVE_XSHM
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <X11/extensions/XShm.h>
+#endif // PEKWM_HAVE_XSHM
 }
 
+/** zlib compression level, favor speed over size. */
+static const int PNG_COMPRESSION_LEVEL = 1;
+
 static ImageHandler* _image_handler = nullptr;
 
 namespace pekwm
@@ -45,19 +55,245 @@ static void cleanup()
 	delete _image_handler;
 }
 
+/**
+ * Convert one channel of pixel to 8 bits using mask.
+ */
+static uchar
+pixelChannel(ulong pixel, ulong mask)
+{
+	if (mask == 0) {
+		return 0;
+	}
+	uint shift = 0;
+	while (! (mask & 1)) {
+		mask >>= 1;
+		shift++;
+	}
+	uint bits = 0;
+	for (ulong m = mask; m & 1; m >>= 1) {
+		bits++;
+	}
+	ulong val = (pixel >> shift) & mask;
+	if (bits >= 8) {
+		return val >> (bits - 8);
+	}
+	return (val * 255) / mask;
+}
+
+/**
+ * Row source converting XImage rows to RGB, with a fast path for
+ * the common 32 bit TrueColor layout.
+ */
+class XImageRowSource : public PImageLoaderPng::RowSource {
+public:
+	XImageRowSource(XImage *ximage)
+		: _ximage(ximage),
+		  _rgb32(ximage->bits_per_pixel == 32
+			 && ximage->red_mask == 0xff0000
+			 && ximage->green_mask == 0xff00
+			 && ximage->blue_mask == 0xff)
+	{
+	}
+	virtual ~XImageRowSource() { }
+
+	virtual void getRow(uint y, uchar *rgb)
+	{
+		if (_rgb32) {
+			getRowRgb32(y, rgb);
+			return;
+		}
+
+		for (int x = 0; x < _ximage->width; x++) {
+			ulong pixel = XGetPixel(_ximage, x, y);
+			*rgb++ = pixelChannel(pixel, _ximage->red_mask);
+			*rgb++ = pixelChannel(pixel, _ximage->green_mask);
+			*rgb++ = pixelChannel(pixel, _ximage->blue_mask);
+		}
+	}
+
+private:
+	void getRowRgb32(uint y, uchar *rgb)
+	{
+		const uchar *src = reinterpret_cast<uchar*>(_ximage->data)
+			+ y * _ximage->bytes_per_line;
+		bool lsb = _ximage->byte_order == LSBFirst;
+		for (int x = 0; x < _ximage->width; x++, src += 4) {
+			if (lsb) {
+				*rgb++ = src[2];
+				*rgb++ = src[1];
+				*rgb++ = src[0];
+			} else {
+				*rgb++ = src[1];
+				*rgb++ = src[2];
+				*rgb++ = src[3];
+			}
+		}
+	}
+
+	XImage *_ximage;
+	bool _rgb32;
+};
+
+/**
+ * Capture of an area of the root window, using a MIT-SHM segment re-used
+ * between captures if available and XGetImage if not.
+ */
+class Capture {
+public:
+	Capture(const Geometry &gm)
+		: _gm(gm),
+		  _ximage(nullptr),
+		  _shm(false)
+	{
+#ifdef PEKWM_HAVE_XSHM
+		_shm_info.shmid = -1;
+		_shm_info.shmaddr = nullptr;
+#endif // PEKWM_HAVE_XSHM
+	}
+
+	~Capture()
+	{
+#ifdef PEKWM_HAVE_XSHM
+		if (_shm) {
+			XShmDetach(X11::getDpy(), &_shm_info);
+			X11::sync(False);
+			_ximage->data = nullptr;
+			X11::destroyImage(_ximage);
+			shmdt(_shm_info.shmaddr);
+			return;
+		}
+#endif // PEKWM_HAVE_XSHM
+		X11::destroyImage(_ximage);
+	}
+
+	const Geometry &getGeometry() const { return _gm; }
+	bool isShm() const { return _shm; }
+
+	/**
+	 * Setup shared memory segment, must be called before restricting
+	 * access with pledge.
+	 */
+	void initShm()
+	{
+#ifdef PEKWM_HAVE_XSHM
+		_shm = createShm();
+#endif // PEKWM_HAVE_XSHM
+	}
+
+	XImage *grab()
+	{
+#ifdef PEKWM_HAVE_XSHM
+		if (_shm) {
+			if (XShmGetImage(X11::getDpy(), X11::getRoot(),
+					 _ximage, _gm.x, _gm.y, AllPlanes)) {
+				return _ximage;
+			}
+			return nullptr;
+		}
+#endif // PEKWM_HAVE_XSHM
+		X11::destroyImage(_ximage);
+		_ximage = X11::getImage(X11::getRoot(),
+					_gm.x, _gm.y, _gm.width, _gm.height,
+					AllPlanes, ZPixmap);
+		return _ximage;
+	}
+
+private:
+#ifdef PEKWM_HAVE_XSHM
+	static int shmErrorHandler(Display*, XErrorEvent*)
+	{
+		_shm_error = true;
+		return 0;
+	}
+
+	bool createShm()
+	{
+		Display *dpy = X11::getDpy();
+		if (! XShmQueryExtension(dpy)) {
+			return false;
+		}
+
+		int screen = DefaultScreen(dpy);
+		_ximage = XShmCreateImage(dpy, DefaultVisual(dpy, screen),
+					  DefaultDepth(dpy, screen), ZPixmap,
+					  nullptr, &_shm_info,
+					  _gm.width, _gm.height);
+		if (_ximage == nullptr) {
+			return false;
+		}
+
+		_shm_info.shmid = shmget(IPC_PRIVATE,
+					 _ximage->bytes_per_line
+					 * _ximage->height,
+					 IPC_CREAT | 0600);
+		if (_shm_info.shmid == -1) {
+			X11::destroyImage(_ximage);
+			_ximage = nullptr;
+			return false;
+		}
+		_shm_info.shmaddr = static_cast<char*>(
+			shmat(_shm_info.shmid, nullptr, 0));
+		_shm_info.readOnly = False;
+		_ximage->data = _shm_info.shmaddr;
+
+		// attach fails on remote displays, reported asynchronously.
+		_shm_error = false;
+		XErrorHandler old_handler = XSetErrorHandler(shmErrorHandler);
+		bool attached = _shm_info.shmaddr != reinterpret_cast<char*>(-1)
+			&& XShmAttach(dpy, &_shm_info);
+		X11::sync(False);
+		XSetErrorHandler(old_handler);
+
+		// segment is freed once detached by both pekwm_screenshot
+		// and the X server.
+		shmctl(_shm_info.shmid, IPC_RMID, nullptr);
+		if (attached && ! _shm_error) {
+			return true;
+		}
+
+		if (_shm_info.shmaddr != reinterpret_cast<char*>(-1)) {
+			shmdt(_shm_info.shmaddr);
+		}
+		_ximage->data = nullptr;
+		X11::destroyImage(_ximage);
+		_ximage = nullptr;
+		return false;
+	}
+#endif // PEKWM_HAVE_XSHM
+
+	Geometry _gm;
+	XImage *_ximage;
+	bool _shm;
+#ifdef PEKWM_HAVE_XSHM
+	XShmSegmentInfo _shm_info;
+	static bool _shm_error;
+#endif // PEKWM_HAVE_XSHM
+};
+
+#ifdef PEKWM_HAVE_XSHM
+bool Capture::_shm_error = false;
+#endif // PEKWM_HAVE_XSHM
+
 static void usage(const char* name, int ret)
 {
-	std::cout << "usage: " << name << " [-dhw] [screenshot.png]"
+	std::cout << "usage: " << name << " [-dghHinw] [screenshot.png]"
 		  << std::endl;
 	std::cout << "  -d --display dpy    Display" << std::endl;
+	std::cout << "  -g --geometry gm    Capture region WxH+X+Y"
+		  << std::endl;
 	std::cout << "  -h --help           Display this information"
 		  << std::endl;
+	std::cout << "  -H --head head      Capture head" << std::endl;
+	std::cout << "  -i --interval ms    Milliseconds between screenshots"
+		  << std::endl;
+	std::cout << "  -n --repeat num     Number of screenshots to take"
+		  << std::endl;
 	std::cout << "  -w --wait seconds   Wait seconds before taking "
 		     "screenshot" << std::endl;
 	exit(ret);
 }
 
-static std::string get_screenhot_name(const Geometry& gm)
+static std::string get_screenhot_name(const Geometry& gm, int num)
 {
 	time_t t = time(nullptr);
 	tm tm;
@@ -67,55 +303,150 @@ static std::string get_screenhot_name(const Geometry& gm)
 	name << "pekwm_screenshot-";
 	name << std::put_time(&tm, "%Y%m%dT%H%M%S");
 	name << "-" << gm.width << "x" << gm.height;
+	if (num > 0) {
+		name << "-" << num;
+	}
 	name << ".png";
 	return name.str();
 }
 
-static int take_screenshot(const std::string& output)
+/**
+ * Get name of screenshot num when repeating, num is inserted before the
+ * file extension.
+ */
+static std::string get_repeat_name(const std::string& output, int num)
+{
+	std::ostringstream name;
+	std::string::size_type dot = output.rfind('.');
+	std::string::size_type slash = output.rfind('/');
+	if (dot == std::string::npos
+	    || (slash != std::string::npos && dot < slash)) {
+		name << output << "-" << num;
+	} else {
+		name << output.substr(0, dot) << "-" << num
+		     << output.substr(dot);
+	}
+	return name.str();
+}
+
+static int take_screenshot(Capture& capture, const std::string& output)
 {
-	Geometry gm = X11::getScreenGeometry();
-	XImage *ximage = X11::getImage(X11::getRoot(),
-				       gm.x, gm.y, gm.width, gm.height,
-				       AllPlanes, ZPixmap);
+	XImage *ximage = capture.grab();
 	if (ximage == nullptr) {
 		std::cerr << "Failed to take a screenshot" << std::endl;
 		return 1;
 	}
 
-	PImage *image = new PImage(ximage);
-	X11::destroyImage(ximage);
-
-	bool success =
-		PImageLoaderPng::save(output, image->getData(),
-				      image->getWidth(), image->getHeight());
+	XImageRowSource src(ximage);
+	const Geometry &gm = capture.getGeometry();
+	bool success = PImageLoaderPng::save(output, gm.width, gm.height, src,
+					     PNG_COMPRESSION_LEVEL);
 	return success ? 0 : 1;
 }
 
+/**
+ * Get geometry to capture, a region within the screen and/or a head.
+ */
+static bool get_capture_geometry(const std::string& geometry, int head,
+				 Geometry& gm)
+{
+	Geometry screen_gm = X11::getScreenGeometry();
+	gm = screen_gm;
+	if (head != -1 && ! X11::getHeadInfo(head, gm)) {
+		std::cerr << "invalid head " << head << std::endl;
+		return false;
+	}
+
+	if (! geometry.empty()) {
+		Geometry region;
+		int mask = X11::parseGeometry(geometry, region);
+		if (! (mask & WIDTH_VALUE) || ! (mask & HEIGHT_VALUE)
+		    || (mask & (X_NEGATIVE | Y_NEGATIVE | X_PERCENT
+				| Y_PERCENT | WIDTH_PERCENT
+				| HEIGHT_PERCENT))) {
+			std::cerr << "invalid geometry " << geometry
+				  << std::endl;
+			return false;
+		}
+		region.x = gm.x + ((mask & X_VALUE) ? region.x : 0);
+		region.y = gm.y + ((mask & Y_VALUE) ? region.y : 0);
+		gm = region;
+	}
+
+	if (gm.width == 0 || gm.height == 0
+	    || gm.x < screen_gm.x || gm.y < screen_gm.y
+	    || gm.x + gm.width > screen_gm.x + screen_gm.width
+	    || gm.y + gm.height > screen_gm.y + screen_gm.height) {
+		std::cerr << "geometry " << gm << " outside of screen"
+			  << std::endl;
+		return false;
+	}
+	return true;
+}
+
 int main(int argc, char* argv[])
 {
 	// Limit access, limit further after X11 connection is setup.
 	pledge_x11_required("");
 
 	const char* display = NULL;
+	std::string geometry;
+	int head = -1;
+	int interval_ms = 1000;
+	int repeat = 1;
 	int wait_seconds = 0;
 
 	static struct option opts[] = {
 		{const_cast<char*>("display"), required_argument, nullptr,
 		 'd'},
+		{const_cast<char*>("geometry"), required_argument, nullptr,
+		 'g'},
 		{const_cast<char*>("help"), no_argument, nullptr, 'h'},
+		{const_cast<char*>("head"), required_argument, nullptr, 'H'},
+		{const_cast<char*>("interval"), required_argument, nullptr,
+		 'i'},
+		{const_cast<char*>("repeat"), required_argument, nullptr, 'n'},
 		{const_cast<char*>("wait"), required_argument, nullptr, 'w'},
 		{nullptr, 0, nullptr, 0}
 	};
 
 	int ch;
-	while ((ch = getopt_long(argc, argv, "d:hw:", opts, nullptr)) != -1) {
+	while ((ch = getopt_long(argc, argv, "d:g:hH:i:n:w:", opts, nullptr))
+	       != -1) {
 		switch (ch) {
 		case 'd':
 			display = optarg;
 			break;
+		case 'g':
+			geometry = optarg;
+			break;
 		case 'h':
 			usage(argv[0], 0);
 			break;
+		case 'H':
+			try {
+				head = std::stoi(optarg);
+			} catch (std::invalid_argument&) {
+				usage(argv[0], 1);
+			}
+			break;
+		case 'i':
+			try {
+				interval_ms = std::stoi(optarg);
+			} catch (std::invalid_argument&) {
+				usage(argv[0], 1);
+			}
+			break;
+		case 'n':
+			try {
+				repeat = std::stoi(optarg);
+			} catch (std::invalid_argument&) {
+				usage(argv[0], 1);
+			}
+			if (repeat < 1) {
+				usage(argv[0], 1);
+			}
+			break;
 		case 'w':
 			try {
 				wait_seconds = std::stoi(optarg);
@@ -133,18 +464,19 @@ int main(int argc, char* argv[])
 		return 1;
 	}
 
+	Geometry gm;
+	if (! get_capture_geometry(geometry, head, gm)) {
+		X11::destruct();
+		return 1;
+	}
+	Capture *capture = new Capture(gm);
+	capture->initShm();
+
 	// X11 connection has been setup, limit access further
 	pledge_x("stdio rpath wpath cpath", "");
 
 	init(X11::getDpy());
 
-	std::string output;
-	if (optind < argc) {
-		output = argv[optind];
-	} else {
-		output = get_screenhot_name(X11::getScreenGeometry());
-	}
-
 	if (wait_seconds > 0) {
 		if (wait_seconds > 3) {
 			sleep(wait_seconds - 3);
@@ -157,14 +489,34 @@ int main(int argc, char* argv[])
 		std::cout << std::endl;
 	}
 
-	int ret = take_screenshot(output);
-	if (ret) {
-		std::cerr << "failed to write screenshot to " << output
-			  << std::endl;
-	} else {
-		std::cout << "screenshot written to " << output << std::endl;
+	int ret = 0;
+	for (int i = 1; ret == 0 && i <= repeat; i++) {
+		if (i > 1 && interval_ms > 0) {
+			struct timespec ts = {interval_ms / 1000,
+					      (interval_ms % 1000) * 1000000};
+			nanosleep(&ts, nullptr);
+		}
+
+		std::string output;
+		int num = repeat > 1 ? i : 0;
+		if (optind < argc) {
+			output = num ? get_repeat_name(argv[optind], num)
+				     : argv[optind];
+		} else {
+			output = get_screenhot_name(gm, num);
+		}
+
+		ret = take_screenshot(*capture, output);
+		if (ret) {
+			std::cerr << "failed to write screenshot to " << output
+				  << std::endl;
+		} else {
+			std::cout << "screenshot written to " << output
+				  << std::endl;
+		}
 	}
 
+	delete capture;
 	cleanup();
 	X11::destruct();
 
@@ -131,6 +131,7 @@ static Util::StringTo<std::pair<ActionType, uint> > action_map[] =
 	 {"Sys", action_pair(ACTION_SYS, ANY_MASK)},
 	 {"WmSet", action_pair(ACTION_WM_SET, ANY_MASK)},
 	 {nullptr, action_pair(ACTION_NO, 0)}};
+static Util::StringToIndex<action_pair> action_index(action_map);
 
 static Util::StringTo<ActionStateType> action_state_map[] =
 	{{"Maximized", ACTION_STATE_MAXIMIZED},
@@ -152,6 +153,8 @@ static Util::StringTo<ActionStateType> action_state_map[] =
 	 {"HarbourHidden", ACTION_STATE_HARBOUR_HIDDEN},
 	 {"GlobalGrouping", ACTION_STATE_GLOBAL_GROUPING},
 	 {nullptr, ACTION_STATE_NO}};
+static Util::StringToIndex<ActionStateType>
+	action_state_index(action_state_map);
 
 static Util::StringTo<BorderPosition> borderpos_map[] =
 	{{"TOPLEFT", BORDER_TOP_LEFT},
@@ -344,8 +347,7 @@ parseActionState(Action &action, const std::string &as_action)
 
 	// chop the string up separating the action and parameters
 	if (Util::splitString(as_action, tok, " \t", 2)) {
-		action.setParamI(0, Util::StringToGet(action_state_map,
-				 tok[0]));
+		action.setParamI(0, action_state_index.get(tok[0]));
 		if (action.getParamI(0) != ACTION_STATE_NO) {
 			if (tok.size() == 2) {
 				std::string directions;
@@ -653,6 +655,89 @@ ActionEvent::~ActionEvent()
 {
 }
 
+const size_t ActionEventIndex::npos = static_cast<size_t>(-1);
+
+ActionEventIndex::ActionEventIndex()
+{
+}
+
+ActionEventIndex::~ActionEventIndex()
+{
+}
+
+/**
+ * Add binding at pos to the index, positions must be added in increasing
+ * order as only the first binding for a key is kept.
+ */
+void
+ActionEventIndex::add(uint type, uint mod, uint sym, size_t pos)
+{
+	_index.insert(std::pair<Key, size_t>(Key(type, mod, sym), pos));
+}
+
+/**
+ * Find position of the first binding matching type, mod and sym.
+ *
+ * @return position of binding, npos if no binding matches.
+ */
+size_t
+ActionEventIndex::find(uint type, uint mod, uint sym) const
+{
+	size_t pos = findTier(Key(type, mod, sym), npos);
+	if (mod != MOD_ANY) {
+		pos = findTier(Key(type, MOD_ANY, sym), pos);
+	}
+	if (sym != 0) {
+		pos = findTier(Key(type, mod, 0), pos);
+		if (mod != MOD_ANY) {
+			pos = findTier(Key(type, MOD_ANY, 0), pos);
+		}
+	}
+	return pos;
+}
+
+size_t
+ActionEventIndex::findTier(const Key &key, size_t pos) const
+{
+	std::map<Key, size_t>::const_iterator it = _index.find(key);
+	if (it == _index.end() || it->second > pos) {
+		return pos;
+	}
+	return it->second;
+}
+
+ActionEventList::ActionEventList()
+{
+}
+
+ActionEventList::~ActionEventList()
+{
+}
+
+/**
+ * Rebuild the index from the current list content.
+ */
+void
+ActionEventList::updateIndex()
+{
+	_index.clear();
+	for (size_t i = 0; i < size(); i++) {
+		const ActionEvent &ae = (*this)[i];
+		_index.add(ae.type, ae.mod, ae.sym, i);
+	}
+}
+
+/**
+ * Find first binding matching type, mod and sym, falling back to bindings
+ * with MOD_ANY and BUTTON_ANY.
+ */
+ActionEvent*
+ActionEventList::find(uint type, uint mod, uint sym)
+{
+	size_t pos = _index.find(type, mod, sym);
+	return pos < size() ? &(*this)[pos] : nullptr;
+}
+
 namespace ActionConfig {
 
 	bool
@@ -829,7 +914,7 @@ namespace ActionConfig {
 	ActionType
 	getAction(const std::string &name, uint mask)
 	{
-		action_pair val = Util::StringToGet(action_map, name);
+		const action_pair &val = action_index.get(name);
 		if (val.second & mask) {
 			return val.first;
 		}
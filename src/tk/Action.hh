@@ -16,9 +16,10 @@
 #include "X11.hh"
 #include "pekwm_types.hh"
 
-#include <vector>
-#include <string>
 #include <cstring>
+#include <map>
+#include <string>
+#include <vector>
 
 class PWinObj;
 
@@ -300,6 +301,73 @@ public:
 	action_vector action_list;
 };
 
+/**
+ * Index of bindings keyed on (type, mod, sym) mapping to the position of
+ * the first binding with that key. MOD_ANY and a sym of 0 (BUTTON_ANY, any
+ * key) are looked up as separate fallback tiers and the earliest position
+ * of all tiers wins, giving the same result as a linear scan in order.
+ */
+class ActionEventIndex {
+public:
+	static const size_t npos;
+
+	ActionEventIndex();
+	~ActionEventIndex();
+
+	size_t size() const { return _index.size(); }
+
+	void clear() { _index.clear(); }
+	void add(uint type, uint mod, uint sym, size_t pos);
+	size_t find(uint type, uint mod, uint sym) const;
+
+private:
+	class Key {
+	public:
+		Key(uint type_, uint mod_, uint sym_)
+			: type(type_),
+			  mod(mod_),
+			  sym(sym_)
+		{
+		}
+
+		bool operator<(const Key &rhs) const
+		{
+			if (type != rhs.type) {
+				return type < rhs.type;
+			}
+			if (mod != rhs.mod) {
+				return mod < rhs.mod;
+			}
+			return sym < rhs.sym;
+		}
+
+		uint type;
+		uint mod;
+		uint sym;
+	};
+
+	size_t findTier(const Key &key, size_t pos) const;
+
+	std::map<Key, size_t> _index;
+};
+
+/**
+ * List of mouse bindings with an index for looking up the binding
+ * matching an event, updateIndex must be called after the list has been
+ * modified.
+ */
+class ActionEventList : public std::vector<ActionEvent> {
+public:
+	ActionEventList();
+	~ActionEventList();
+
+	void updateIndex();
+	ActionEvent *find(uint type, uint mod, uint sym);
+
+private:
+	ActionEventIndex _index;
+};
+
 class ActionPerformed {
 public:
 	ActionPerformed(PWinObj *w, const ActionEvent &a)
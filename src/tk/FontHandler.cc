@@ -11,6 +11,7 @@
 #include "Color.hh"
 #include "Debug.hh"
 #include "FontHandler.hh"
+#include "StartupProfile.hh"
 #include "ThemeUtil.hh"
 #include "Util.hh"
 #include "X11.hh"
@@ -95,6 +96,7 @@ FontHandler::getFont(const std::string &font)
 	}
 
 	// create new
+	StartupProfile::Scope profile("fonts");
 	PFont::Type type;
 	std::vector<std::string> tok;
 	PFont *pfont = newFont(font, tok, type);
@@ -0,0 +1,314 @@
+//
+// ImageCache.cc for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#include "Debug.hh"
+#include "ImageCache.hh"
+#include "Md5.hh"
+#include "PImage.hh"
+#include "Util.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+extern "C" {
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <unistd.h>
+}
+
+static const char CACHE_MAGIC[8] = {
+	'P', 'E', 'K', 'W', 'M', 'I', 'C', '1'
+};
+static const char CACHE_EXT[] = ".img";
+
+/**
+ * On disk format, native byte order as the cache is local to the host:
+ *
+ *   magic[8] width:uint32 height:uint32 use_alpha:uint32
+ *   width * height * ARGB data
+ */
+class CacheHeader {
+public:
+	char magic[8];
+	uint32_t width;
+	uint32_t height;
+	uint32_t use_alpha;
+};
+
+/**
+ * Cache entry found when pruning, ordered oldest first.
+ */
+class CacheEntry {
+public:
+	CacheEntry(time_t mtime_, size_t size_, const std::string &path_)
+		: mtime(mtime_),
+		  size(size_),
+		  path(path_)
+	{
+	}
+
+	bool operator<(const CacheEntry &rhs) const
+	{
+		if (mtime != rhs.mtime) {
+			return mtime < rhs.mtime;
+		}
+		return path < rhs.path;
+	}
+
+	time_t mtime;
+	size_t size;
+	std::string path;
+};
+
+/**
+ * Read/write size bytes, retrying on partial transfers.
+ */
+static bool
+readAll(int fd, void *buf, size_t size)
+{
+	char *p = static_cast<char*>(buf);
+	while (size > 0) {
+		ssize_t ret = read(fd, p, size);
+		if (ret <= 0) {
+			return false;
+		}
+		p += ret;
+		size -= ret;
+	}
+	return true;
+}
+
+static bool
+writeAll(int fd, const void *buf, size_t size)
+{
+	const char *p = static_cast<const char*>(buf);
+	while (size > 0) {
+		ssize_t ret = write(fd, p, size);
+		if (ret <= 0) {
+			return false;
+		}
+		p += ret;
+		size -= ret;
+	}
+	return true;
+}
+
+ImageCache::ImageCache(const std::string &dir, uint max_entries,
+		       size_t max_bytes, size_t max_image_bytes)
+	: _dir(dir),
+	  _max_entries(max_entries),
+	  _max_bytes(max_bytes),
+	  _max_image_bytes(max_image_bytes)
+{
+}
+
+ImageCache::~ImageCache()
+{
+}
+
+/**
+ * Load image from cache, returns nullptr if file is not in the cache
+ * or has been modified since it was cached.
+ */
+PImage*
+ImageCache::load(const std::string &file, float scale)
+{
+	std::string path;
+	if (! getPath(file, scale, path)) {
+		return nullptr;
+	}
+
+	int fd = open(path.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+	if (fd == -1) {
+		return nullptr;
+	}
+
+	uchar *data = nullptr;
+	CacheHeader header;
+	struct stat st;
+	if (fstat(fd, &st) == 0
+	    && st.st_uid == getuid()
+	    && readAll(fd, &header, sizeof(header))
+	    && memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0
+	    && header.width > 0 && header.height > 0
+	    && static_cast<uint64_t>(st.st_size)
+	       == sizeof(header)
+		  + static_cast<uint64_t>(header.width) * header.height * 4) {
+		size_t size = header.width * header.height * 4;
+		data = new uchar[size];
+		if (! readAll(fd, data, size)) {
+			delete [] data;
+			data = nullptr;
+		} else {
+			// pruning removes the oldest entries first, update
+			// the modification time to keep used entries.
+			futimens(fd, nullptr);
+		}
+	}
+	close(fd);
+
+	if (data == nullptr) {
+		P_DBG("invalid image cache entry " << path << " for " << file);
+		unlink(path.c_str());
+		return nullptr;
+	}
+	return new PImage(header.width, header.height, data,
+			  header.use_alpha != 0);
+}
+
+/**
+ * Save image data to the cache, written to a temporary file and renamed
+ * in place so other processes never read partial entries. Images larger
+ * than max image bytes are not cached.
+ */
+bool
+ImageCache::save(const std::string &file, float scale, PImage *image)
+{
+	std::string path;
+	size_t size = static_cast<size_t>(image->getWidth())
+		* image->getHeight() * 4;
+	if (image->getData() == nullptr
+	    || size > _max_image_bytes
+	    || ! getPath(file, scale, path)
+	    || ! mkdirs()) {
+		return false;
+	}
+
+	CacheHeader header;
+	memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	header.width = image->getWidth();
+	header.height = image->getHeight();
+	header.use_alpha = image->useAlpha() ? 1 : 0;
+
+	std::ostringstream tmp_path;
+	tmp_path << path << "." << getpid();
+	int fd = open(tmp_path.str().c_str(),
+		      O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC,
+		      0600);
+	if (fd == -1) {
+		P_DBG("failed to open image cache entry " << tmp_path.str());
+		return false;
+	}
+	bool ok = writeAll(fd, &header, sizeof(header))
+		&& writeAll(fd, image->getData(), size);
+	ok = close(fd) == 0 && ok;
+	if (ok) {
+		ok = rename(tmp_path.str().c_str(), path.c_str()) == 0;
+	}
+	if (! ok) {
+		P_DBG("failed to write image cache entry " << path);
+		unlink(tmp_path.str().c_str());
+		return false;
+	}
+
+	prune();
+	return true;
+}
+
+/**
+ * Get default cache directory, $XDG_CACHE_HOME/pekwm/images or
+ * ~/.cache/pekwm/images.
+ */
+std::string
+ImageCache::getDefaultDir()
+{
+	std::string dir = Util::getEnv("XDG_CACHE_HOME");
+	if (dir.empty()) {
+		dir = Util::getEnv("HOME");
+		if (dir.empty()) {
+			return "";
+		}
+		dir += "/.cache";
+	}
+	return dir + "/pekwm/images";
+}
+
+/**
+ * Get path of cache entry for file, false if the file does not exist.
+ */
+bool
+ImageCache::getPath(const std::string &file, float scale,
+		    std::string &path) const
+{
+	struct stat st;
+	if (_dir.empty() || stat(file.c_str(), &st) == -1) {
+		return false;
+	}
+
+	std::ostringstream key;
+	key << file << "\n" << st.st_mtime << "\n" << st.st_size
+	    << "\n" << scale;
+	path = _dir + "/" + Md5(key.str()).hexDigest() + CACHE_EXT;
+	return true;
+}
+
+/**
+ * Create cache directory, including missing parent directories.
+ */
+bool
+ImageCache::mkdirs() const
+{
+	std::string::size_type pos = 0;
+	while (pos != std::string::npos) {
+		pos = _dir.find('/', pos + 1);
+		std::string dir = _dir.substr(0, pos);
+		if (mkdir(dir.c_str(), 0700) == -1 && errno != EEXIST) {
+			P_DBG("failed to create image cache directory " << dir
+			      << ": " << strerror(errno));
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Remove the least recently used entries when the cache grows above max
+ * entries or max bytes, load updates the modification time on hits.
+ */
+void
+ImageCache::prune() const
+{
+	DIR *dh = opendir(_dir.c_str());
+	if (dh == nullptr) {
+		return;
+	}
+
+	std::vector<CacheEntry> entries;
+	size_t total = 0;
+	struct dirent *entry;
+	while ((entry = readdir(dh)) != nullptr) {
+		std::string name(entry->d_name);
+		if (! pekwm::ascii_ncase_equal(Util::getFileExt(name),
+					       CACHE_EXT + 1)) {
+			continue;
+		}
+		std::string path = _dir + "/" + name;
+		struct stat st;
+		if (stat(path.c_str(), &st) == 0) {
+			entries.push_back(CacheEntry(st.st_mtime, st.st_size,
+						     path));
+			total += st.st_size;
+		}
+	}
+	closedir(dh);
+
+	std::sort(entries.begin(), entries.end());
+	size_t num = entries.size();
+	std::vector<CacheEntry>::iterator it(entries.begin());
+	for (; it != entries.end()
+		     && (num > _max_entries || total > _max_bytes); ++it) {
+		unlink(it->path.c_str());
+		total -= it->size;
+		num--;
+	}
+}
@@ -0,0 +1,56 @@
+//
+// ImageCache.hh for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#ifndef _PEKWM_IMAGECACHE_HH_
+#define _PEKWM_IMAGECACHE_HH_
+
+#include "config.h"
+
+#include <string>
+
+class PImage;
+
+/**
+ * On disk cache of decoded, and scaled, image data shared between the
+ * pekwm tools. Entries are keyed on the Md5 of the image path, its
+ * modification time, size and the scale factor so modified images are
+ * never read from the cache.
+ */
+class ImageCache {
+public:
+	ImageCache(const std::string &dir, uint max_entries = 256,
+		   size_t max_bytes = 64 * 1024 * 1024,
+		   size_t max_image_bytes = 4 * 1024 * 1024);
+	~ImageCache();
+
+	const std::string &getDir() const { return _dir; }
+
+	PImage *load(const std::string &file, float scale);
+	bool save(const std::string &file, float scale, PImage *image);
+
+	static std::string getDefaultDir();
+
+private:
+	ImageCache(const ImageCache&);
+	ImageCache& operator=(const ImageCache&);
+
+	bool getPath(const std::string &file, float scale,
+		     std::string &path) const;
+	bool mkdirs() const;
+	void prune() const;
+
+	std::string _dir;
+	/** Number of entries kept in the cache directory. */
+	uint _max_entries;
+	/** Total size of entries kept in the cache directory. */
+	size_t _max_bytes;
+	/** Images with more data than this are not cached. */
+	size_t _max_image_bytes;
+};
+
+#endif // _PEKWM_IMAGECACHE_HH_
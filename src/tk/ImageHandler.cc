@@ -10,6 +10,7 @@
 
 #include "Debug.hh"
 #include "Exception.hh"
+#include "ImageCache.hh"
 #include "ImageHandler.hh"
 #include "PImage.hh"
 #include "Util.hh"
@@ -25,11 +26,12 @@ static Util::StringTo<ImageType> image_type_map[] =
 	 {nullptr, IMAGE_TYPE_NO}};
 
 ImageRefEntry::ImageRefEntry(float scale, const std::string& u_name,
-			     PImage* data)
+			     PImage* data, time_t mtime)
 	: _scale(scale),
 	  _u_name(u_name),
 	  _data(data),
-	  _ref(1)
+	  _ref(1),
+	  _mtime(mtime)
 {
 	assert(_data);
 }
@@ -56,7 +58,9 @@ ImageRefEntry::decRef(void)
 
 ImageHandler::ImageHandler(float scale)
 	: _default_type(IMAGE_TYPE_TILED),
-	  _scale(scale)
+	  _scale(scale),
+	  _cache(nullptr),
+	  _hold(0)
 {
 	clearColorMaps();
 }
@@ -77,6 +81,18 @@ ImageHandler::~ImageHandler()
 			_images.erase(it);
 		}
 	}
+	delete _cache;
+}
+
+/**
+ * Enable on disk cache of decoded images in dir, empty dir disables
+ * the cache.
+ */
+void
+ImageHandler::setCacheDir(const std::string &dir)
+{
+	delete _cache;
+	_cache = dir.empty() ? nullptr : new ImageCache(dir);
 }
 
 /**
@@ -85,16 +101,16 @@ ImageHandler::~ImageHandler()
 PImage*
 ImageHandler::getImage(const std::string &file)
 {
-	uint ref;
-	return getImage(file, ref, _images);
+	bool loaded;
+	return getImage(file, loaded, _images);
 }
 
 PImage*
-ImageHandler::getImage(const std::string &file, uint &ref,
+ImageHandler::getImage(const std::string &file, bool &loaded,
 		       std::vector<ImageRefEntry> &images)
 {
 	if (! file.size()) {
-		ref = 0;
+		loaded = false;
 		return nullptr;
 	}
 
@@ -109,13 +125,17 @@ ImageHandler::getImage(const std::string &file, uint &ref,
 					       file.substr(pos + 1));
 	}
 
+	// Scaled images are scaled when drawn, no need to scale on load.
+	float scale = image_type == IMAGE_TYPE_SCALED ? 1.0 : _scale;
+
 	// Load the image, try load paths if not an absolute image path
 	// already.
 	PImage *image = nullptr;
 	if (real_file[0] == '/') {
 		std::string u_real_file(real_file);
 		Util::to_upper(u_real_file);
-		image = getImageFromPath(real_file, u_real_file, ref, images);
+		image = getImageFromPath(real_file, u_real_file, scale,
+					 loaded, images);
 	} else {
 		std::vector<std::string>::reverse_iterator it =
 			_search_path.rbegin();
@@ -124,7 +144,7 @@ ImageHandler::getImage(const std::string &file, uint &ref,
 			std::string u_sp_real_file(sp_real_file);
 			Util::to_upper(u_sp_real_file);
 			image = getImageFromPath(sp_real_file, u_sp_real_file,
-						 ref, images);
+						 scale, loaded, images);
 			if (image) {
 				break;
 			}
@@ -133,9 +153,6 @@ ImageHandler::getImage(const std::string &file, uint &ref,
 
 	// Image was found, set correct type.
 	if (image) {
-		if (_scale != 1.0 && image_type != IMAGE_TYPE_SCALED) {
-			image->scale(_scale, PImage::SCALE_SQUARE);
-		}
 		image->setType(image_type);
 	}
 
@@ -144,6 +161,7 @@ ImageHandler::getImage(const std::string &file, uint &ref,
 
 /**
  * Load image from absolute path, checks cache for hit before loading.
+ * Loaded images are scaled by scale.
  *
  * @param file Path to image file.
  * @return PImage or 0 if fails.
@@ -151,29 +169,54 @@ ImageHandler::getImage(const std::string &file, uint &ref,
 PImage*
 ImageHandler::getImageFromPath(const std::string &file,
 			       const std::string &u_file,
-			       uint &ref,
+			       float scale, bool &loaded,
 			       std::vector<ImageRefEntry> &images)
 {
-	// Check cache for entry.
+	// Check cache for entry, held images without references are
+	// only re-used if the file has not been modified since loaded.
+	time_t mtime = 0;
 	std::vector<ImageRefEntry>::iterator it = images.begin();
 	for (; it != images.end(); ++it) {
-		if (it->getScale() == _scale && it->getUName() == u_file) {
-			ref = it->incRef();
-			return it->get();
+		if (it->getScale() != scale || it->getUName() != u_file) {
+			continue;
 		}
+		if (it->getRef() == 0) {
+			mtime = Util::getMtime(file);
+			if (mtime != it->getMtime()) {
+				delete it->get();
+				images.erase(it);
+				break;
+			}
+		}
+		// held images are re-used with a reference count of 1,
+		// they are already scaled and mapped.
+		it->incRef();
+		loaded = false;
+		return it->get();
 	}
 
-	// Try to load the image, setup cache only if it succeeds.
-	PImage *image;
-	try {
-		image = new PImage(file);
-		images.push_back(ImageRefEntry(_scale, u_file, image));
-		ref = 1;
-	} catch (LoadException&) {
-		image = nullptr;
-		ref = 0;
+	// Try to load the image, from the on disk cache if available,
+	// setup cache only if it succeeds.
+	if (mtime == 0) {
+		mtime = Util::getMtime(file);
 	}
-
+	PImage *image = _cache ? _cache->load(file, scale) : nullptr;
+	if (image == nullptr) {
+		try {
+			image = new PImage(file);
+		} catch (LoadException&) {
+			loaded = false;
+			return nullptr;
+		}
+		if (scale != 1.0) {
+			image->scale(scale, PImage::SCALE_SQUARE);
+		}
+		if (_cache) {
+			_cache->save(file, scale, image);
+		}
+	}
+	images.push_back(ImageRefEntry(scale, u_file, image, mtime));
+	loaded = true;
 	return image;
 }
 
@@ -186,6 +229,39 @@ ImageHandler::returnImage(PImage *image)
 	returnImage(image, _images);
 }
 
+/**
+ * Keep images that are no longer referenced in the cache until
+ * releaseImages is called, avoids decoding the same images again when
+ * a theme is re-loaded.
+ */
+void
+ImageHandler::holdImages(void)
+{
+	_hold++;
+}
+
+/**
+ * Release hold on images, unreferenced images are freed when the last
+ * hold is released.
+ */
+void
+ImageHandler::releaseImages(void)
+{
+	if (_hold == 0 || --_hold > 0) {
+		return;
+	}
+
+	std::vector<ImageRefEntry>::iterator it = _images.begin();
+	while (it != _images.end()) {
+		if (it->getRef() == 0) {
+			delete it->get();
+			it = _images.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
 /**
  * Take ownership ower image.
  */
@@ -217,9 +293,9 @@ ImageHandler::getMappedImage(const std::string &file,
 		_images_mapped[u_colormap] = std::vector<ImageRefEntry>();
 	}
 
-	uint ref;
-	PImage *image = getImage(file, ref, _images_mapped[u_colormap]);
-	if (ref == 1) {
+	bool loaded;
+	PImage *image = getImage(file, loaded, _images_mapped[u_colormap]);
+	if (loaded) {
 		// new image, requires color mapping.
 		mapColors(image, _color_maps[u_colormap]);
 	}
@@ -262,7 +338,8 @@ ImageHandler::returnImage(PImage *image,
 	std::vector<ImageRefEntry>::iterator it = images.begin();
 	for (; it != images.end(); ++it) {
 		if (it->get() == image) {
-			if (it->decRef() == 0) {
+			if (it->decRef() == 0
+			    && (_hold == 0 || &images != &_images)) {
 				delete it->get();
 				images.erase(it);
 			}
@@ -17,6 +17,11 @@
 #include <string>
 #include <vector>
 
+extern "C" {
+#include <time.h>
+}
+
+class ImageCache;
 class PImage;
 
 /**
@@ -25,7 +30,7 @@ class PImage;
 class ImageRefEntry {
 public:
 	ImageRefEntry(float scale, const std::string& u_name,
-		      PImage* data = nullptr);
+		      PImage* data = nullptr, time_t mtime = 0);
 	~ImageRefEntry(void);
 
 	PImage* get() { return _data; }
@@ -33,6 +38,7 @@ public:
 
 	float getScale() const { return _scale; }
 	const std::string& getUName() const { return _u_name; }
+	time_t getMtime() const { return _mtime; }
 
 	uint getRef(void) const { return _ref; }
 	uint incRef(void);
@@ -43,6 +49,8 @@ private:
 	std::string _u_name;
 	PImage* _data;
 	uint _ref;
+	/** Modification time of the image file when it was loaded. */
+	time_t _mtime;
 };
 
 /**
@@ -55,6 +63,7 @@ public:
 
 	void setDefaultType(ImageType type) { _default_type = type; }
 	void setScale(float scale) { _scale = scale; }
+	void setCacheDir(const std::string &dir);
 
 	/** Add path entry to the search path. */
 	void path_push_back(const std::string &path) {
@@ -72,6 +81,11 @@ public:
 	PImage *getImage(const std::string &file);
 	void returnImage(PImage *image);
 
+	void holdImages(void);
+	void releaseImages(void);
+	/** Number of loaded images, including held unreferenced images. */
+	size_t size(void) const { return _images.size(); }
+
 	void takeOwnership(PImage *image);
 
 	PImage *getMappedImage(const std::string &file,
@@ -83,27 +97,30 @@ public:
 			 const std::map<int,int>& color_map);
 
 private:
-	PImage *getImage(const std::string &file, uint &ref,
+	PImage *getImage(const std::string &file, bool &loaded,
 			 std::vector<ImageRefEntry> &images);
 	PImage *getImageFromPath(const std::string &file,
 				 const std::string &u_file,
-				 uint &ref,
+				 float scale, bool &loaded,
 				 std::vector<ImageRefEntry> &images);
 
 	void mapColors(PImage *image, const std::map<int,int> &color_map);
 
-	static void returnImage(PImage *image,
-				std::vector<ImageRefEntry> &images);
+	void returnImage(PImage *image, std::vector<ImageRefEntry> &images);
 private:
 	/** Default image type if none is specified */
 	ImageType _default_type;
 	/** != 1.0, images are scaled after loading by the given factor. */
 	float _scale;
+	/** On disk cache of decoded images, nullptr if disabled. */
+	ImageCache *_cache;
 
 	/** List of directories to search. */
 	std::vector<std::string> _search_path;
 	/** Loaded images. */
 	std::vector<ImageRefEntry> _images;
+	/** If > 0, unreferenced images are kept for re-use. */
+	uint _hold;
 	/** Loaded images with color mapped data. */
 	std::map<std::string, std::vector<ImageRefEntry> > _images_mapped;
 
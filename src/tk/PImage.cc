@@ -19,7 +19,9 @@
 #include "String.hh"
 #include "Util.hh"
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 extern "C" {
 #include <math.h>
@@ -261,6 +263,21 @@ PImage::PImage(PImage *image)
 	memcpy(_data, image->getData(), _width * _height * 4);
 }
 
+/**
+ * Create PImage from ARGB data, takes ownership of data.
+ */
+PImage::PImage(uint width, uint height, uchar *data, bool use_alpha)
+	: _type(IMAGE_TYPE_NO),
+	  _pixmap(None),
+	  _mask(None),
+	  _width(width),
+	  _height(height),
+	  _data(data),
+	  _use_alpha(use_alpha),
+	  _trans_pixel(0)
+{
+}
+
 /**
  * Create PImage from XImage.
  */
@@ -571,18 +588,132 @@ PImage::drawAlphaFixed(Render &rend, PSurface *surface, int x, int y,
 	rend.destroyImage(dest_image);
 }
 
+/**
+ * Get byte offset of the 8-bit channel in mask for 24/32 bit pixels.
+ *
+ * @return offset on success, -1 if mask is not an 8-bit channel.
+ */
+static int
+getChannelOffset(XImage *ximage, ulong mask)
+{
+	int shift;
+	if (mask == 0xff) {
+		shift = 0;
+	} else if (mask == 0xff00) {
+		shift = 1;
+	} else if (mask == 0xff0000) {
+		shift = 2;
+	} else {
+		return -1;
+	}
+	if (ximage->byte_order == LSBFirst) {
+		return shift;
+	}
+	return ximage->bits_per_pixel / 8 - 1 - shift;
+}
+
+/**
+ * Blend 8-bit channel value using integer math, computes
+ * (src * a + dst * (255 - a)) / 255 rounded.
+ */
+static inline uchar
+blendChannel(uint src, uint dst, uint a)
+{
+	uint val = src * a + dst * (255 - a) + 128;
+	return static_cast<uchar>((val + (val >> 8)) >> 8);
+}
+
+/**
+ * Blend ARGB data onto 24/32-bit TrueColor ZPixmap images working directly
+ * on the image data, avoiding the per pixel XGetPixel/XPutPixel calls.
+ *
+ * @return true if the images were supported and data got blended.
+ */
+static bool
+drawAlphaFixedTrueColor(XImage *src_image, XImage *dest_image,
+			uint width, uint height, const uchar* data)
+{
+	if (src_image->format != ZPixmap
+	    || dest_image->format != ZPixmap
+	    || (src_image->bits_per_pixel != 24
+		&& src_image->bits_per_pixel != 32)
+	    || src_image->bits_per_pixel != dest_image->bits_per_pixel
+	    || src_image->byte_order != dest_image->byte_order
+	    || src_image->red_mask != dest_image->red_mask
+	    || src_image->green_mask != dest_image->green_mask
+	    || src_image->blue_mask != dest_image->blue_mask) {
+		return false;
+	}
+
+	int r_off = getChannelOffset(src_image, src_image->red_mask);
+	int g_off = getChannelOffset(src_image, src_image->green_mask);
+	int b_off = getChannelOffset(src_image, src_image->blue_mask);
+	if (r_off == -1 || g_off == -1 || b_off == -1) {
+		return false;
+	}
+	// padding byte is cleared, matching XPutPixel with a RGB pixel
+	int pad_off = -1;
+	if (src_image->bits_per_pixel == 32) {
+		pad_off = src_image->byte_order == LSBFirst ? 3 : 0;
+	}
+	int bpp = src_image->bits_per_pixel / 8;
+
+	const uchar *src = data;
+	for (uint i_y = 0; i_y < height; ++i_y) {
+		const uchar *s_row = reinterpret_cast<uchar*>(src_image->data)
+			+ i_y * src_image->bytes_per_line;
+		uchar *d_row = reinterpret_cast<uchar*>(dest_image->data)
+			+ i_y * dest_image->bytes_per_line;
+		for (uint i_x = 0; i_x < width; ++i_x) {
+			uint a = src[0];
+			if (a == 255) {
+				d_row[r_off] = src[1];
+				d_row[g_off] = src[2];
+				d_row[b_off] = src[3];
+			} else if (a == 0) {
+				d_row[r_off] = s_row[r_off];
+				d_row[g_off] = s_row[g_off];
+				d_row[b_off] = s_row[b_off];
+			} else {
+				d_row[r_off] = blendChannel(src[1],
+							    s_row[r_off], a);
+				d_row[g_off] = blendChannel(src[2],
+							    s_row[g_off], a);
+				d_row[b_off] = blendChannel(src[3],
+							    s_row[b_off], a);
+			}
+			if (pad_off != -1) {
+				d_row[pad_off] = 0;
+			}
+
+			src += 4;
+			s_row += bpp;
+			d_row += bpp;
+		}
+	}
+	return true;
+}
+
 void
 PImage::drawAlphaFixed(XImage *src_image, XImage *dest_image,
 		       int x, int y, uint width, uint height, uchar* data)
 {
-	// Get mask from visual
+	// Get mask from visual, without a visual (no display) the masks
+	// already set on the images are used.
 	Visual *visual = X11::getVisual();
-	src_image->red_mask = visual->red_mask;
-	src_image->green_mask = visual->green_mask;
-	src_image->blue_mask = visual->blue_mask;
-	dest_image->red_mask = visual->red_mask;
-	dest_image->green_mask = visual->green_mask;
-	dest_image->blue_mask = visual->blue_mask;
+	if (visual) {
+		src_image->red_mask = visual->red_mask;
+		src_image->green_mask = visual->green_mask;
+		src_image->blue_mask = visual->blue_mask;
+		dest_image->red_mask = visual->red_mask;
+		dest_image->green_mask = visual->green_mask;
+		dest_image->blue_mask = visual->blue_mask;
+	}
+
+	if (drawAlphaFixedTrueColor(src_image, dest_image,
+				    width, height, data)) {
+		return;
+	}
 
 	pixelToRgb toRgb = getPixelToRgbFun(src_image);
 	rgbToPixel toPixel = getRgbToPixelFun(dest_image);
@@ -605,15 +736,9 @@ PImage::drawAlphaFixed(XImage *src_image, XImage *dest_image,
 				uchar d_r = 0, d_g = 0, d_b = 0;
 				toRgb(XGetPixel(src_image, i_x, i_y),
 				      d_r, d_g, d_b);
-
-				float a_percent = static_cast<float>(a) / 255;
-				float a_percent_inv = 1 - a_percent;
-				r = static_cast<uchar>((a_percent_inv * d_r)
-						       + (a_percent * r));
-				g = static_cast<uchar>((a_percent_inv * d_g)
-						       + (a_percent * g));
-				b = static_cast<uchar>((a_percent_inv * d_b)
-						       + (a_percent * b));
+				r = blendChannel(r, d_r, a);
+				g = blendChannel(g, d_g, a);
+				b = blendChannel(b, d_b, a);
 			}
 
 			XPutPixel(dest_image, i_x, i_y, toPixel(r, g, b));
@@ -621,7 +746,6 @@ PImage::drawAlphaFixed(XImage *src_image, XImage *dest_image,
 	}
 }
 
-
 /**
  * Draw image at position, not scaling.
  */
@@ -876,20 +1000,100 @@ PImage::createXImage(uchar* data, uint width, uint height)
 	return ximage;
 }
 
-static inline uchar
-scalePixel(const uchar* data, int pos, int width, float x_diff, float y_diff)
+/**
+ * Number of fraction bits used in scale weights.
+ */
+#define SCALE_WEIGHT_BITS 14
+#define SCALE_WEIGHT_ONE (1 << SCALE_WEIGHT_BITS)
+/**
+ * Number of fraction bits kept in the intermediate data between the
+ * horizontal and the vertical pass.
+ */
+#define SCALE_TMP_BITS 8
+
+/**
+ * Source positions and fixed point weights contributing to each of the
+ * destination pixels along one axis. Weights for each destination pixel
+ * sum up to SCALE_WEIGHT_ONE.
+ */
+class ScaleTaps {
+public:
+	ScaleTaps(uint src_size, uint dst_size);
+
+	/** Index of first tap for destination pixel, size dst_size + 1. */
+	std::vector<uint> first;
+	/** Source pixel for tap. */
+	std::vector<uint> pos;
+	/** Weight for tap. */
+	std::vector<uint> weight;
+
+private:
+	void addTap(uint src_pos, double weight);
+	void normalize(uint first_tap);
+};
+
+/**
+ * Compute taps, bilinear sampling is used unless scaling down to half the
+ * size or less where an area (box) filter is used to include all source
+ * pixels.
+ */
+ScaleTaps::ScaleTaps(uint src_size, uint dst_size)
 {
-	float p0 = data[pos];
-	float p1 = data[pos + 4];
-	float p2 = data[pos + width * 4];
-	float p3 = data[pos + 4 + width * 4];
-	float res = p0 * (1 - x_diff) * (1 - y_diff)
-		+ p1 * (x_diff) * (1 - y_diff)
-		+ p2 * (y_diff) * (1 - x_diff)
-		+ p3 * (x_diff * y_diff);
-	return static_cast<uchar>(res);
+	double ratio = static_cast<double>(src_size) / dst_size;
+	for (uint d = 0; d < dst_size; d++) {
+		uint first_tap = pos.size();
+		first.push_back(first_tap);
+
+		if (dst_size * 2 <= src_size) {
+			double start = d * ratio;
+			double end = (d + 1) * ratio;
+			uint s = static_cast<uint>(start);
+			for (; s < src_size && s < end; s++) {
+				double s_start = s;
+				double w = std::min(end, s_start + 1.0)
+					- std::max(start, s_start);
+				addTap(s, w / ratio);
+			}
+		} else {
+			double center = (d + 0.5) * ratio - 0.5;
+			center = std::max(0.0, std::min(center,
+							src_size - 1.0));
+			uint s = static_cast<uint>(center);
+			double frac = center - s;
+			addTap(s, 1.0 - frac);
+			if (s + 1 < src_size) {
+				addTap(s + 1, frac);
+			}
+		}
+		normalize(first_tap);
+	}
+	first.push_back(pos.size());
 }
 
+void
+ScaleTaps::addTap(uint src_pos, double w)
+{
+	pos.push_back(src_pos);
+	weight.push_back(static_cast<uint>(w * SCALE_WEIGHT_ONE + 0.5));
+}
+
+/**
+ * Make the weights sum up to SCALE_WEIGHT_ONE, adjusting for rounding
+ * errors on the largest weight.
+ */
+void
+ScaleTaps::normalize(uint first_tap)
+{
+	uint sum = 0;
+	uint max_tap = first_tap;
+	for (uint i = first_tap; i < weight.size(); i++) {
+		sum += weight[i];
+		if (weight[i] > weight[max_tap]) {
+			max_tap = i;
+		}
+	}
+	weight[max_tap] += SCALE_WEIGHT_ONE - sum;
+}
 
 /**
  * Scales image data and returns pointer to new data.
@@ -911,39 +1115,61 @@ PImage::getScaledData(uint dwidth, uint dheight, ScaleType type)
 	return getScaledDataSmooth(dwidth, dheight);
 }
 
+/**
+ * Scale image data using a separable filter, first scaling each row
+ * horizontally into intermediate data with extra precision and then
+ * scaling the columns of the intermediate data vertically.
+ */
 uchar*
 PImage::getScaledDataSmooth(uint dwidth, uint dheight)
 {
-	if (dwidth < 1 || dheight < 1) {
+	if (dwidth < 1 || dheight < 1 || _width < 1 || _height < 1) {
 		return nullptr;
 	}
 
-	uchar *scaled_data = new uchar[dwidth * dheight * 4] ;
-	float x_ratio = static_cast<float>(_width - 1) / dwidth ;
-	float y_ratio = static_cast<float>(_height - 1) / dheight;
+	ScaleTaps x_taps(_width, dwidth);
+	ScaleTaps y_taps(_height, dheight);
 
-	uint dst = 0 ;
-	for (uint dy = 0; dy < dheight; dy++) {
+	std::vector<ushort> tmp(dwidth * _height * 4);
+	ushort *tmp_dst = &tmp[0];
+	const uint tmp_round = 1 << (SCALE_WEIGHT_BITS - SCALE_TMP_BITS - 1);
+	for (uint sy = 0; sy < _height; sy++) {
+		const uchar *row = _data + sy * _width * 4;
 		for (uint dx = 0; dx < dwidth; dx++) {
-			uint sx = static_cast<uint>(x_ratio * dx);
-			uint sy = static_cast<uint>(y_ratio * dy);
-
-			int spos = (sy * _width + sx) * 4;
-			float x_diff = (x_ratio * dx) - sx;
-			float y_diff = (y_ratio * dy) - sy;
-
-			scaled_data[dst++] =
-				scalePixel(_data, spos, _width,
-					   x_diff, y_diff); // A
-			scaled_data[dst++] =
-				scalePixel(_data + 1, spos, _width,
-					   x_diff, y_diff); // R
-			scaled_data[dst++] =
-				scalePixel(_data + 2, spos, _width,
-					   x_diff, y_diff); // G
-			scaled_data[dst++] =
-				scalePixel(_data + 3, spos, _width,
-					   x_diff, y_diff); // B
+			uint a = tmp_round, r = tmp_round;
+			uint g = tmp_round, b = tmp_round;
+			for (uint t = x_taps.first[dx];
+			     t < x_taps.first[dx + 1]; t++) {
+				const uchar *p = row + x_taps.pos[t] * 4;
+				uint w = x_taps.weight[t];
+				a += p[0] * w;
+				r += p[1] * w;
+				g += p[2] * w;
+				b += p[3] * w;
+			}
+			*tmp_dst++ = a >> (SCALE_WEIGHT_BITS - SCALE_TMP_BITS);
+			*tmp_dst++ = r >> (SCALE_WEIGHT_BITS - SCALE_TMP_BITS);
+			*tmp_dst++ = g >> (SCALE_WEIGHT_BITS - SCALE_TMP_BITS);
+			*tmp_dst++ = b >> (SCALE_WEIGHT_BITS - SCALE_TMP_BITS);
+		}
+	}
+
+	uchar *scaled_data = new uchar[dwidth * dheight * 4];
+	uchar *dst = scaled_data;
+	const uint shift = SCALE_WEIGHT_BITS + SCALE_TMP_BITS;
+	const uint dst_round = 1 << (shift - 1);
+	std::vector<uint> acc(dwidth * 4);
+	for (uint dy = 0; dy < dheight; dy++) {
+		std::fill(acc.begin(), acc.end(), dst_round);
+		for (uint t = y_taps.first[dy]; t < y_taps.first[dy + 1]; t++) {
+			const ushort *src = &tmp[y_taps.pos[t] * dwidth * 4];
+			uint w = y_taps.weight[t];
+			for (uint i = 0; i < dwidth * 4; i++) {
+				acc[i] += src[i] * w;
+			}
+		}
+		for (uint i = 0; i < dwidth * 4; i++) {
+			*dst++ = std::min(acc[i] >> shift, 255u);
 		}
 	}
 
@@ -28,6 +28,7 @@ public:
 	PImage(const std::string &path);
 	PImage(PImage *image);
 	PImage(XImage *image, uchar opacity=255, ulong *trans_pixel=nullptr);
+	PImage(uint width, uint height, uchar *data, bool use_alpha);
 	virtual ~PImage();
 
 	//! @brief Returns type of image.
@@ -40,6 +41,8 @@ public:
 	inline uint getWidth(void) const { return _width; }
 	//! @brief Returns height of image.
 	inline uint getHeight(void) const { return _height; }
+	//! @brief Returns true if image data has non-opaque pixels.
+	inline bool useAlpha(void) const { return _use_alpha; }
 
 	bool load(const std::string &file);
 	void unload(void);
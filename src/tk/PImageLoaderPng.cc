@@ -57,21 +57,33 @@ convertRgbToArgb(const uchar* data_rgb, uint width, uint height)
 	return data_argb;
 }
 
-static uchar*
-convertArgbToRgb(const uchar* data_argb, uint width, uint height)
-{
-	uchar *data_rgb = new uchar[width * height * 4];
-	int src = 0, dst = 0;
-	for (uint y = 0; y < height; ++y) {
-		for (uint x = 0; x < width; ++x) {
+/**
+ * RowSource converting rows of ARGB data to RGB.
+ */
+class ArgbRowSource : public PImageLoaderPng::RowSource {
+public:
+	ArgbRowSource(const uchar *data, uint width)
+		: _data(data),
+		  _width(width)
+	{
+	}
+	virtual ~ArgbRowSource() { }
+
+	virtual void getRow(uint y, uchar *rgb)
+	{
+		const uchar *src = _data + y * _width * 4;
+		for (uint x = 0; x < _width; ++x) {
 			src++; // A
-			data_rgb[dst++] = data_argb[src++]; // R
-			data_rgb[dst++] = data_argb[src++]; // G
-			data_rgb[dst++] = data_argb[src++]; // B
+			*rgb++ = *src++; // R
+			*rgb++ = *src++; // G
+			*rgb++ = *src++; // B
 		}
 	}
-	return data_rgb;
-}
+
+private:
+	const uchar *_data;
+	uint _width;
+};
 
 
 /**
@@ -226,6 +238,20 @@ namespace PImageLoaderPng
 
 	bool
 	save(const std::string& file, uchar *data, uint width, uint height)
+	{
+		ArgbRowSource src(data, width);
+		return save(file, width, height, src);
+	}
+
+	/**
+	 * Save 24bit RGB image to file, converting and writing a single
+	 * row at the time.
+	 *
+	 * @param level zlib compression level, -1 for the default.
+	 */
+	bool
+	save(const std::string& file, uint width, uint height,
+	     RowSource &src, int level)
 	{
 		png_structp png_ptr =
 			png_create_write_struct(PNG_LIBPNG_VER_STRING,
@@ -242,20 +268,28 @@ namespace PImageLoaderPng
 			return false;
 		}
 
-		// Setup png lib error handling
-		if (setjmp(png_jmpbuf(png_ptr))) {
+		FILE *fp = fopen(file.c_str(), "wb");
+		if (!fp) {
+			USER_WARN("failed to open " << file << " for writing");
 			png_destroy_write_struct(&png_ptr, &info_ptr);
 			return false;
 		}
 
-		FILE *fp = fopen(file.c_str(), "wb");
-		if (!fp) {
-			USER_WARN("failed to open " << file << " for writing");
+		// allocated before setjmp, freed on both paths below.
+		png_bytep row = new png_byte[width * 3];
+
+		// Setup png lib error handling
+		if (setjmp(png_jmpbuf(png_ptr))) {
+			delete [] row;
 			png_destroy_write_struct(&png_ptr, &info_ptr);
+			fclose(fp);
 			return false;
 		}
 
 		png_init_io(png_ptr, fp);
+		if (level != -1) {
+			png_set_compression_level(png_ptr, level);
+		}
 
 		// Setup write information, write 24bit RGB
 		png_set_IHDR(png_ptr, info_ptr, width, height, 8,
@@ -264,21 +298,17 @@ namespace PImageLoaderPng
 			     PNG_COMPRESSION_TYPE_DEFAULT,
 			     PNG_FILTER_TYPE_DEFAULT);
 
-		uchar *rgb_data = convertArgbToRgb(data, width, height);
 		png_write_info(png_ptr, info_ptr);
-		png_bytep row = rgb_data;
 		for (uint y = 0; y < height; y++) {
+			src.getRow(y, row);
 			png_write_row(png_ptr, row);
-			row += width * 3;
 		}
 		png_write_end(png_ptr, NULL);
 
-		delete [] rgb_data;
+		delete [] row;
 
 		png_destroy_write_struct(&png_ptr, &info_ptr);
-		fclose(fp);
-
-		return true;
+		return fclose(fp) == 0;
 	}
 }
 
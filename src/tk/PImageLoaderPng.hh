@@ -22,12 +22,25 @@
  */
 namespace PImageLoaderPng
 {
+	/**
+	 * Source of image rows for streaming save, rows are requested
+	 * top to bottom.
+	 */
+	class RowSource {
+	public:
+		virtual ~RowSource() { }
+		/** Fill rgb with width * 3 bytes of data for row y. */
+		virtual void getRow(uint y, uchar *rgb) = 0;
+	};
+
 	const char *getExt(void);
 
 	uchar* load(const std::string &file, uint &width, uint &height,
 		    bool &use_alpha);
 	bool save(const std::string &file,
 		  uchar *data, uint width, uint height);
+	bool save(const std::string &file, uint width, uint height,
+		  RowSource &src, int level = -1);
 }
 
 #endif // PEKWM_HAVE_IMAGE_PNG
@@ -0,0 +1,176 @@
+//
+// StartupProfile.cc for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#include "StartupProfile.hh"
+
+#include <iomanip>
+#include <string>
+#include <vector>
+
+class ProfileEntry {
+public:
+	ProfileEntry(const char *name_)
+		: name(name_),
+		  ms(0.0),
+		  calls(0)
+	{
+	}
+
+	std::string name;
+	double ms;
+	uint calls;
+};
+
+static bool _enabled = false;
+static std::vector<ProfileEntry> _phases;
+static std::vector<ProfileEntry> _counters;
+/** Start of the current phase, tv_sec -1 if no phase is active. */
+static struct timespec _phase_start = { -1, 0 };
+
+static double
+elapsedMs(const struct timespec &start)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start.tv_sec) * 1000.0
+		+ (now.tv_nsec - start.tv_nsec) / 1000000.0;
+}
+
+static void
+reportEntries(std::ostream &os, const std::vector<ProfileEntry> &entries,
+	      bool calls)
+{
+	std::vector<ProfileEntry>::const_iterator it = entries.begin();
+	for (; it != entries.end(); ++it) {
+		os << "  " << std::left << std::setw(16) << it->name
+		   << std::right << std::setw(10) << it->ms << " ms";
+		if (calls) {
+			os << " (" << it->calls << " calls)";
+		}
+		os << std::endl;
+	}
+}
+
+namespace StartupProfile {
+
+	void
+	setEnabled(bool enabled)
+	{
+		_enabled = enabled;
+	}
+
+	bool
+	isEnabled(void)
+	{
+		return _enabled;
+	}
+
+	void
+	clear(void)
+	{
+		_phases.clear();
+		_counters.clear();
+		_phase_start.tv_sec = -1;
+	}
+
+	/**
+	 * End the current phase, if any, and start timing phase name.
+	 */
+	void
+	phase(const char *name)
+	{
+		if (! _enabled) {
+			return;
+		}
+		end();
+		_phases.push_back(ProfileEntry(name));
+		clock_gettime(CLOCK_MONOTONIC, &_phase_start);
+	}
+
+	/**
+	 * End the current phase.
+	 */
+	void
+	end(void)
+	{
+		if (! _enabled || _phase_start.tv_sec == -1) {
+			return;
+		}
+		_phases.back().ms = elapsedMs(_phase_start);
+		_phases.back().calls = 1;
+		_phase_start.tv_sec = -1;
+	}
+
+	/**
+	 * Add time elapsed since start to the counter name.
+	 */
+	void
+	count(const char *name, const struct timespec &start)
+	{
+		if (! _enabled) {
+			return;
+		}
+
+		double ms = elapsedMs(start);
+		std::vector<ProfileEntry>::iterator it = _counters.begin();
+		for (; it != _counters.end(); ++it) {
+			if (it->name == name) {
+				break;
+			}
+		}
+		if (it == _counters.end()) {
+			_counters.push_back(ProfileEntry(name));
+			it = _counters.end() - 1;
+		}
+		it->ms += ms;
+		it->calls++;
+	}
+
+	void
+	report(std::ostream &os)
+	{
+		double total = 0.0;
+		std::vector<ProfileEntry>::const_iterator it = _phases.begin();
+		for (; it != _phases.end(); ++it) {
+			total += it->ms;
+		}
+
+		std::ios::fmtflags flags = os.flags();
+		std::streamsize precision = os.precision();
+		os << std::fixed << std::setprecision(2);
+
+		os << "startup profile, phases:" << std::endl;
+		reportEntries(os, _phases, false);
+		os << "  " << std::left << std::setw(16) << "total"
+		   << std::right << std::setw(10) << total << " ms"
+		   << std::endl;
+		if (! _counters.empty()) {
+			os << "startup profile, counters:" << std::endl;
+			reportEntries(os, _counters, true);
+		}
+
+		os.flags(flags);
+		os.precision(precision);
+	}
+
+	Scope::Scope(const char *name)
+		: _name(name)
+	{
+		if (_enabled) {
+			clock_gettime(CLOCK_MONOTONIC, &_start);
+		}
+	}
+
+	Scope::~Scope(void)
+	{
+		if (_enabled) {
+			count(_name, _start);
+		}
+	}
+
+}
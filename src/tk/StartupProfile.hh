@@ -0,0 +1,51 @@
+//
+// StartupProfile.hh for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#ifndef _PEKWM_STARTUP_PROFILE_HH_
+#define _PEKWM_STARTUP_PROFILE_HH_
+
+#include "Compat.hh"
+#include "Types.hh"
+
+#include <ostream>
+
+extern "C" {
+#include <time.h>
+}
+
+/**
+ * Timing of startup phases, enabled with --profile-startup. Phases are
+ * sequential and cover the whole startup, counters accumulate time
+ * spent in work spread out over several phases such as font loading.
+ */
+namespace StartupProfile {
+	void setEnabled(bool enabled);
+	bool isEnabled(void);
+	void clear(void);
+
+	void phase(const char *name);
+	void end(void);
+	void count(const char *name, const struct timespec &start);
+
+	void report(std::ostream &os);
+
+	/**
+	 * Add time spent in scope to the named counter.
+	 */
+	class Scope {
+	public:
+		Scope(const char *name);
+		~Scope(void);
+
+	private:
+		const char *_name;
+		struct timespec _start;
+	};
+}
+
+#endif // _PEKWM_STARTUP_PROFILE_HH_
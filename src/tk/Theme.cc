@@ -1262,6 +1262,9 @@ Theme::load(const std::string &dir, const std::string &variant, bool force)
 		return false;
 	}
 
+	// Keep images while re-loading, images used by both the old and
+	// new theme are not decoded again.
+	_ih->holdImages();
 	unload();
 
 	_theme_dir = norm_dir;
@@ -1337,6 +1340,7 @@ Theme::load(const std::string &dir, const std::string &variant, bool force)
 	}
 
 	_loaded = true;
+	_ih->releaseImages();
 	_th->logTextures("theme loaded");
 
 	return true;
@@ -605,7 +605,7 @@ ActionHandler::checkAEThreshold(int x, int y, int x_t, int y_t, uint t)
 //! @brief Searches the actions list for an matching event
 ActionEvent*
 ActionHandler::findMouseAction(uint button, uint state, MouseEventType type,
-			       std::vector<ActionEvent> *actions)
+			       ActionEventList *actions)
 {
 	if (! actions) {
 		return 0;
@@ -614,16 +614,7 @@ ActionHandler::findMouseAction(uint button, uint state, MouseEventType type,
 	X11::stripStateModifiers(&state);
 	X11::stripButtonModifiers(&state);
 
-	std::vector<ActionEvent>::iterator it = actions->begin();
-	for (; it != actions->end(); ++it) {
-		if ((it->type == unsigned(type))
-		    && ((it->mod == MOD_ANY) || (it->mod == state))
-		    && ((it->sym == BUTTON_ANY) || (it->sym == button))) {
-			return &*it;
-		}
-	}
-
-	return 0;
+	return actions->find(type, state, button);
 }
 
 /**
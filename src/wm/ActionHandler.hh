@@ -39,7 +39,10 @@ public:
 	static bool checkAEThreshold(int x, int y, int x_t, int y_t, uint t);
 	static ActionEvent *findMouseAction(uint button, uint mod,
 					    MouseEventType type,
-					    std::vector<ActionEvent> *actions);
+					    ActionEventList *actions);
+
+	EventLoop *getEventLoop() const { return _event_loop; }
+	Os *getOs() const { return _os; }
 
 	void setSysProcess(ChildProcess *sys_process)
 	{
@@ -1,6 +1,6 @@
 //
 // ActionMenu.cc for pekwm
-// Copyright (C) 2002-2023 Claes Nästén <pekdon@gmail.com>
+// Copyright (C) 2002-2025 Claes Nästén <pekdon@gmail.com>
 //
 // This program is licensed under the GNU GPL.
 // See the LICENSE file for more information.
@@ -9,6 +9,7 @@
 #include "config.h"
 
 #include <cstdio>
+#include <cstdlib>
 #include <set>
 
 #include "Charset.hh"
@@ -68,7 +69,7 @@ ActionMenu::mapWindow(void)
 	// find and rebuild the dynamic entries
 	if (! isMapped() && _has_dynamic) {
 		uint size_before = size();
-		if (size_before != rebuildDynamic()) {
+		if (size_before != rebuildDynamic(true)) {
 			buildMenu();
 		}
 	}
@@ -182,6 +183,13 @@ ActionMenu::remove(PMenu::Item *item)
 		delete item->getWORef();
 	}
 
+	std::map<PMenu::Item*, DynamicCommand*>::iterator it =
+		_dynamic.find(item);
+	if (it != _dynamic.end()) {
+		delete it->second;
+		_dynamic.erase(it);
+	}
+
 	PMenu::remove(item);
 }
 
@@ -282,6 +290,25 @@ ActionMenu::parseItem(CfgParser::Entry* section, PMenu::Item* parent)
 		if (ae.isOnlyAction(ACTION_MENU_DYN)) {
 			_has_dynamic = true;
 			item->setType(PMenu::Item::MENU_ITEM_HIDDEN);
+
+			// seconds to re-use output without running the
+			// command again.
+			int ttl = 0;
+			value = section->findEntry("TTL");
+			if (value) {
+				ttl = atoi(value->getValue().c_str());
+			}
+
+			const std::string &command =
+				ae.action_list.front().getParamS();
+			DynamicCommand *cmd =
+				new DynamicCommand(_act->getOs(),
+						   _act->getEventLoop(),
+						   command,
+						   pekwm::configScriptPath(),
+						   std::max(ttl, 0));
+			cmd->setListener(this);
+			_dynamic[item] = cmd;
 		}
 	}
 	return item;
@@ -315,53 +342,103 @@ ActionMenu::getIcon(CfgParser::Entry *value)
 }
 
 /**
- * Executes all Dynamic entries in the menu.
+ * Insert the output of all Dynamic entries in the menu. The commands run
+ * in the background, the previous output is used until they complete.
+ *
+ * @param run_expired Run commands with output older than their TTL.
  */
 uint
-ActionMenu::rebuildDynamic(void)
+ActionMenu::rebuildDynamic(bool run_expired)
 {
-	PWinObj *wo_ref = getWORef();
-
-	// Export environment before to dynamic script.
-	Client *client = 0;
-	if (wo_ref && wo_ref->getType() == WO_CLIENT) {
-		client = static_cast<Client*>(wo_ref);
+	if (run_expired) {
+		// Export environment before to dynamic script.
+		PWinObj *wo_ref = getWORef();
+		Client *client = 0;
+		if (wo_ref && wo_ref->getType() == WO_CLIENT) {
+			client = static_cast<Client*>(wo_ref);
+		}
+		Client::setClientEnvironment(client);
 	}
-	Client::setClientEnvironment(client);
 
 	// Setup icon path before parsing.
 	WithIconPath with_icon_path(pekwm::config(), pekwm::imageHandler());
 
+	time_t now = time(nullptr);
 	std::vector<PMenu::Item*>::const_iterator it = m_begin();
 	for (; it != m_end(); ++it) {
-		if ((*it)->getAE().isOnlyAction(ACTION_MENU_DYN)) {
-			_insert_at = it - m_begin();
-
-			PMenu::Item* item = *it;
+		std::map<PMenu::Item*, DynamicCommand*>::iterator dyn_it =
+			_dynamic.find(*it);
+		if (dyn_it == _dynamic.end()) {
+			continue;
+		}
 
-			CfgParser dynamic(pekwm::configScriptPath());
-			std::string cmd =
-				(*it)->getAE().action_list.front().getParamS();
-			CfgParser::Entry *section = runDynamic(dynamic, cmd);
-			if (section != nullptr) {
-				_has_dynamic = true;
-				parse(section, *it);
-			}
+		_insert_at = it - m_begin();
 
-			it = std::find(m_begin(), m_end(), item);
+		PMenu::Item* item = *it;
+		DynamicCommand *cmd = dyn_it->second;
+		if (run_expired && cmd->isExpired(now)) {
+			cmd->run();
 		}
+		insertDynamic(item, cmd);
+
+		it = std::find(m_begin(), m_end(), item);
 	}
 	_insert_at = size();
 	return _insert_at;
 }
 
-CfgParser::Entry*
-ActionMenu::runDynamic(CfgParser& parser, const std::string& src)
+/**
+ * Insert items from the last output of cmd, a placeholder is inserted if
+ * the command is yet to complete.
+ */
+void
+ActionMenu::insertDynamic(PMenu::Item *item, DynamicCommand *cmd)
+{
+	if (cmd->hasOutput()) {
+		CfgParser dynamic(pekwm::configScriptPath());
+		if (dynamic.parse(cmd->getOutput(),
+				  CfgParserSource::SOURCE_STRING)) {
+			CfgParser::Entry *section =
+				dynamic.getEntryRoot()->findSection("DYNAMIC");
+			if (section != nullptr) {
+				parse(section, item);
+			}
+		}
+	} else if (cmd->isRunning()) {
+		PMenu::Item *loading = new PMenu::Item("...", false);
+		loading->setCreator(item);
+		insert(loading);
+	}
+}
+
+/**
+ * Swap in the new output of cmd if the menu is visible, if it is not
+ * the output is used the next time the menu is mapped.
+ */
+void
+ActionMenu::dynamicCommandDone(DynamicCommand*)
+{
+	// avoid removing an open submenu below the pointer
+	if (! isMapped() || isSubmenuMapped()) {
+		return;
+	}
+
+	removeDynamic();
+	rebuildDynamic(false);
+	buildMenu();
+}
+
+bool
+ActionMenu::isSubmenuMapped(void)
 {
-	if (parser.parse(src, CfgParserSource::SOURCE_COMMAND)) {
-		return parser.getEntryRoot()->findSection("DYNAMIC");
+	std::vector<PMenu::Item*>::const_iterator it = m_begin();
+	for (; it != m_end(); ++it) {
+		PWinObj *wo = (*it)->getWORef();
+		if (wo && wo->getType() == WO_MENU && wo->isMapped()) {
+			return true;
+		}
 	}
-	return nullptr;
+	return false;
 }
 
 //! @brief Remove all entries from the menu created by dynamic entries.
@@ -1,6 +1,6 @@
 //
 // ActionMenu.hh for pekwm
-// Copyright (C) 2002-2023 Claes Nästén <pekdon@gmail.com>
+// Copyright (C) 2002-2025 Claes Nästén <pekdon@gmail.com>
 //
 // This program is licensed under the GNU GPL.
 // See the LICENSE file for more information.
@@ -13,15 +13,18 @@
 
 #include "pekwm.hh"
 #include "CfgParser.hh"
+#include "DynamicCommand.hh"
 #include "WORefMenu.hh"
 
 #include "tk/Action.hh" // For ActionOk
 
+#include <map>
 #include <string>
 
 class ActionHandler;
 
-class ActionMenu : public WORefMenu
+class ActionMenu : public WORefMenu,
+		   public DynamicCommand::Listener
 {
 public:
 	ActionMenu(MenuType type, ActionHandler *act,
@@ -52,12 +55,15 @@ public:
 	virtual void remove(PMenu::Item *item);
 	virtual void removeAll(void);
 
+	// START - DynamicCommand::Listener interface.
+	virtual void dynamicCommandDone(DynamicCommand *cmd);
+	// END - DynamicCommand::Listener interface.
+
 protected:
-	uint rebuildDynamic(void);
+	uint rebuildDynamic(bool run_expired);
 	void removeDynamic(void);
-
-	virtual CfgParser::Entry* runDynamic(CfgParser& parser,
-					     const std::string& src);
+	void insertDynamic(PMenu::Item *item, DynamicCommand *cmd);
+	bool isSubmenuMapped(void);
 
 private:
 	void parse(CfgParser::Entry *section, PMenu::Item *parent=0);
@@ -75,6 +81,8 @@ private:
 
 	/** Set to true if any of the entries in the menu is dynamic. */
 	bool _has_dynamic;
+	/** Command, with cached output, for each of the dynamic entries. */
+	std::map<PMenu::Item*, DynamicCommand*> _dynamic;
 };
 
 #endif // _PEKWM_ACTIONMENU_HH_
@@ -19,6 +19,11 @@
 #include "tk/ImageHandler.hh"
 #include "tk/TkGlobals.hh"
 
+#include <algorithm>
+
+/** Number of ClassHint results cached by a PropertyMatcher. */
+static const size_t MATCH_CACHE_MAX_SIZE = 256;
+
 static Util::StringTo<ApplyOn> apply_on_map[] =
 	{{"START", APPLY_ON_START},
 	 {"NEW", APPLY_ON_NEW},
@@ -54,6 +59,7 @@ static Util::StringTo<PropertyType> property_map[] =
 	 {"ICON", AP_ICON},
 	 {"PLACEMENT", AP_PLACEMENT},
 	 {nullptr, AP_NO_PROPERTY}};
+static Util::StringToIndex<PropertyType> property_index(property_map);
 
 static Util::StringTo<PropertyType> group_property_map[] =
 	{{"SIZE", AP_GROUP_SIZE},
@@ -129,10 +135,137 @@ AutoProperty::~AutoProperty(void)
 	}
 }
 
+PropertyMatcher::PropertyMatcher(const std::vector<Property*> &props)
+	: _props(props)
+{
+}
+
+PropertyMatcher::~PropertyMatcher()
+{
+}
+
+/**
+ * Re-build the index from the property list, must be called whenever the
+ * list is changed.
+ */
+void
+PropertyMatcher::update()
+{
+	_name_exact.clear();
+	_name_prefix.clear();
+	_class_exact.clear();
+	_class_prefix.clear();
+	_other.clear();
+	_cache.clear();
+
+	for (size_t i = 0; i < _props.size(); i++) {
+		Property *prop = _props[i];
+		if (! add(prop->getHintName(), i, _name_exact, _name_prefix)
+		    && ! add(prop->getHintClass(), i,
+			     _class_exact, _class_prefix)) {
+			_other.push_back(i);
+		}
+	}
+}
+
+/**
+ * Get all properties matching hint, in list order.
+ */
+const std::vector<Property*>&
+PropertyMatcher::match(const ClassHint &hint)
+{
+	std::string key(hint.h_name);
+	key += '\0';
+	key += hint.h_class;
+	key += '\0';
+	key += hint.h_role;
+	key += '\0';
+	key += hint.title;
+
+	std::map<std::string, std::vector<Property*> >::iterator it =
+		_cache.find(key);
+	if (it != _cache.end()) {
+		return it->second;
+	}
+
+	std::vector<size_t> pos(_other);
+	lookup(_name_exact, hint.h_name, pos);
+	lookupPrefix(_name_prefix, hint.h_name, pos);
+	lookup(_class_exact, hint.h_class, pos);
+	lookupPrefix(_class_prefix, hint.h_class, pos);
+	std::sort(pos.begin(), pos.end());
+
+	if (_cache.size() >= MATCH_CACHE_MAX_SIZE) {
+		_cache.clear();
+	}
+	std::vector<Property*> &props = _cache[key];
+	std::vector<size_t>::iterator pit = pos.begin();
+	for (; pit != pos.end(); ++pit) {
+		if (AutoProperties::matchAutoClass(hint, _props[*pit])) {
+			props.push_back(_props[*pit]);
+		}
+	}
+	return props;
+}
+
+/**
+ * Add property at pos to the exact or prefix index if regex is a
+ * non-inverted literal match.
+ *
+ * @return true if added to an index.
+ */
+bool
+PropertyMatcher::add(RegexString &regex, size_t pos,
+		     index_map &exact, index_map &prefix)
+{
+	if (! regex.is_match_ok() || regex.isInverted()) {
+		return false;
+	}
+	switch (regex.getMatchType()) {
+	case RegexString::MATCH_EXACT:
+		exact[regex.getLiteral()].push_back(pos);
+		return true;
+	case RegexString::MATCH_PREFIX:
+		prefix[regex.getLiteral()].push_back(pos);
+		return true;
+	default:
+		return false;
+	}
+}
+
+void
+PropertyMatcher::lookup(const index_map &map, const std::string &key,
+			std::vector<size_t> &pos)
+{
+	index_map::const_iterator it = map.find(key);
+	if (it != map.end()) {
+		pos.insert(pos.end(), it->second.begin(), it->second.end());
+	}
+}
+
+/**
+ * Lookup all entries in map being a prefix of key.
+ */
+void
+PropertyMatcher::lookupPrefix(const index_map &map, const std::string &key,
+			      std::vector<size_t> &pos)
+{
+	if (map.empty()) {
+		return;
+	}
+	for (size_t len = 0; len <= key.size(); len++) {
+		lookup(map, key.substr(0, len), pos);
+	}
+}
+
 //! @brief Constructor for AutoProperties class
 AutoProperties::AutoProperties(ImageHandler *image_handler)
 	: _image_handler(image_handler),
 	  _extended(false),
+	  _prop_matcher(_prop_list),
+	  _title_prop_matcher(_title_prop_list),
+	  _decor_prop_matcher(_decor_prop_list),
+	  _dock_app_prop_matcher(_dock_app_prop_list),
 	  _harbour_sort(false),
 	  _apply_on_start(true)
 {
@@ -222,6 +355,8 @@ AutoProperties::load(CfgParser &cfg)
 			parseWorkspace(*it);
 		}
 	}
+
+	updateMatchers();
 }
 
 /**
@@ -293,28 +428,39 @@ AutoProperties::unload(void)
 		delete wit->second;
 	}
 	_window_type_prop_map.clear();
+
+	updateMatchers();
+}
+
+void
+AutoProperties::updateMatchers()
+{
+	_prop_matcher.update();
+	_title_prop_matcher.update();
+	_decor_prop_matcher.update();
+	_dock_app_prop_matcher.update();
 }
 
 //! @brief Finds a property from the prop_list
 Property*
 AutoProperties::findProperty(const ClassHint& class_hint,
-			     std::vector<Property*>* prop_list,
+			     PropertyMatcher &matcher,
 			     int ws, ApplyOn type)
 {
 	// Allready remove apply on start
 	if (! _apply_on_start && (type == APPLY_ON_START))
 		return nullptr;
 
-	// start searching for a suitable property
-	std::vector<Property*>::iterator it = prop_list->begin();
-	for (; it != prop_list->end(); ++it) {
+	// start searching for a suitable property among the ones matching
+	// the class hint.
+	const std::vector<Property*> &props = matcher.match(class_hint);
+	std::vector<Property*>::const_iterator it = props.begin();
+	for (; it != props.end(); ++it) {
 		// see if the type matches, if we have one
 		if ((type != APPLY_ON_ALWAYS) && ! (*it)->isApplyOn(type))
 			continue;
 
-		if (matchAutoClass(class_hint, *it)) {
-			return (*it)->applyOnWs(ws) ? *it : nullptr;
-		}
+		return (*it)->applyOnWs(ws) ? *it : nullptr;
 	}
 
 	return nullptr;
@@ -868,8 +1014,7 @@ AutoProperties::parseAutoPropertyType(CfgParser::Entry* it, AutoProperty* prop)
 {
 	std::vector<std::string> tokens;
 	std::vector<std::string>::iterator token_it;
-	PropertyType property_type =
-		Util::StringToGet(property_map, it->getName());
+	PropertyType property_type = property_index.get(it->getName());
 
 	switch (property_type) {
 	case AP_STICKY:
@@ -1013,7 +1158,7 @@ AutoProperties::findAutoProperty(const ClassHint& class_hint, int ws,
 				 ApplyOn type)
 {
 	return static_cast<AutoProperty*>(
-			findProperty(class_hint, &_prop_list, ws, type));
+			findProperty(class_hint, _prop_matcher, ws, type));
 }
 
 //! @brief Searches the _title_prop_list for a property
@@ -1021,7 +1166,7 @@ TitleProperty*
 AutoProperties::findTitleProperty(const ClassHint& class_hint)
 {
 	return static_cast<TitleProperty*>(
-			findProperty(class_hint, &_title_prop_list, -1,
+			findProperty(class_hint, _title_prop_matcher, -1,
 				     APPLY_ON_ALWAYS));
 }
 
@@ -1029,7 +1174,7 @@ DecorProperty*
 AutoProperties::findDecorProperty(const ClassHint& class_hint)
 {
 	return static_cast<DecorProperty*>(
-			findProperty(class_hint, &_decor_prop_list, -1,
+			findProperty(class_hint, _decor_prop_matcher, -1,
 				     APPLY_ON_ALWAYS));
 }
 
@@ -1037,7 +1182,7 @@ DockAppProperty*
 AutoProperties::findDockAppProperty(const ClassHint& class_hint)
 {
 	return static_cast<DockAppProperty*>(
-			findProperty(class_hint, &_dock_app_prop_list, -1,
+			findProperty(class_hint, _dock_app_prop_matcher, -1,
 				     APPLY_ON_ALWAYS));
 }
 
@@ -1074,6 +1219,7 @@ AutoProperties::removeApplyOnStart(void)
 	}
 
 	_apply_on_start = false;
+	_prop_matcher.update();
 }
 
 //! @brief Tries to match a class hint against an autoproperty data entry
@@ -18,7 +18,9 @@
 #include "RegexString.hh"
 #include "X11.hh"
 
+#include <map>
 #include <string>
+#include <vector>
 
 /**
  * Bitmask with different auto property types, used to identify what
@@ -191,6 +193,47 @@ private:
 	int _position;
 };
 
+/**
+ * Matcher for a list of properties. Properties with a literal name, or
+ * class, pattern are indexed on the literal so only properties that can
+ * match the WM_CLASS of a client are tested. The result is cached per
+ * ClassHint, title and role included, until the list is updated.
+ */
+class PropertyMatcher {
+public:
+	PropertyMatcher(const std::vector<Property*> &props);
+	~PropertyMatcher();
+
+	void update();
+	const std::vector<Property*> &match(const ClassHint &hint);
+
+	size_t numIndexed() const { return _props.size() - _other.size(); }
+
+private:
+	typedef std::map<std::string, std::vector<size_t> > index_map;
+
+	PropertyMatcher(const PropertyMatcher&);
+	PropertyMatcher &operator=(const PropertyMatcher&);
+
+	bool add(RegexString &regex, size_t pos,
+		 index_map &exact, index_map &prefix);
+	static void lookup(const index_map &map, const std::string &key,
+			   std::vector<size_t> &pos);
+	static void lookupPrefix(const index_map &map, const std::string &key,
+				 std::vector<size_t> &pos);
+
+	const std::vector<Property*> &_props;
+
+	index_map _name_exact;
+	index_map _name_prefix;
+	index_map _class_exact;
+	index_map _class_prefix;
+	/** Positions of properties not indexed, always tested. */
+	std::vector<size_t> _other;
+
+	std::map<std::string, std::vector<Property*> > _cache;
+};
+
 class AutoProperties {
 public:
 	AutoProperties(ImageHandler *image_handler);
@@ -214,12 +257,13 @@ public:
 	static bool matchAutoClass(const ClassHint& hint, Property *prop);
 
 protected:
+	void load(CfgParser &cfg);
 	int parsePlacement(const std::string &value);
 
 private:
-	void load(CfgParser &cfg);
+	void updateMatchers();
 	Property* findProperty(const ClassHint& class_hint,
-			       std::vector<Property*>* prop_list,
+			       PropertyMatcher &matcher,
 			       int ws, ApplyOn type);
 
 	void loadRequire(CfgParser &a_cfg, const std::string &file);
@@ -257,6 +301,10 @@ private:
 	std::vector<Property*> _title_prop_list;
 	std::vector<Property*> _decor_prop_list;
 	std::vector<Property*> _dock_app_prop_list;
+	PropertyMatcher _prop_matcher;
+	PropertyMatcher _title_prop_matcher;
+	PropertyMatcher _decor_prop_matcher;
+	PropertyMatcher _dock_app_prop_matcher;
 	bool _harbour_sort;
 	bool _apply_on_start;
 };
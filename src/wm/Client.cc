@@ -42,6 +42,7 @@ extern "C" {
 #include "tk/ImageHandler.hh"
 #include "tk/PWinObj.hh"
 #include "tk/PImageIcon.hh"
+#include "tk/StartupProfile.hh"
 #include "tk/X11Util.hh"
 
 std::ostream&
@@ -102,7 +103,9 @@ ClassHint::operator==(const ClassHint& rhs) const
 const long Client::_clientEventMask = \
 	PropertyChangeMask|StructureNotifyMask|FocusChangeMask|KeyPressMask;
 std::vector<Client*> Client::_clients;
+uint Client::_clients_gen = 0;
 std::vector<uint> Client::_clientids;
+const RestartSnapshot *Client::_restart_snapshot = nullptr;
 
 
 
@@ -131,6 +134,17 @@ Client::Client(Window new_client, ClientInitConfig &initConfig, bool is_new)
 		return;
 	}
 
+	// Properties can not change while the server is grabbed, list
+	// them once to avoid round-trips for hints not set on the window.
+	X11::setPropertyCache(_window);
+	if (_restart_snapshot) {
+		const RestartSnapshot::hint_map *hints =
+			_restart_snapshot->find(_window);
+		if (hints) {
+			_pekwm_hints = *hints;
+		}
+	}
+
 	// Get unique Client id
 	_id = findClientID();
 	_title.setId(_id);
@@ -178,6 +192,7 @@ Client::Client(Window new_client, ClientInitConfig &initConfig, bool is_new)
 
 	updateEwmhStates();
 
+	X11::clearPropertyCache();
 	X11::ungrabServer(true);
 
 	setClientInitConfig(initConfig, is_new, ap);
@@ -190,6 +205,7 @@ Client::Client(Window new_client, ClientInitConfig &initConfig, bool is_new)
 	woListAdd(this);
 	_wo_map[_window] = this;
 	_clients.push_back(this);
+	_clients_gen++;
 
 	P_TRACE(this << " client " << _title.getReal() << " constructed for "
 		<< "window " << FMT_HEX(_window));
@@ -207,6 +223,7 @@ Client::~Client(void)
 	woListRemove(this);
 	_clients.erase(std::remove(_clients.begin(), _clients.end(), this),
 		       _clients.end());
+	_clients_gen++;
 	returnClientID(_id);
 
 	X11::grabServer();
@@ -319,6 +336,7 @@ Client::findOrCreateFrame(AutoProperty *autoproperty)
 
 	// if we don't have a frame already, create a new one
 	if (! _parent) {
+		StartupProfile::Scope profile("decorate");
 		parent_is_new = true;
 		_parent = new Frame(this, autoproperty);
 	}
@@ -360,7 +378,7 @@ Client::findPreviousFrame(void)
 	}
 
 	Cardinal id;
-	if (X11::getCardinal(_window, PEKWM_FRAME_ID, id)) {
+	if (getPekwmHint(PEKWM_FRAME_ID, id)) {
 		Frame *frame = Frame::findFrameFromID(id);
 		if (frame) {
 			frame->addChildOrdered(this);
@@ -845,7 +863,7 @@ Client::grabButtons(void)
 	X11::ungrabButton(AnyButton, AnyModifier, _window);
 
 	Config *cfg = pekwm::config();
-	std::vector<ActionEvent> *actions =
+	ActionEventList *actions =
 		cfg->getMouseActionList(MOUSE_ACTION_LIST_CHILD_FRAME);
 	std::vector<ActionEvent>::iterator it = actions->begin();
 
@@ -1031,11 +1049,11 @@ Client::readPekwmHints(void)
 	std::string str;
 
 	// Get decor state
-	if (X11::getCardinal(_window, PEKWM_FRAME_DECOR, value)) {
+	if (getPekwmHint(PEKWM_FRAME_DECOR, value)) {
 		_state.decor = value;
 	}
 	// Get skip state
-	if (X11::getCardinal(_window, PEKWM_FRAME_SKIP, value)) {
+	if (getPekwmHint(PEKWM_FRAME_SKIP, value)) {
 		_state.skip = value;
 	}
 
@@ -1266,6 +1284,10 @@ Client::readName(void)
 		return;
 	}
 
+	if (title != _title.getReal()) {
+		_clients_gen++;
+	}
+
 	// Mirror it on the visible
 	_title.setCustom("");
 	_title.setCount(titleFindID(title));
@@ -1372,6 +1394,10 @@ Client::getWmState(void)
 	ulong items_read, items_left;
 	uchar *udata;
 
+	if (! X11::hasProperty(_window, X11::getAtom(WM_STATE))) {
+		return state;
+	}
+
 	int status =
 		XGetWindowProperty(X11::getDpy(), _window,
 				   X11::getAtom(WM_STATE), 0L, 2L, False,
@@ -1457,7 +1483,7 @@ void
 Client::setSkip(uint skip)
 {
 	_state.skip = skip;
-	X11::setCardinal(_window, PEKWM_FRAME_SKIP, _state.skip);
+	setPekwmHint(PEKWM_FRAME_SKIP, _state.skip);
 }
 
 std::string
@@ -1773,7 +1799,9 @@ void
 Client::getWMNormalHints(void)
 {
 	long dummy;
-	XGetWMNormalHints(X11::getDpy(), _window, _size, &dummy);
+	if (X11::hasProperty(_window, XA_WM_NORMAL_HINTS)) {
+		XGetWMNormalHints(X11::getDpy(), _window, _size, &dummy);
+	}
 
 	// let's do some sanity checking
 	if (_size->flags&PBaseSize) {
@@ -1816,7 +1844,8 @@ Client::getWMProtocols(void)
 {
 	int count;
 	Atom *protocols;
-	if (! XGetWMProtocols(X11::getDpy(), _window, &protocols, &count)) {
+	if (! X11::hasProperty(_window, X11::getAtom(WM_PROTOCOLS))
+	    || ! XGetWMProtocols(X11::getDpy(), _window, &protocols, &count)) {
 		return;
 	}
 
@@ -1839,7 +1868,10 @@ Client::getTransientForHint(void)
 	_transient_for_window = None;
 
 	Client *transient_for = nullptr;
-	XGetTransientForHint(X11::getDpy(), _window, &_transient_for_window);
+	if (X11::hasProperty(_window, XA_WM_TRANSIENT_FOR)) {
+		XGetTransientForHint(X11::getDpy(), _window,
+				     &_transient_for_window);
+	}
 	if (_transient_for_window != None) {
 		if (_transient_for_window == _window) {
 			P_ERR(this << " client set transient hint for itself");
@@ -1955,7 +1987,7 @@ long
 Client::getPekwmFrameOrder(void)
 {
 	Cardinal num = -1;
-	X11::getCardinal(_window, PEKWM_FRAME_ORDER, num);
+	getPekwmHint(PEKWM_FRAME_ORDER, num);
 	return num;
 }
 
@@ -1965,7 +1997,7 @@ Client::getPekwmFrameOrder(void)
 void
 Client::setPekwmFrameOrder(long num)
 {
-	X11::setCardinal(_window, PEKWM_FRAME_ORDER, num);
+	setPekwmHint(PEKWM_FRAME_ORDER, num);
 }
 
 /**
@@ -1976,8 +2008,7 @@ bool
 Client::getPekwmFrameActive(void)
 {
 	Cardinal act = 0;
-	return (X11::getCardinal(_window, PEKWM_FRAME_ACTIVE, act)
-		&& act == 1);
+	return getPekwmHint(PEKWM_FRAME_ACTIVE, act) && act == 1;
 }
 
 /**
@@ -1986,7 +2017,36 @@ Client::getPekwmFrameActive(void)
 void
 Client::setPekwmFrameActive(bool act)
 {
-	X11::setCardinal(_window, PEKWM_FRAME_ACTIVE, act ? 1 : 0);
+	setPekwmHint(PEKWM_FRAME_ACTIVE, act ? 1 : 0);
+}
+
+/**
+ * Get pekwm owned hint, read from the window the first time unless
+ * known from the restart snapshot.
+ */
+bool
+Client::getPekwmHint(AtomName aname, Cardinal &value)
+{
+	RestartSnapshot::hint_map::iterator it = _pekwm_hints.find(aname);
+	if (it == _pekwm_hints.end()) {
+		RestartSnapshot::Hint hint;
+		hint.is_set = X11::getCardinal(_window, aname, hint.value);
+		it = _pekwm_hints.insert(std::make_pair(aname, hint)).first;
+	}
+	if (it->second.is_set) {
+		value = it->second.value;
+	}
+	return it->second.is_set;
+}
+
+/**
+ * Set pekwm owned hint on the client window.
+ */
+void
+Client::setPekwmHint(AtomName aname, Cardinal value)
+{
+	X11::setCardinal(_window, aname, value);
+	_pekwm_hints[aname] = RestartSnapshot::Hint(true, value);
 }
 
 /**
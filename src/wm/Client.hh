@@ -20,6 +20,7 @@
 #include "tk/PWinObj.hh"
 #include "tk/PTexturePlain.hh"
 #include "PDecor.hh"
+#include "RestartSnapshot.hh"
 
 class PScreen;
 class Strut;
@@ -165,6 +166,8 @@ public: // Public Member Functions
 
 	// START - Iterators
 	static uint client_size(void) { return _clients.size(); }
+	/** Incremented whenever a Client is added, removed or renamed. */
+	static uint client_gen(void) { return _clients_gen; }
 	static client_cit client_begin(void) { return _clients.begin(); }
 	static client_cit client_end(void) { return _clients.end(); }
 	static client_vec::reverse_iterator client_rbegin(void) {
@@ -346,6 +349,15 @@ public: // Public Member Functions
 	bool getPekwmFrameActive(void);
 	void setPekwmFrameActive(bool active);
 
+	bool getPekwmHint(AtomName aname, Cardinal &value);
+	void setPekwmHint(AtomName aname, Cardinal value);
+	const RestartSnapshot::hint_map &getPekwmHints(void) const {
+		return _pekwm_hints;
+	}
+	static void setRestartSnapshot(const RestartSnapshot *snapshot) {
+		_restart_snapshot = snapshot;
+	}
+
 	static void setClientEnvironment(Client *client);
 	AutoProperty* readAutoprops(ApplyOn type = APPLY_ON_ALWAYS);
 
@@ -415,6 +427,8 @@ private: // Private Member Variables
 	bool _extended_net_name;
 
 	ClientState _state;
+	/** Known state of pekwm owned hints on the client window. */
+	RestartSnapshot::hint_map _pekwm_hints;
 
 	class Actions {
 	public:
@@ -439,7 +453,10 @@ private: // Private Member Variables
 	static const long _clientEventMask;
 
 	static client_vec _clients; //!< Vector of all Clients.
+	static uint _clients_gen;
 	static std::vector<uint> _clientids; //!< Vector of free Client IDs.
+	/** Snapshot from previous process, only set while starting. */
+	static const RestartSnapshot *_restart_snapshot;
 };
 
 #endif // _PEKWM_CLIENT_HH_
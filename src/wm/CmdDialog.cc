@@ -95,7 +95,8 @@ CmdDialog::mapWindow(void)
 }
 
 /**
- * Unmaps window, overloaded to clear buffer and unset reference.
+ * Unmaps window, overloaded to clear buffer and unset reference. The
+ * completion index is kept and refreshed incrementally on next map.
  */
 void
 CmdDialog::unmapWindow(void)
@@ -104,7 +105,6 @@ CmdDialog::unmapWindow(void)
 		InputDialog::unmapWindow();
 		setWORef(0);
 		buf().clear();
-		_completer.clear();
 	}
 }
 
@@ -11,6 +11,7 @@
 #include <cstdlib>
 #include <algorithm>
 #include <iostream>
+#include <map>
 #include <vector>
 #include <string>
 
@@ -18,6 +19,7 @@ extern "C" {
 #include <sys/types.h>
 #include <dirent.h>
 #include <stdlib.h>
+#include <time.h>
 }
 
 #include "Charset.hh"
@@ -144,6 +146,10 @@ protected:
 
 /**
  * Path completer, provides completion of elements in the path.
+ *
+ * Names are kept sorted per directory and merged into a single sorted
+ * index, directories are only re-read when their modification time
+ * changes making refresh cheap when the dialog is opened again.
  */
 class PathCompleterMethod : public CompleterMethod
 {
@@ -157,73 +163,218 @@ public:
 	/** Destructor for PathCompleterMethod */
 	virtual ~PathCompleterMethod(void) { }
 
+	virtual unsigned int complete(CompletionState &completion_state);
+
+	virtual void refresh(void);
+
+	void clear(void) {
+		_path.clear();
+		_dirs.clear();
+		_names.clear();
+	}
+
+private:
 	/**
-	 * Complete str with available path elements.
+	 * Sorted names in a single directory.
 	 */
-	virtual unsigned int complete(CompletionState &completion_state) {
-		return complete_word(_path_list,
-				     completion_state.completions,
-				     completion_state.word);
-	}
+	class PathDir {
+	public:
+		PathDir(void)
+			: mtime(0)
+		{
+		}
 
-	void refresh(void) {
-		clear();
+		/** Modification time when read, 0 forces a re-read. */
+		time_t mtime;
+		std::vector<std::string> names;
+	};
+
+	static void read_dir(const std::string &path, PathDir &dir);
+	static unsigned int complete_prefix(
+		const std::vector<std::string> &names,
+		const std::string &prefix, const std::string &insert,
+		complete_list &completions);
+	static size_t find_subsequence(const std::string &word,
+				       const std::string &name);
+
+	/** Directories in PATH, in order. */
+	std::vector<std::string> _path;
+	std::map<std::string, PathDir> _dirs;
+	/** Sorted, unique, names from all directories in PATH. */
+	std::vector<std::string> _names;
+};
 
-		std::vector<std::string> path_parts;
-		std::vector<std::string>::iterator it;;
-		Util::splitString(Util::getEnv("PATH"), path_parts, ":");
+/**
+ * Complete word with names in the path, or with full paths if the word
+ * contains a /. Falls back to subsequence matching of names if nothing,
+ * including other completer methods, completed the word. Subsequence
+ * matches starting earlier in the name are listed first.
+ */
+unsigned int
+PathCompleterMethod::complete(CompletionState &completion_state)
+{
+	const std::string &word = completion_state.word;
+	complete_list &completions = completion_state.completions;
+
+	if (word.find('/') == std::string::npos) {
+		unsigned int completed =
+			complete_prefix(_names, word, "", completions);
+		if (completed || ! completions.empty() || word.size() < 2) {
+			return completed;
+		}
 
-		for (it = path_parts.begin(); it != path_parts.end(); ++it) {
-			DIR *dh = opendir(it->c_str());
-			if (dh) {
-				refresh_path(dh, Charset::fromSystem(*it));
-				closedir(dh);
+		std::vector<std::pair<size_t, std::string> > matches;
+		std::vector<std::string>::const_iterator it = _names.begin();
+		for (; it != _names.end(); ++it) {
+			size_t pos = find_subsequence(word, *it);
+			if (pos != std::string::npos) {
+				matches.push_back(std::make_pair(pos, *it));
 			}
 		}
+		std::sort(matches.begin(), matches.end());
 
-		completions_list::iterator last =
-			std::unique(_path_list.begin(), _path_list.end());
-		_path_list.erase(last, _path_list.end());
-		std::sort(_path_list.begin(), _path_list.end());
+		std::vector<std::pair<size_t, std::string> >::iterator m_it =
+			matches.begin();
+		for (; m_it != matches.end(); ++m_it) {
+			completions.push_back(m_it->second);
+		}
+		return matches.size();
 	}
 
-	void clear(void) {
-		_path_list.clear();
+	unsigned int completed = 0;
+	std::vector<std::string>::const_iterator it = _path.begin();
+	for (; it != _path.end(); ++it) {
+		std::string dir = *it + "/";
+		if (word.size() <= dir.size()) {
+			if (! starts_with(dir, 0, word, word.size())) {
+				continue;
+			}
+			completed += complete_prefix(_dirs[*it].names, "", dir,
+						     completions);
+		} else if (starts_with(word, 0, dir, dir.size())) {
+			completed += complete_prefix(_dirs[*it].names,
+						     word.substr(dir.size()),
+						     dir, completions);
+		}
 	}
+	return completed;
+}
 
-private:
-	void refresh_path(DIR *dh, const std::string& path);
-	void add_path(const std::string& name, const std::string& path_name);
-
-	completions_list _path_list; /**< List of all elements in path. */
-};
+/**
+ * Refresh index, only directories that changed since last refresh are
+ * read.
+ */
+void
+PathCompleterMethod::refresh(void)
+{
+	std::vector<std::string> path_parts;
+	Util::splitString(Util::getEnv("PATH"), path_parts, ":");
+	bool changed = path_parts != _path;
+
+	std::map<std::string, PathDir> dirs;
+	std::vector<std::string> path;
+	std::vector<std::string>::iterator it = path_parts.begin();
+	for (; it != path_parts.end(); ++it) {
+		std::string dir_name = Charset::fromSystem(*it);
+		if (dirs.find(dir_name) != dirs.end()) {
+			continue;
+		}
+		path.push_back(dir_name);
+
+		PathDir &dir = dirs[dir_name];
+		std::map<std::string, PathDir>::iterator d_it =
+			_dirs.find(dir_name);
+		time_t mtime = Util::getMtime(*it);
+		if (d_it != _dirs.end() && d_it->second.mtime != 0
+		    && d_it->second.mtime == mtime) {
+			dir.mtime = mtime;
+			dir.names.swap(d_it->second.names);
+		} else {
+			read_dir(*it, dir);
+			// entries added within the same second as the read
+			// would not change the mtime, read again next time.
+			dir.mtime = mtime < time(nullptr) - 1 ? mtime : 0;
+			changed = true;
+		}
+	}
+	_path.swap(path);
+	_dirs.swap(dirs);
+
+	if (changed) {
+		_names.clear();
+		std::map<std::string, PathDir>::iterator d_it = _dirs.begin();
+		for (; d_it != _dirs.end(); ++d_it) {
+			_names.insert(_names.end(), d_it->second.names.begin(),
+				      d_it->second.names.end());
+		}
+		std::sort(_names.begin(), _names.end());
+		std::vector<std::string>::iterator last =
+			std::unique(_names.begin(), _names.end());
+		_names.erase(last, _names.end());
+	}
+}
 
 /**
- * Refresh single directory.
+ * Read sorted names in a single directory.
  */
 void
-PathCompleterMethod::refresh_path(DIR *dh, const std::string& path)
+PathCompleterMethod::read_dir(const std::string &path, PathDir &dir)
 {
+	dir.names.clear();
+	DIR *dh = opendir(path.c_str());
+	if (dh == nullptr) {
+		return;
+	}
+
 	struct dirent *entry;
 	while ((entry = readdir(dh)) != 0) {
-		if (entry->d_name[0] == '.') {
-			continue;
+		if (entry->d_name[0] != '.') {
+			dir.names.push_back(Charset::fromSystem(entry->d_name));
 		}
+	}
+	closedir(dh);
+
+	std::sort(dir.names.begin(), dir.names.end());
+}
 
-		std::string name = Charset::toSystem(entry->d_name);
-		std::string path_name = path + "/" + name;
-		add_path(name, path_name);
+/**
+ * Add names starting with prefix to completions, with insert added in
+ * front of the name. Uses binary search to find the first match.
+ */
+unsigned int
+PathCompleterMethod::complete_prefix(const std::vector<std::string> &names,
+				     const std::string &prefix,
+				     const std::string &insert,
+				     complete_list &completions)
+{
+	unsigned int completed = 0;
+	std::vector<std::string>::const_iterator it =
+		std::lower_bound(names.begin(), names.end(), prefix);
+	for (; it != names.end(); ++it) {
+		if (! starts_with(*it, 0, prefix, prefix.size())) {
+			break;
+		}
+		completions.push_back(insert + *it);
+		completed++;
 	}
+	return completed;
 }
 
-void
-PathCompleterMethod::add_path(const std::string& name,
-			      const std::string& path_name)
+/**
+ * Find all characters in word in name, in order.
+ *
+ * @return Position of the first character in name, npos if not found.
+ */
+size_t
+PathCompleterMethod::find_subsequence(const std::string &word,
+				      const std::string &name)
 {
-	CompPair nn(name, name);
-	_path_list.push_back(nn);
-	CompPair pp(path_name, path_name);
-	_path_list.push_back(pp);
+	size_t start = name.find(word[0]);
+	size_t pos = start;
+	for (size_t i = 1; pos != std::string::npos && i < word.size(); i++) {
+		pos = name.find(word[i], pos + 1);
+	}
+	return pos == std::string::npos ? pos : start;
 }
 
 /**
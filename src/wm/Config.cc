@@ -222,7 +222,7 @@ Config::Config() :
 	// fill the mouse action map
 	for (uint i = 0; i <= MOUSE_ACTION_LIST_NO; i++) {
 		MouseActionListName maln = static_cast<MouseActionListName>(i);
-		_mouse_action_map[maln] = new std::vector<ActionEvent>();
+		_mouse_action_map[maln] = new ActionEventList();
 	}
 }
 
@@ -1152,6 +1152,7 @@ Config::loadMouseConfig(const std::string &mouse_file)
 	mouse_action_map::iterator it = _mouse_action_map.begin();
 	for (; it != _mouse_action_map.end(); ++it) {
 		it->second->clear();
+		it->second->updateIndex();
 	}
 
 	CfgParser::Entry *section;
@@ -1258,7 +1259,7 @@ mouseButtonsAdd(std::vector<BoundButton>* buttons, uint button, uint mod)
  */
 void
 Config::parseButtons(CfgParser::Entry *section,
-		     std::vector<ActionEvent>* mouse_list,
+		     ActionEventList *mouse_list,
 		     std::vector<BoundButton>* mouse_buttons,
 		     ActionOk action_ok)
 {
@@ -1295,14 +1296,15 @@ Config::parseButtons(CfgParser::Entry *section,
 			mouseButtonsAdd(mouse_buttons, ae.sym, ae.mod);
 		}
 	}
+	mouse_list->updateIndex();
 }
 
 // frame border configuration
 
-std::vector<ActionEvent>*
+ActionEventList *
 Config::getBorderListFromPosition(uint pos)
 {
-	std::vector<ActionEvent> *ret = 0;
+	ActionEventList *ret = 0;
 
 	switch (pos) {
 	case BORDER_TOP_LEFT:
@@ -1334,10 +1336,10 @@ Config::getBorderListFromPosition(uint pos)
 	return ret;
 }
 
-std::vector<ActionEvent>*
+ActionEventList *
 Config::getEdgeListFromPosition(uint pos)
 {
-	std::vector<ActionEvent> *ret = 0;
+	ActionEventList *ret = 0;
 
 	switch (pos) {
 	case SCREEN_EDGE_TOP:
@@ -85,7 +85,7 @@ struct BoundButton {
 class Config
 {
 public:
-	typedef std::map<MouseActionListName, std::vector<ActionEvent>* >
+	typedef std::map<MouseActionListName, ActionEventList*>
 		mouse_action_map;
 
 	Config(void);
@@ -287,15 +287,15 @@ public:
 	uint getHarbourOrientation(void) const { return _harbour_orientation; }
 	uint getHarbourOpacity(void) const { return _harbour_opacity; }
 
-	std::vector<ActionEvent> *getMouseActionList(MouseActionListName n) {
+	ActionEventList *getMouseActionList(MouseActionListName n) {
 		return _mouse_action_map[n];
 	}
 	const std::vector<BoundButton>& getClientMouseActionButtons(void) {
 		return _client_mouse_action_buttons;
 	}
 
-	std::vector<ActionEvent> *getBorderListFromPosition(uint pos);
-	std::vector<ActionEvent> *getEdgeListFromPosition(uint pos);
+	ActionEventList *getBorderListFromPosition(uint pos);
+	ActionEventList *getEdgeListFromPosition(uint pos);
 
 	bool isSysEnabled() const { return _sys_enabled; }
 
@@ -349,7 +349,7 @@ private:
 	bool loadSys(CfgParser::Entry *section);
 
 	void parseButtons(CfgParser::Entry *section,
-			  std::vector<ActionEvent>* mouse_list,
+			  ActionEventList *mouse_list,
 			  std::vector<BoundButton>* mouse_buttons,
 			  ActionOk action_ok);
 
@@ -0,0 +1,128 @@
+//
+// DynamicCommand.cc for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#include "Debug.hh"
+#include "DynamicCommand.hh"
+#include "Util.hh"
+
+extern "C" {
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+}
+
+DynamicCommand::DynamicCommand(Os *os, EventLoop *event_loop,
+			       const std::string &command,
+			       const std::string &command_path, uint ttl)
+	: _os(os),
+	  _event_loop(event_loop),
+	  _command(command),
+	  _command_path(command_path),
+	  _ttl(ttl),
+	  _listener(nullptr),
+	  _process(nullptr),
+	  _updated(0)
+{
+}
+
+DynamicCommand::~DynamicCommand()
+{
+	stop(true);
+}
+
+/**
+ * Check if the command needs to be run again, true if there is no output
+ * or the output is older than the ttl.
+ */
+bool
+DynamicCommand::isExpired(time_t now) const
+{
+	return _updated == 0 || now < _updated
+		|| static_cast<uint>(now - _updated) >= _ttl;
+}
+
+/**
+ * Start the command unless it is already running, the environment of the
+ * current process is used with the command path prepended to PATH.
+ *
+ * @return true if the command is running.
+ */
+bool
+DynamicCommand::run()
+{
+	if (_process) {
+		return true;
+	}
+
+	OsEnv env;
+	env.override("PATH", _command_path + ":" + Util::getEnv("PATH"));
+
+	std::vector<std::string> args;
+	args.push_back(PEKWM_SH);
+	args.push_back("-c");
+	args.push_back(_command);
+	_process = _os->childExec(args, ChildProcess::CHILD_IO_STDOUT, &env);
+	if (_process == nullptr) {
+		P_ERR("failed to run dynamic command " << _command);
+		return false;
+	}
+
+	P_TRACE("started dynamic command " << _command << " pid "
+		<< _process->getPid());
+	_buf = "";
+	_event_loop->addFdHandler(_process->getReadFd(),
+				  OsSelect::OS_SELECT_READ, this);
+	return true;
+}
+
+/**
+ * Read output from the command, on end of file the output is stored and
+ * the listener notified.
+ */
+void
+DynamicCommand::handleFd(int fd, int)
+{
+	char buf[4096];
+	ssize_t len = read(fd, buf, sizeof(buf));
+	if (len > 0) {
+		_buf.append(buf, len);
+		return;
+	} else if (len == -1 && (errno == EINTR || errno == EAGAIN)) {
+		return;
+	}
+
+	stop(false);
+	_output = _buf;
+	_buf = "";
+	_updated = time(nullptr);
+	P_TRACE("dynamic command " << _command << " done, "
+		<< _output.size() << " bytes");
+
+	// last, the listener might delete the command
+	if (_listener) {
+		_listener->dynamicCommandDone(this);
+	}
+}
+
+void
+DynamicCommand::stop(bool kill)
+{
+	if (_process == nullptr) {
+		return;
+	}
+
+	_event_loop->removeFdHandler(_process->getReadFd());
+	if (kill) {
+		_os->processSignal(_process->getPid(), SIGTERM);
+	}
+	// do not block the main loop waiting for a slow or stuck
+	// command, it is reaped by the SIGCHLD handler if still running.
+	_process->detach();
+	delete _process;
+	_process = nullptr;
+}
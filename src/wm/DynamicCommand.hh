@@ -0,0 +1,84 @@
+//
+// DynamicCommand.hh for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#ifndef _PEKWM_DYNAMICCOMMAND_HH_
+#define _PEKWM_DYNAMICCOMMAND_HH_
+
+#include "config.h"
+
+#include "EventLoop.hh"
+#include "Os.hh"
+
+#include <string>
+
+extern "C" {
+#include <time.h>
+}
+
+/**
+ * Command generating dynamic menu content. The command is run in the
+ * background with the output pipe watched by the EventLoop, the output
+ * of the last run is kept and re-used until ttl seconds have passed.
+ */
+class DynamicCommand : public FdHandler {
+public:
+	/**
+	 * Listener notified when a run of the command has completed.
+	 */
+	class Listener {
+	public:
+		virtual ~Listener() { }
+		virtual void dynamicCommandDone(DynamicCommand *cmd) = 0;
+	};
+
+	DynamicCommand(Os *os, EventLoop *event_loop,
+		       const std::string &command,
+		       const std::string &command_path, uint ttl);
+	virtual ~DynamicCommand();
+
+	const std::string &getCommand() const { return _command; }
+	uint getTtl() const { return _ttl; }
+
+	bool hasOutput() const { return _updated != 0; }
+	const std::string &getOutput() const { return _output; }
+	bool isRunning() const { return _process != nullptr; }
+	bool isExpired(time_t now) const;
+
+	void setListener(Listener *listener) { _listener = listener; }
+
+	bool run();
+
+	// START - FdHandler interface.
+	virtual void handleFd(int fd, int mask);
+	// END - FdHandler interface.
+
+private:
+	DynamicCommand(const DynamicCommand&);
+	DynamicCommand &operator=(const DynamicCommand&);
+
+	void stop(bool kill);
+
+	Os *_os;
+	EventLoop *_event_loop;
+	std::string _command;
+	/** PATH prefix for the command, scripts directory. */
+	std::string _command_path;
+	/** Seconds the output is re-used without running the command. */
+	uint _ttl;
+
+	Listener *_listener;
+	ChildProcess *_process;
+	/** Output of the currently running command. */
+	std::string _buf;
+	/** Output from the last completed run. */
+	std::string _output;
+	/** Time of the last completed run, 0 if never completed. */
+	time_t _updated;
+};
+
+#endif // _PEKWM_DYNAMICCOMMAND_HH_
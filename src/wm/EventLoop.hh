@@ -1,6 +1,6 @@
 //
 // EventLoop.hh for pekwm
-// Copyright (C) 2021 Claes Nästén <pekdon@gmail.com>
+// Copyright (C) 2021-2025 Claes Nästén <pekdon@gmail.com>
 //
 // This program is licensed under the GNU GPL.
 // See the LICENSE file for more information.
@@ -15,12 +15,24 @@ extern "C" {
 #include <X11/Xlib.h>
 }
 
+/**
+ * Handler for I/O on file descriptors watched by the EventLoop.
+ */
+class FdHandler {
+public:
+	virtual ~FdHandler() { }
+	virtual void handleFd(int fd, int mask) = 0;
+};
+
 /**
  * EventLoop interfaction
  */
 class EventLoop {
 public:
 	virtual void setEventHandler(EventHandler* event_handler) = 0;
+
+	virtual void addFdHandler(int fd, int mask, FdHandler *handler) = 0;
+	virtual void removeFdHandler(int fd) = 0;
 };
 
 #endif // _PEKWM_EVENTLOOP_HH_
@@ -73,7 +73,7 @@ Frame::Frame(Client *client, AutoProperty *ap)
 	// get unique id of the frame, if the client didn't have an id
 	if (pekwm::isStarting()) {
 		Cardinal id;
-		if (X11::getCardinal(client->getWindow(), PEKWM_FRAME_ID, id)) {
+		if (client->getPekwmHint(PEKWM_FRAME_ID, id)) {
 			_id = id;
 		}
 	} else {
@@ -309,7 +309,7 @@ Frame::handleMotionEvent(XMotionEvent *ev)
 	}
 
 	Config* cfg = pekwm::config();
-	std::vector<ActionEvent>* al = nullptr;
+	ActionEventList *al = nullptr;
 	uint button = X11::getButtonFromState(ev->state);
 
 	if (ev->window == getTitleWindow()) {
@@ -352,7 +352,7 @@ Frame::handleEnterEvent(XCrossingEvent *ev)
 	// returned.
 	PDecor::handleEnterEvent(ev);
 
-	std::vector<ActionEvent> *al = 0;
+	ActionEventList *al = 0;
 	Config *cfg = pekwm::config();
 
 	if (ev->window == getTitleWindow() || findButton(ev->window)) {
@@ -382,7 +382,7 @@ Frame::handleLeaveEvent(XCrossingEvent *ev)
 		ln = MOUSE_ACTION_LIST_CHILD_FRAME;
 	}
 
-	std::vector<ActionEvent>* al = pekwm::config()->getMouseActionList(ln);
+	ActionEventList *al = pekwm::config()->getMouseActionList(ln);
 	return ActionHandler::findMouseAction(BUTTON_ANY, ev->state,
 					      MOUSE_EVENT_LEAVE, al);
 }
@@ -456,10 +456,14 @@ void
 Frame::addChild(PWinObj *child, std::vector<PWinObj*>::iterator *it)
 {
 	PDecor::addChild(child, it);
-	X11::setCardinal(child->getWindow(), PEKWM_FRAME_ID, _id);
 	child->lower();
 
 	Client *client = dynamic_cast<Client*>(child);
+	if (client) {
+		client->setPekwmHint(PEKWM_FRAME_ID, _id);
+	} else {
+		X11::setCardinal(child->getWindow(), PEKWM_FRAME_ID, _id);
+	}
 	if (client && client->demandsAttention()) {
 		incrAttention();
 	}
@@ -644,7 +648,13 @@ Frame::setId(uint id)
 	_id = id;
 	std::vector<PWinObj*>::iterator it = _children.begin();
 	for (; it != _children.end(); ++it) {
-		X11::setCardinal((*it)->getWindow(), PEKWM_FRAME_ID, id);
+		Client *client = dynamic_cast<Client*>(*it);
+		if (client) {
+			client->setPekwmHint(PEKWM_FRAME_ID, id);
+		} else {
+			X11::setCardinal((*it)->getWindow(), PEKWM_FRAME_ID,
+					 id);
+		}
 	}
 }
 
@@ -1313,8 +1323,8 @@ Frame::setStateDecorBorder(StateAction sa)
 		_client->setBorder(hasBorder());
 
 		// update the _PEKWM_FRAME_DECOR hint
-		X11::setCardinal(_client->getWindow(), PEKWM_FRAME_DECOR,
-				 _client->getDecorState());
+		_client->setPekwmHint(PEKWM_FRAME_DECOR,
+				      _client->getDecorState());
 	}
 }
 
@@ -1329,8 +1339,8 @@ Frame::setStateDecorTitlebar(StateAction sa)
 	if (titlebar != setTitlebar(sa)) {
 		_client->setTitlebar(hasTitlebar());
 
-		X11::setCardinal(_client->getWindow(), PEKWM_FRAME_DECOR,
-				 _client->getDecorState());
+		_client->setPekwmHint(PEKWM_FRAME_DECOR,
+				      _client->getDecorState());
 	}
 }
 
@@ -19,7 +19,9 @@
 
 #include "tk/FontHandler.hh"
 #include "tk/Hooks.hh"
+#include "tk/ImageCache.hh"
 #include "tk/ImageHandler.hh"
+#include "tk/StartupProfile.hh"
 #include "tk/TextureHandler.hh"
 #include "tk/Theme.hh"
 
@@ -66,11 +68,13 @@ namespace pekwm
 
 		// configuration parsing require X11 to get atom and
 		// resource variables expanded properly
+		StartupProfile::phase("x11");
 		X11::init(dpy, synchronous, true);
 
 		// used by config
 		_hooks = new Hooks(os);
 
+		StartupProfile::phase("config");
 		_config = new Config();
 		_config->load(config_file);
 		_config->loadMouseConfig(_config->getMouseConfigFile());
@@ -94,6 +98,7 @@ namespace pekwm
 				      standalone);
 		PWinObj::setRootPWinObj(_root_wo);
 
+		StartupProfile::phase("keys");
 		_key_grabber = new KeyGrabber();
 		_key_grabber->load(_config->getKeyFile());
 		_key_grabber->grabKeys(X11::getRoot());
@@ -102,11 +107,13 @@ namespace pekwm
 		X11::setString(X11::getRoot(), PEKWM_THEME_SCALE,
 			       std::to_string(_config->getScreenScale()));
 
+		StartupProfile::phase("theme");
 		_font_handler =
 			new FontHandler(_config->getScreenScale(),
 					_config->isDefaultFontX11(),
 					_config->getFontCharsetOverride());
 		_image_handler = new ImageHandler(_config->getScreenScale());
+		_image_handler->setCacheDir(ImageCache::getDefaultDir());
 		_texture_handler =
 			new TextureHandler(_config->getScreenScale());
 		_theme = new Theme(_font_handler, _image_handler,
@@ -115,6 +122,7 @@ namespace pekwm
 				   _config->getThemeVariant(),
 				   true);
 
+		StartupProfile::phase("autoproperties");
 		_auto_properties = new AutoProperties(_image_handler);
 		_auto_properties->load();
 
@@ -45,37 +45,27 @@ KeyGrabber::Chain::unload(void)
 	}
 	_chains.clear();
 	_keys.clear();
+	_chains_index.clear();
+	_keys_index.clear();
 }
 
 //! @brief Searches the _chains list for an action
 KeyGrabber::Chain*
 KeyGrabber::Chain::findChain(XKeyEvent *ev, bool &matched)
 {
-	std::vector<Chain*>::iterator it = _chains.begin();
-	for (; it != _chains.end(); ++it) {
-		if ((((*it)->getMod() == MOD_ANY)
-		      || ((*it)->getMod() == ev->state))
-		    && (((*it)->getKey() == 0)
-			|| ((*it)->getKey() == ev->keycode))) {
-			return *it;
-		}
-	}
-	return nullptr;
+	size_t pos = _chains_index.find(0, ev->state, ev->keycode);
+	return pos < _chains.size() ? _chains[pos] : nullptr;
 }
 
 //! @brief Searches the _keys list for an action
 ActionEvent*
 KeyGrabber::Chain::findAction(XKeyEvent *ev, bool &matched)
 {
-	std::vector<ActionEvent>::iterator it = _keys.begin();
-	for (; it != _keys.end(); ++it) {
-		if ((it->mod == MOD_ANY || it->mod == ev->state)
-		    && (it->sym == 0 || it->sym == ev->keycode)) {
-			matched = true;
-			return &*it;
-		}
+	size_t pos = _keys_index.find(0, ev->state, ev->keycode);
+	if (pos < _keys.size()) {
+		matched = true;
+		return &_keys[pos];
 	}
-
 	return 0;
 }
 
@@ -53,10 +53,13 @@ public:
 
 		//! @brief Adds chain to Chain vector.
 		inline void addChain(Chain *chain) {
+			_chains_index.add(0, chain->getMod(), chain->getKey(),
+					  _chains.size());
 			_chains.push_back(chain);
 		}
 		//! @brief Adds action to Key vector.
 		inline void addAction(const ActionEvent &key) {
+			_keys_index.add(0, key.mod, key.sym, _keys.size());
 			_keys.push_back(key);
 		}
 
@@ -68,6 +71,10 @@ public:
 
 		std::vector<Chain*> _chains;
 		std::vector<ActionEvent> _keys;
+		/** Index of _chains on modifier and keycode. */
+		ActionEventIndex _chains_index;
+		/** Index of _keys on modifier and keycode. */
+		ActionEventIndex _keys_index;
 	};
 
 	KeyGrabber(void);
@@ -258,7 +258,7 @@ RootWO::~RootWO(void)
 const ActionEvent*
 RootWO::handleButtonPress(XButtonEvent *ev)
 {
-	std::vector<ActionEvent>* el =
+	ActionEventList *el =
 		_cfg->getMouseActionList(MOUSE_ACTION_LIST_ROOT);
 	return ActionHandler::findMouseAction(ev->button, ev->state,
 					      MOUSE_EVENT_PRESS, el);
@@ -285,7 +285,7 @@ RootWO::handleButtonRelease(XButtonEvent *ev)
 		X11::setLastClickTime(ev->button - 1, ev->time);
 	}
 
-	std::vector<ActionEvent>* el =
+	ActionEventList *el =
 		_cfg->getMouseActionList(MOUSE_ACTION_LIST_ROOT);
 	return ActionHandler::findMouseAction(ev->button, ev->state, mb, el);
 }
@@ -297,7 +297,7 @@ const ActionEvent*
 RootWO::handleMotionEvent(XMotionEvent *ev)
 {
 	unsigned int button = X11::getButtonFromState(ev->state);
-	std::vector<ActionEvent>* el =
+	ActionEventList *el =
 		_cfg->getMouseActionList(MOUSE_ACTION_LIST_ROOT);
 	return ActionHandler::findMouseAction(button, ev->state,
 					      MOUSE_EVENT_MOTION, el);
@@ -309,7 +309,7 @@ RootWO::handleMotionEvent(XMotionEvent *ev)
 const ActionEvent*
 RootWO::handleEnterEvent(XCrossingEvent *ev)
 {
-	std::vector<ActionEvent>* el =
+	ActionEventList *el =
 		_cfg->getMouseActionList(MOUSE_ACTION_LIST_ROOT);
 	return ActionHandler::findMouseAction(BUTTON_ANY, ev->state,
 					      MOUSE_EVENT_ENTER, el);
@@ -321,7 +321,7 @@ RootWO::handleEnterEvent(XCrossingEvent *ev)
 const ActionEvent*
 RootWO::handleLeaveEvent(XCrossingEvent *ev)
 {
-	std::vector<ActionEvent>* el =
+	ActionEventList *el =
 		_cfg->getMouseActionList(MOUSE_ACTION_LIST_ROOT);
 	return ActionHandler::findMouseAction(BUTTON_ANY, ev->state,
 					      MOUSE_EVENT_LEAVE, el);
@@ -703,7 +703,7 @@ EdgeWO::mapWindow(void)
 const ActionEvent*
 EdgeWO::handleEnterEvent(XCrossingEvent *ev)
 {
-	std::vector<ActionEvent>* el = _cfg->getEdgeListFromPosition(_edge);
+	ActionEventList *el = _cfg->getEdgeListFromPosition(_edge);
 	return ActionHandler::findMouseAction(BUTTON_ANY, ev->state,
 					      MOUSE_EVENT_ENTER, el);
 }
@@ -714,7 +714,7 @@ EdgeWO::handleEnterEvent(XCrossingEvent *ev)
 const ActionEvent*
 EdgeWO::handleButtonPress(XButtonEvent *ev)
 {
-	std::vector<ActionEvent>* el = _cfg->getEdgeListFromPosition(_edge);
+	ActionEventList *el = _cfg->getEdgeListFromPosition(_edge);
 	return ActionHandler::findMouseAction(ev->button, ev->state,
 					      MOUSE_EVENT_PRESS, el);
 }
@@ -748,7 +748,7 @@ EdgeWO::handleButtonRelease(XButtonEvent *ev)
 		X11::setLastClickTime(ev->button - 1, ev->time);
 	}
 
-	std::vector<ActionEvent>* el = _cfg->getEdgeListFromPosition(_edge);
+	ActionEventList *el = _cfg->getEdgeListFromPosition(_edge);
 	return ActionHandler::findMouseAction(ev->button, ev->state, mb, el);
 }
 
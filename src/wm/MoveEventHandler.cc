@@ -57,6 +57,8 @@ MoveEventHandler::initEventHandler(void)
 		return false;
 	}
 
+	PDecor::buildSnapIndex(_decor, _snap_index);
+
 	// Grab server to avoid any events causing garbage on the
 	// screen as the outline is drawed as an inverted rectangle.
 	if (_outline) {
@@ -115,7 +117,7 @@ MoveEventHandler::handleMotionNotifyEvent(XMotionEvent *ev)
 
 	_gm.x = ev->x_root - _x;
 	_gm.y = ev->y_root - _y;
-	PDecor::checkSnap(_decor, _gm);
+	_snap_index.snap(_gm);
 
 	if (! _outline && _gm != _last_gm) {
 		_last_gm = _gm;
@@ -203,7 +205,7 @@ void
 MoveEventHandler::doMoveEdgeAction(XMotionEvent *ev, EdgeType edge)
 {
 	uint button = X11::getButtonFromState(ev->state);
-	std::vector<ActionEvent> *edge_actions =
+	ActionEventList *edge_actions =
 		_cfg->getEdgeListFromPosition(edge);
 	ActionEvent *ae =
 		ActionHandler::findMouseAction(button, ev->state,
@@ -12,6 +12,7 @@
 #include "Config.hh"
 #include "EventHandler.hh"
 #include "Observable.hh"
+#include "SnapIndex.hh"
 #include "StatusWindow.hh"
 
 #include "tk/Action.hh"
@@ -54,6 +55,8 @@ private:
 	Geometry _gm;
 	Geometry _last_gm;
 	EdgeType _curr_edge;
+	/** Frames and head edges to snap against, built on init. */
+	SnapIndex _snap_index;
 
 	int _x;
 	int _y;
@@ -11,6 +11,7 @@
 
 #include <functional>
 #include <algorithm>
+#include <sstream>
 
 extern "C" {
 #include <X11/Xlib.h>
@@ -648,7 +649,7 @@ PDecor::handleButtonPressDecor(XButtonEvent *ev)
 		X11::allowEvents(ReplayPointer, CurrentTime);
 	}
 
-	std::vector<ActionEvent> *actions = nullptr;
+	ActionEventList *actions = nullptr;
 	Config *cfg = pekwm::config();
 	if (ev->window == _child->getWindow()
 	    || (ev->state == 0 && ev->subwindow == _child->getWindow())) {
@@ -729,7 +730,7 @@ PDecor::handleButtonReleaseDecor(XButtonEvent *ev)
 	}
 
 	MouseEventType mb = MOUSE_EVENT_RELEASE;
-	std::vector<ActionEvent> *actions = nullptr;
+	ActionEventList *actions = nullptr;
 	Config *cfg = pekwm::config();
 	if (ev->window == _child->getWindow()
 	    || (ev->state == 0 && ev->subwindow == _child->getWindow())) {
@@ -796,7 +797,7 @@ const ActionEvent*
 PDecor::handleMotionEvent(XMotionEvent *ev)
 {
 	uint button = X11::getButtonFromState(ev->state);
-	std::vector<ActionEvent> *malo =
+	ActionEventList *malo =
 		pekwm::config()->getMouseActionList(MOUSE_ACTION_LIST_OTHER);
 	return ActionHandler::findMouseAction(button, ev->state,
 					      MOUSE_EVENT_MOTION, malo);
@@ -814,7 +815,7 @@ PDecor::handleEnterEvent(XCrossingEvent *ev)
 		button->setState(BUTTON_STATE_HOVER);
 	}
 
-	std::vector<ActionEvent> *malo =
+	ActionEventList *malo =
 		pekwm::config()->getMouseActionList(MOUSE_ACTION_LIST_OTHER);
 	return ActionHandler::findMouseAction(BUTTON_ANY, ev->state,
 					      MOUSE_EVENT_ENTER, malo);
@@ -832,7 +833,7 @@ PDecor::handleLeaveEvent(XCrossingEvent *ev)
 		button->setState(button->getState());
 	}
 
-	std::vector<ActionEvent> *malo =
+	ActionEventList *malo =
 		pekwm::config()->getMouseActionList(MOUSE_ACTION_LIST_OTHER);
 	return ActionHandler::findMouseAction(BUTTON_ANY, ev->state,
 					      MOUSE_EVENT_LEAVE, malo);
@@ -995,6 +996,11 @@ PDecor::unloadDecor(void)
 	// the current buttons.
 	_button = 0;
 
+	// Theme data used by the rendered title might have changed
+	for (uint i = 0; i < TITLE_BG_STATES; ++i) {
+		_title_bg_key[i].clear();
+	}
+
 	std::vector<PDecor::Button*>::iterator it = _buttons.begin();
 	for (; it != _buttons.end(); ++it) {
 		removeChildWindow((*it)->getWindow());
@@ -1385,9 +1391,29 @@ PDecor::renderTitle(void)
 		calcTabsWidth();
 	}
 
+	// the title is only rendered when anything affecting the rendering
+	// changed since the last render in the same focused state, making
+	// focus changes a background swap.
 	FocusedState fstate = getFocusedState(false);
-	PPixmapSurface title_bg(_title_wo.getWidth(), _title_wo.getHeight());
+	std::string key = getTitleCacheKey(fstate);
+	PPixmapSurface &title_bg = _title_bg[fstate];
+	if (key != _title_bg_key[fstate]) {
+		title_bg.resize(_title_wo.getWidth(), _title_wo.getHeight());
+		renderTitle(title_bg, fstate);
+		_title_bg_key[fstate] = key;
+	}
 
+	X11::setWindowBackgroundPixmap(_title_wo.getWindow(),
+				       title_bg.getDrawable());
+	X11::clearWindow(_title_wo.getWindow());
+}
+
+/**
+ * Render main background, tabs and title text onto title_bg.
+ */
+void
+PDecor::renderTitle(PPixmapSurface &title_bg, FocusedState fstate)
+{
 	PTexture *t_main = _data->getTextureMain(fstate);
 	t_main->render(&title_bg, 0, 0,
 		       _title_wo.getWidth(), _title_wo.getHeight());
@@ -1406,11 +1432,7 @@ PDecor::renderTitle(void)
 		PFont *font = getFont(fstate_sel);
 		font->setColor(_data->getFontColor(fstate_sel));
 
-		PFont::TrimType trim = PFont::FONT_TRIM_MIDDLE;
-		if (_titles[i]->isCustom() || _titles[i]->isUserSet()) {
-			trim = PFont::FONT_TRIM_END;
-		}
-
+		PFont::TrimType trim = getTitleTrim(_titles[i]);
 		PTexture *title = _data->getTextureTitle(fstate_sel);
 		uint width_used;
 		if (title) {
@@ -1432,10 +1454,38 @@ PDecor::renderTitle(void)
 			x += t_sep->getWidth();
 		}
 	}
+}
 
-	X11::setWindowBackgroundPixmap(_title_wo.getWindow(),
-				       title_bg.getDrawable());
-	X11::clearWindow(_title_wo.getWindow());
+/**
+ * Get key identifying the title rendering in the given focused state,
+ * includes everything but the theme data that is handled by clearing the
+ * cache when the decor is loaded.
+ */
+std::string
+PDecor::getTitleCacheKey(FocusedState fstate) const
+{
+	std::ostringstream key;
+	key << _data << ' ' << getFont(fstate)
+	    << ' ' << getFont(getFocusedState(true)) << ' '
+	    << _title_wo.getWidth() << 'x' << _title_wo.getHeight()
+	    << ' ' << _titles_left << ' ' << _title_active;
+	std::vector<PDecor::TitleItem*>::const_iterator it(_titles.begin());
+	for (; it != _titles.end(); ++it) {
+		key << ' ' << (*it)->getWidth()
+		    << ' ' << getTitleTrim(*it)
+		    << ' ' << (*it)->getVisible().size()
+		    << ':' << (*it)->getVisible();
+	}
+	return key.str();
+}
+
+PFont::TrimType
+PDecor::getTitleTrim(PDecor::TitleItem *title)
+{
+	if (title->isCustom() || title->isUserSet()) {
+		return PFont::FONT_TRIM_END;
+	}
+	return PFont::FONT_TRIM_MIDDLE;
 }
 
 void
@@ -1521,126 +1571,55 @@ PDecor::setBorderShape(void)
 #endif // PEKWM_HAVE_SHAPE
 }
 
+/**
+ * Snap gm against other frames and head edges, only updates gm.
+ */
 void
 PDecor::checkSnap(PWinObj *skip_wo, Geometry &gm)
 {
-	Config *cfg = pekwm::config();
-	if (cfg->getWOAttract() > 0 || cfg->getWOResist() > 0) {
-		checkWOSnap(skip_wo, gm);
-	}
-	if (cfg->getEdgeAttract() > 0 || cfg->getEdgeResist() > 0) {
-		checkEdgeSnap(gm);
-	}
-}
-
-inline bool
-isBetween(int x1, int x2, int t1, int t2)
-{
-	if (x1 > t1) {
-		if (x1 < t2) {
-			return true;
-		}
-	} else if (x2 > t1) {
-		return true;
-	}
-	return false;
+	SnapIndex index;
+	buildSnapIndex(skip_wo, index);
+	index.snap(gm);
 }
 
-//! @todo PDecor/PWinObj doesn't have _skip property
+/**
+ * Build index with mapped frames, except skip_wo, and head edges used
+ * for snapping. Frames are added in reverse creation order.
+ */
 void
-PDecor::checkWOSnap(const PWinObj *skip_wo, Geometry &gm)
+PDecor::buildSnapIndex(const PWinObj *skip_wo, SnapIndex &index)
 {
-	PDecor *decor;
-	Geometry orig_gm = gm;
-
-	int x = gm.x + gm.width;
-	int y = gm.y + gm.height;
-
-	int attract = pekwm::config()->getWOAttract();
-	int resist = pekwm::config()->getWOResist();
-
-	bool snapped;
-
-	std::vector<PWinObj*>::reverse_iterator it = _wo_list.rbegin();
-	for (; it != _wo_list.rend(); ++it) {
-		if (((*it) == skip_wo)
-		    || ! (*it)->isMapped()
-		    || ((*it)->getType() != PWinObj::WO_FRAME)) {
-			continue;
-		}
-
-		// Skip snapping, only valid on PDecor and up.
-		decor = dynamic_cast<PDecor*>(*it);
-		if (decor && decor->isSkip(SKIP_SNAP)) {
-			continue;
-		}
-
-		snapped = false;
+	Config *cfg = pekwm::config();
+	index.reset(cfg->getWOAttract(), cfg->getWOResist(),
+		    cfg->getEdgeAttract(), cfg->getEdgeResist());
 
-		// check snap
-		if ((x >= ((*it)->getX() - attract))
-		    && (x <= ((*it)->getX() + resist))) {
-			if (isBetween(gm.y, y,
-				      (*it)->getY(), (*it)->getBY())) {
-				gm.x = (*it)->getX() - orig_gm.width;
-				snapped = true;
-			}
-		} else if ((gm.x >= signed((*it)->getRX() - resist)) &&
-			   (gm.x <= signed((*it)->getRX() + attract))) {
-			if (isBetween(gm.y, y,
-				      (*it)->getY(), (*it)->getBY())) {
-				gm.x = (*it)->getRX();
-				snapped = true;
+	if (cfg->getWOAttract() > 0 || cfg->getWOResist() > 0) {
+		std::vector<PWinObj*>::reverse_iterator it = _wo_list.rbegin();
+		for (; it != _wo_list.rend(); ++it) {
+			if (((*it) == skip_wo)
+			    || ! (*it)->isMapped()
+			    || ((*it)->getType() != PWinObj::WO_FRAME)) {
+				continue;
 			}
-		}
 
-		if (y >= ((*it)->getY() - attract)
-		    && (y <= (*it)->getY() + resist)) {
-			if (isBetween(gm.x, x,
-				      (*it)->getX(), (*it)->getRX())) {
-				gm.y = (*it)->getY() - orig_gm.height;
-				if (snapped)
-					break;
-			}
-		} else if ((gm.y >= signed((*it)->getBY() - resist)) &&
-			   (gm.y <= signed((*it)->getBY() + attract))) {
-			if (isBetween(gm.x, x,
-				      (*it)->getX(), (*it)->getRX())) {
-				gm.y = (*it)->getBY();
-				if (snapped)
-					break;
+			// Skip snapping, only valid on PDecor and up.
+			PDecor *decor = static_cast<PDecor*>(*it);
+			if (! decor->isSkip(SKIP_SNAP)) {
+				index.addWO(decor->getGeometry());
 			}
 		}
+		index.finalize();
 	}
-}
 
-//! @brief Snaps decor agains head edges. Only updates _gm, no real move.
-//! @todo Add support for checking for harbour and struts
-void
-PDecor::checkEdgeSnap(Geometry &gm)
-{
-	int attract = pekwm::config()->getEdgeAttract();
-	int resist = pekwm::config()->getEdgeResist();
-
-	Geometry head;
-	pekwm::rootWo()->getHeadInfoWithEdge(X11::getNearestHead(gm.x, gm.y),
-					     head);
-
-	if ((gm.x >= (head.x - resist)) && (gm.x <= (head.x + attract))) {
-		gm.x = head.x;
-	} else if ((gm.x + gm.width) >= (head.x + head.width - attract) &&
-		   ((gm.x + gm.width) <= (head.x + head.width + resist))) {
-		gm.x = head.x + head.width - gm.width;
-	}
-	if ((gm.y >= (head.y - resist)) && (gm.y <= (head.y + attract))) {
-		gm.y = head.y;
-	} else if (((gm.y + gm.height) >= (head.y + head.height - attract)) &&
-		   ((gm.y + gm.height) <= (head.y + head.height + resist))) {
-		gm.y = head.y + head.height - gm.height;
+	if (cfg->getEdgeAttract() > 0 || cfg->getEdgeResist() > 0) {
+		for (int i = 0; i < X11::getNumHeads(); i++) {
+			Geometry head;
+			pekwm::rootWo()->getHeadInfoWithEdge(i, head);
+			index.addHead(head);
+		}
 	}
 }
 
-
 /**
  * Move child into position with regards to title and border.
  */
@@ -12,6 +12,7 @@
 #include "config.h"
 
 #include "Config.hh"
+#include "SnapIndex.hh"
 #include "tk/PWinObj.hh"
 #include "tk/PPixmapSurface.hh"
 #include "ThemeGm.hh"
@@ -322,6 +323,7 @@ public:
 
 	static void drawOutline(const Geometry &gm, uint shaded);
 	static void checkSnap(PWinObj *skip_wo, Geometry &gm);
+	static void buildSnapIndex(const PWinObj *skip_wo, SnapIndex &index);
 
 protected:
 	// START - PDecor interface.
@@ -348,9 +350,6 @@ protected:
 
 	void resizeTitle(void);
 
-	static void checkWOSnap(const PWinObj *skip_wo, Geometry &gm);
-	static void checkEdgeSnap(Geometry &gm);
-
 	void alignChild(PWinObj *child);
 
 	FocusedState getFocusedState(bool selected) const {
@@ -443,6 +442,9 @@ protected:
 	Window _border_win[BORDER_NO_POS]; /** Array of border windows. */
 
 private:
+	void renderTitle(PPixmapSurface &title_bg, FocusedState fstate);
+	std::string getTitleCacheKey(FocusedState fstate) const;
+	static PFont::TrimType getTitleTrim(PDecor::TitleItem *title);
 	void renderTitleTextBackground(PPixmapSurface &title_bg, PFont *font,
 				       int x, uint width,
 				       const std::string &text,
@@ -477,6 +479,14 @@ private:
 	std::vector<PDecor::TitleItem*> _titles;
 	uint _titles_left, _titles_right; // area where to put titles
 
+	/** Number of focused states the title is cached in, focused and
+	    unfocused. */
+	static const uint TITLE_BG_STATES = FOCUSED_STATE_UNFOCUSED + 1;
+	/** Rendered title, one per focused state. */
+	PPixmapSurface _title_bg[TITLE_BG_STATES];
+	/** Key identifying what is rendered in _title_bg. */
+	std::string _title_bg_key[TITLE_BG_STATES];
+
 	static std::vector<PDecor*> _pdecors; /**< List of all PDecors */
 };
 
@@ -227,7 +227,7 @@ PMenu::handleButtonPress(XButtonEvent *ev)
 		_pointer_y = ev->y_root;
 
 		Config* cfg = pekwm::config();
-		std::vector<ActionEvent> *malm =
+		ActionEventList *malm =
 			cfg->getMouseActionList(MOUSE_ACTION_LIST_MENU);
 		return ActionHandler::findMouseAction(ev->button, ev->state,
 						      MOUSE_EVENT_PRESS, malm);
@@ -267,7 +267,7 @@ PMenu::handleButtonRelease(XButtonEvent *ev)
 
 		handleItemEvent(mb, ev->x, ev->y);
 
-		std::vector<ActionEvent> *malm =
+		ActionEventList *malm =
 			cfg->getMouseActionList(MOUSE_ACTION_LIST_MENU);
 		return ActionHandler::findMouseAction(ev->button, ev->state,
 						      mb, malm);
@@ -330,7 +330,7 @@ PMenu::handleMotionEvent(XMotionEvent *ev)
 		ActionEvent *ae;
 		X11::stripButtonModifiers(&ev->state);
 		Config* cfg = pekwm::config();
-		std::vector<ActionEvent> *malm =
+		ActionEventList *malm =
 			cfg->getMouseActionList(MOUSE_ACTION_LIST_MENU);
 		ae = ActionHandler::findMouseAction(button, ev->state,
 						    MOUSE_EVENT_MOTION, malm);
@@ -355,7 +355,7 @@ PMenu::handleEnterEvent(XCrossingEvent *ev)
 {
 	if (*_menu_wo == ev->window) {
 		Config* cfg = pekwm::config();
-		std::vector<ActionEvent> *malm =
+		ActionEventList *malm =
 			cfg->getMouseActionList(MOUSE_ACTION_LIST_MENU);
 		return ActionHandler::findMouseAction(BUTTON_ANY, ev->state,
 						      MOUSE_EVENT_ENTER, malm);
@@ -369,7 +369,7 @@ PMenu::handleLeaveEvent(XCrossingEvent *ev)
 {
 	if (*_menu_wo == ev->window) {
 		Config* cfg = pekwm::config();
-		std::vector<ActionEvent> *malm =
+		ActionEventList *malm =
 			cfg->getMouseActionList(MOUSE_ACTION_LIST_MENU);
 		return ActionHandler::findMouseAction(BUTTON_ANY, ev->state,
 						      MOUSE_EVENT_LEAVE, malm);
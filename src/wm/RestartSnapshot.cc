@@ -0,0 +1,253 @@
+//
+// RestartSnapshot.cc for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#include "RestartSnapshot.hh"
+#include "CtrlSocket.hh"
+#include "Debug.hh"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+}
+
+static const char SNAPSHOT_MAGIC[8] = {
+	'P', 'E', 'K', 'W', 'M', 'R', 'S', '2'
+};
+
+const time_t RestartSnapshot::MAX_AGE_S = 60;
+
+/**
+ * On disk format, native byte order as the snapshot never leaves the
+ * host. Atoms are stored by name as the AtomName enum may differ
+ * between the pekwm versions restarting into each other:
+ *
+ *   magic[8] time:int64 windows:uint32
+ *   windows * (window:uint32 hints:uint32
+ *              hints * (name_len:uint32 name[name_len]
+ *                       is_set:uint32 value:int64))
+ */
+static void
+putU32(std::vector<char> &buf, uint32_t val)
+{
+	buf.insert(buf.end(), reinterpret_cast<const char*>(&val),
+		   reinterpret_cast<const char*>(&val) + sizeof(val));
+}
+
+static void
+putI64(std::vector<char> &buf, int64_t val)
+{
+	buf.insert(buf.end(), reinterpret_cast<const char*>(&val),
+		   reinterpret_cast<const char*>(&val) + sizeof(val));
+}
+
+static void
+putStr(std::vector<char> &buf, const char *str)
+{
+	size_t len = strlen(str);
+	putU32(buf, len);
+	buf.insert(buf.end(), str, str + len);
+}
+
+template<typename T>
+static bool
+get(const std::vector<char> &buf, size_t &pos, T &val)
+{
+	if (pos + sizeof(T) > buf.size()) {
+		return false;
+	}
+	memcpy(&val, &buf[pos], sizeof(T));
+	pos += sizeof(T);
+	return true;
+}
+
+static bool
+getStr(const std::vector<char> &buf, size_t &pos, std::string &str)
+{
+	uint32_t len;
+	if (! get(buf, pos, len) || len > buf.size() - pos) {
+		return false;
+	}
+	str.assign(&buf[pos], len);
+	pos += len;
+	return true;
+}
+
+RestartSnapshot::RestartSnapshot(void)
+{
+}
+
+RestartSnapshot::~RestartSnapshot(void)
+{
+}
+
+void
+RestartSnapshot::add(Window win, const hint_map &hints)
+{
+	if (! hints.empty()) {
+		_windows[win] = hints;
+	}
+}
+
+/**
+ * Get snapshot hints for win, nullptr if window is not in snapshot.
+ */
+const RestartSnapshot::hint_map*
+RestartSnapshot::find(Window win) const
+{
+	std::map<Window, hint_map>::const_iterator it = _windows.find(win);
+	return it == _windows.end() ? nullptr : &it->second;
+}
+
+/**
+ * Load snapshot from path, fails on malformed or stale snapshots
+ * leaving the snapshot empty.
+ */
+bool
+RestartSnapshot::load(const std::string &path)
+{
+	_windows.clear();
+
+	// the snapshot may be in /tmp, only trust files owned by us.
+	int fd = open(path.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+	struct stat st;
+	if (fd == -1) {
+		return false;
+	} else if (fstat(fd, &st) == -1 || st.st_uid != getuid()) {
+		P_LOG("ignoring restart snapshot " << path << ", bad owner");
+		close(fd);
+		return false;
+	}
+	FILE *fp = fdopen(fd, "rb");
+	if (fp == nullptr) {
+		close(fd);
+		return false;
+	}
+	std::vector<char> buf;
+	char chunk[4096];
+	size_t n;
+	while ((n = fread(chunk, 1, sizeof(chunk), fp)) > 0) {
+		buf.insert(buf.end(), chunk, chunk + n);
+	}
+	fclose(fp);
+
+	if (buf.size() < sizeof(SNAPSHOT_MAGIC)
+	    || memcmp(&buf[0], SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC))) {
+		P_LOG("ignoring restart snapshot " << path << ", bad magic");
+		return false;
+	}
+
+	size_t pos = sizeof(SNAPSHOT_MAGIC);
+	int64_t timestamp;
+	uint32_t num_windows;
+	if (! get(buf, pos, timestamp) || ! get(buf, pos, num_windows)) {
+		return false;
+	}
+	time_t now = time(nullptr);
+	if (timestamp > now || now - timestamp > MAX_AGE_S) {
+		P_LOG("ignoring stale restart snapshot " << path);
+		return false;
+	}
+
+	for (uint32_t i = 0; i < num_windows; i++) {
+		uint32_t win, num_hints;
+		if (! get(buf, pos, win) || ! get(buf, pos, num_hints)) {
+			_windows.clear();
+			return false;
+		}
+
+		hint_map &hints = _windows[win];
+		for (uint32_t j = 0; j < num_hints; j++) {
+			std::string name;
+			uint32_t is_set;
+			int64_t value;
+			if (! getStr(buf, pos, name) || ! get(buf, pos, is_set)
+			    || ! get(buf, pos, value)) {
+				_windows.clear();
+				return false;
+			}
+			// hints unknown to this version are skipped.
+			AtomName aname = X11::getAtomName(name);
+			if (aname != MAX_NR_ATOMS) {
+				hints[aname] = Hint(is_set != 0, value);
+			}
+		}
+	}
+
+	return true;
+}
+
+bool
+RestartSnapshot::save(const std::string &path) const
+{
+	std::vector<char> buf(SNAPSHOT_MAGIC,
+			      SNAPSHOT_MAGIC + sizeof(SNAPSHOT_MAGIC));
+	putI64(buf, time(nullptr));
+	putU32(buf, _windows.size());
+
+	std::map<Window, hint_map>::const_iterator it = _windows.begin();
+	for (; it != _windows.end(); ++it) {
+		putU32(buf, it->first);
+		size_t num_pos = buf.size();
+		putU32(buf, 0);
+		uint32_t num_hints = 0;
+		hint_map::const_iterator h_it = it->second.begin();
+		for (; h_it != it->second.end(); ++h_it) {
+			const char *name = X11::getAtomNameString(h_it->first);
+			if (name == nullptr) {
+				continue;
+			}
+			num_hints++;
+			putStr(buf, name);
+			putU32(buf, h_it->second.is_set ? 1 : 0);
+			putI64(buf, h_it->second.value);
+		}
+		memcpy(&buf[num_pos], &num_hints, sizeof(num_hints));
+	}
+
+	unlink(path.c_str());
+	int fd = open(path.c_str(),
+		      O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC,
+		      0600);
+	FILE *fp = fd == -1 ? nullptr : fdopen(fd, "wb");
+	if (fp == nullptr) {
+		P_WARN("failed to open restart snapshot " << path);
+		if (fd != -1) {
+			close(fd);
+		}
+		return false;
+	}
+	bool ok = fwrite(&buf[0], 1, buf.size(), fp) == buf.size();
+	ok = fclose(fp) == 0 && ok;
+	if (! ok) {
+		P_WARN("failed to write restart snapshot " << path);
+		unlink(path.c_str());
+	}
+	return ok;
+}
+
+/**
+ * Get path of the restart snapshot for display, placed next to the
+ * control socket.
+ */
+std::string
+RestartSnapshot::path(const std::string &display)
+{
+	std::string path = CtrlSocket::path(display);
+	std::string::size_type pos = path.rfind(".sock");
+	if (pos != std::string::npos) {
+		path.erase(pos);
+	}
+	return path + ".restart";
+}
@@ -0,0 +1,67 @@
+//
+// RestartSnapshot.hh for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#ifndef _PEKWM_RESTART_SNAPSHOT_HH_
+#define _PEKWM_RESTART_SNAPSHOT_HH_
+
+#include "config.h"
+
+#include "X11.hh"
+
+#include <map>
+#include <string>
+
+/**
+ * Snapshot of the pekwm owned hints (_PEKWM_FRAME_ID etc) on client
+ * windows, written on restart so the new process can rebuild frames
+ * without reading the hints back from every window.
+ *
+ * Only hints with a known state are included, hints not in the
+ * snapshot are read from the window as usual.
+ */
+class RestartSnapshot {
+public:
+	/** Known state of a hint, is_set false if not set on window. */
+	class Hint {
+	public:
+		Hint(void)
+			: is_set(false),
+			  value(0)
+		{
+		}
+		Hint(bool is_set_, Cardinal value_)
+			: is_set(is_set_),
+			  value(value_)
+		{
+		}
+
+		bool is_set;
+		Cardinal value;
+	};
+	typedef std::map<AtomName, Hint> hint_map;
+
+	/** Snapshots older than this are ignored. */
+	static const time_t MAX_AGE_S;
+
+	RestartSnapshot(void);
+	~RestartSnapshot(void);
+
+	size_t size(void) const { return _windows.size(); }
+	void add(Window win, const hint_map &hints);
+	const hint_map *find(Window win) const;
+
+	bool load(const std::string &path);
+	bool save(const std::string &path) const;
+
+	static std::string path(const std::string &display);
+
+private:
+	std::map<Window, hint_map> _windows;
+};
+
+#endif // _PEKWM_RESTART_SNAPSHOT_HH_
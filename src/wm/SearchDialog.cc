@@ -11,17 +11,22 @@
 #include "SearchDialog.hh"
 
 #include "Client.hh"
+#include "Frame.hh"
 #include "RegexString.hh"
+#include "Workspaces.hh"
 
-#include <iostream>
-#include <list>
+#include <map>
+
+/** Maximum number of results displayed in the result menu. */
+static const size_t SEARCH_RESULTS_MAX = 20;
 
 /**
  * SearchDialog constructor.
  */
 SearchDialog::SearchDialog()
 	: InputDialog("Search"),
-	  _result_menu(0)
+	  _result_menu(0),
+	  _clients_gen(0)
 {
 	_type = PWinObj::WO_SEARCH_DIALOG;
 
@@ -109,9 +114,10 @@ SearchDialog::updateSize(const Geometry &head)
 }
 
 /**
- * Search list of clients for matching titles.
+ * Search list of clients for matching titles, the best matches are
+ * displayed first.
  *
- * @param search Regexp to search, case insensitive
+ * @param search Characters to find in order or /regex/, case insensitive
  * @return Number of matches
  */
 uint
@@ -121,29 +127,34 @@ SearchDialog::findClients(const std::string &search)
 	if (_previous_search == search) {
 		return _result_menu->size();
 	}
-	_previous_search = search;
-
-	_result_menu->removeAll();
-	if (search.size() > 0) {
-		RegexString search_re("/" + search + "/i");
-		if (! search_re.is_match_ok()) {
-			return 0;
-		}
 
-		std::vector<Client*> matches;
-		Client::client_cit it(Client::client_begin());
-		for (; it != Client::client_end(); ++it) {
-			if ((*it)->isFocusable()
-			    && ! (*it)->isSkip(SKIP_FOCUS_TOGGLE)
-			    && search_re == (*it)->getTitle()->getReal()) {
-				matches.push_back(*it);
-			}
+	std::vector<void*> matches;
+	uint num;
+	if (search.size() > 1 && search[0] == '/'
+	    && search[search.size() - 1] == '/') {
+		_matcher.clear();
+		findClientsRegex(search, matches);
+		num = matches.size();
+	} else {
+		// Matches are narrowed while characters are appended,
+		// reload candidates when the search is edited or the
+		// clients change.
+		if (_matcher.getQuery().empty()
+		    || search.compare(0, _previous_search.size(),
+				      _previous_search) != 0
+		    || _clients_gen != Client::client_gen()) {
+			loadClients();
 		}
+		num = _matcher.match(search, SEARCH_RESULTS_MAX, matches);
+	}
+	_previous_search = search;
 
-		for (it = matches.begin(); it != matches.end(); ++it) {
-			_result_menu->insert((*it)->getTitle()->getVisible(),
-					     false, *it, (*it)->getIcon());
-		}
+	_result_menu->removeAll();
+	std::vector<void*>::iterator it(matches.begin());
+	for (; it != matches.end(); ++it) {
+		Client *client = static_cast<Client*>(*it);
+		_result_menu->insert(client->getTitle()->getVisible(),
+				     false, client, client->getIcon());
 	}
 
 	// Rebuild menu and make room for it
@@ -167,7 +178,62 @@ SearchDialog::findClients(const std::string &search)
 		X11::lowerWindow(_result_menu->getWindow());
 	}
 
-	return 0;
+	return num;
+}
+
+/**
+ * Search clients with titles matching the /regex/ in search, case
+ * insensitive.
+ */
+void
+SearchDialog::findClientsRegex(const std::string &search,
+			       std::vector<void*> &matches)
+{
+	RegexString search_re(search + "i");
+	if (! search_re.is_match_ok()) {
+		return;
+	}
+
+	Client::client_cit it(Client::client_begin());
+	for (; it != Client::client_end()
+		     && matches.size() < SEARCH_RESULTS_MAX; ++it) {
+		if ((*it)->isFocusable()
+		    && ! (*it)->isSkip(SKIP_FOCUS_TOGGLE)
+		    && search_re == (*it)->getTitle()->getReal()) {
+			matches.push_back(*it);
+		}
+	}
+}
+
+/**
+ * Load clients that can be searched for into the matcher together
+ * with their position in the MRU list.
+ */
+void
+SearchDialog::loadClients(void)
+{
+	std::map<PWinObj*, uint> mru;
+	std::vector<Frame*>::iterator mit(Workspaces::mru_begin());
+	for (uint i = 0; mit != Workspaces::mru_end(); ++mit, ++i) {
+		mru[*mit] = i;
+	}
+
+	_matcher.clear();
+	_clients_gen = Client::client_gen();
+
+	Client::client_cit it(Client::client_begin());
+	for (; it != Client::client_end(); ++it) {
+		if (! (*it)->isFocusable()
+		    || (*it)->isSkip(SKIP_FOCUS_TOGGLE)) {
+			continue;
+		}
+
+		std::map<PWinObj*, uint>::iterator pos =
+			mru.find((*it)->getParent());
+		_matcher.add(*it, (*it)->getTitle()->getReal(),
+			     pos == mru.end()
+			     ? SearchMatcher::MRU_NONE : pos->second);
+	}
 }
 
 /**
@@ -184,6 +250,7 @@ SearchDialog::unmapWindow(void)
 		// Clear the menu and hide it.
 		X11::clearWindow(_result_menu->getWindow());
 		_previous_search = "";
+		_matcher.clear();
 		X11::lowerWindow(_result_menu->getWindow());
 	}
 }
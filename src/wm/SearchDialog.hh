@@ -15,6 +15,7 @@
 
 #include "InputDialog.hh"
 #include "PMenu.hh"
+#include "SearchMatcher.hh"
 
 #include <string>
 
@@ -44,10 +45,17 @@ private:
 	SearchDialog& operator=(const SearchDialog&);
 
 	uint findClients(const std::string &search);
+	void findClientsRegex(const std::string &search,
+			      std::vector<void*> &matches);
+	void loadClients(void);
 
 	PMenu *_result_menu; /**< Menu for displaying results. */
 	/** Buffer with previous search string. */
 	std::string _previous_search;
+	/** Clients matched by the search, narrowed as the search grows. */
+	SearchMatcher _matcher;
+	/** Client generation the matcher candidates were loaded from. */
+	uint _clients_gen;
 };
 
 #endif // _PEKWM_SEARCHDIALOG_HH_
@@ -0,0 +1,232 @@
+//
+// SearchMatcher.cc for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#include "config.h"
+
+#include "Charset.hh"
+#include "SearchMatcher.hh"
+
+#include <algorithm>
+
+/** Bonus for every matched character. */
+static const int SCORE_CHAR = 1;
+/** Bonus for a character directly following the previous match. */
+static const int SCORE_CONSECUTIVE = 5;
+/** Bonus for a character starting a word. */
+static const int SCORE_WORD = 8;
+/** Bonus for a match starting at the beginning of the title. */
+static const int SCORE_PREFIX = 10;
+/** Maximum penalty for a gap between two matched characters. */
+static const int SCORE_GAP_MAX = 3;
+/** Number of MRU positions given a bonus, most recent gets the most. */
+static const uint SCORE_MRU = 10;
+
+const int SearchMatcher::NO_MATCH;
+const uint SearchMatcher::MRU_NONE;
+
+static bool
+is_word_start(const std::string &str, size_t pos)
+{
+	if (pos == 0) {
+		return true;
+	}
+	int chr = static_cast<unsigned char>(str[pos - 1]);
+	return ! ((chr >= 'a' && chr <= 'z') || (chr >= '0' && chr <= '9')
+		  || chr >= 0x80);
+}
+
+static void
+split_chars(const std::string &str, std::vector<std::string> &chars)
+{
+	Charset::Utf8Iterator it(str);
+	for (; ! it.end(); ++it) {
+		chars.push_back(*it);
+	}
+}
+
+SearchMatcher::Entry::Entry(void *data_, const std::string &title_,
+			    uint mru_)
+	: data(data_),
+	  title(Charset::toLower(title_)),
+	  mru(mru_),
+	  score(NO_MATCH)
+{
+}
+
+SearchMatcher::SearchMatcher()
+{
+}
+
+SearchMatcher::~SearchMatcher()
+{
+}
+
+/**
+ * Remove all candidates.
+ */
+void
+SearchMatcher::clear()
+{
+	_entries.clear();
+	_matches.clear();
+	_query.clear();
+}
+
+/**
+ * Add candidate, resets the previous matches as the candidates changed.
+ */
+void
+SearchMatcher::add(void *data, const std::string &title, uint mru)
+{
+	_entries.push_back(Entry(data, title, mru));
+	_matches.clear();
+	_query.clear();
+}
+
+/**
+ * Match candidates against query, narrowing the previous matches if
+ * query extends the previous query.
+ *
+ * @param query Query to match.
+ * @param max Maximum number of results, best first.
+ * @param result Filled in with data of the best matches.
+ * @return Total number of matches.
+ */
+size_t
+SearchMatcher::match(const std::string &query, size_t max,
+		     std::vector<void*> &result)
+{
+	result.clear();
+	if (query.empty()) {
+		_query.clear();
+		_matches.clear();
+		return 0;
+	}
+
+	std::string query_lower(Charset::toLower(query));
+	std::vector<Entry*> candidates;
+	if (! _query.empty()
+	    && query_lower.compare(0, _query.size(), _query) == 0) {
+		candidates.swap(_matches);
+	} else {
+		_matches.clear();
+		std::vector<Entry>::iterator it(_entries.begin());
+		for (; it != _entries.end(); ++it) {
+			candidates.push_back(&*it);
+		}
+	}
+	_query = query_lower;
+
+	std::vector<std::string> chars;
+	split_chars(_query, chars);
+	std::vector<Entry*>::iterator it(candidates.begin());
+	for (; it != candidates.end(); ++it) {
+		int score = SearchMatcher::score(chars, (*it)->title);
+		if (score == NO_MATCH) {
+			continue;
+		}
+		if ((*it)->mru < SCORE_MRU) {
+			score += SCORE_MRU - (*it)->mru;
+		}
+		(*it)->score = score;
+		_matches.push_back(*it);
+	}
+
+	// only the visible results need to be ordered
+	std::vector<Entry*> sorted(_matches);
+	size_t num = std::min(max, sorted.size());
+	std::partial_sort(sorted.begin(), sorted.begin() + num, sorted.end(),
+			  cmpEntry);
+	for (size_t i = 0; i < num; i++) {
+		result.push_back(sorted[i]->data);
+	}
+	return _matches.size();
+}
+
+/**
+ * Score how well query matches title, both expected to be lowercase.
+ *
+ * @return Score, 0 or higher with higher being better, or NO_MATCH.
+ */
+int
+SearchMatcher::score(const std::string &query, const std::string &title)
+{
+	std::vector<std::string> chars;
+	split_chars(query, chars);
+	return score(chars, title);
+}
+
+/**
+ * Score how well the UTF-8 characters in query matches title, matching
+ * a character at a time keeps multi-byte characters from matching
+ * parts of other characters.
+ */
+int
+SearchMatcher::score(const std::vector<std::string> &query,
+		     const std::string &title)
+{
+	if (query.empty()) {
+		return NO_MATCH;
+	}
+
+	int best = NO_MATCH;
+	size_t start = title.find(query[0]);
+	for (; start != std::string::npos;
+	     start = title.find(query[0], start + query[0].size())) {
+		int score = SCORE_CHAR;
+		if (is_word_start(title, start)) {
+			score += SCORE_WORD;
+		}
+		if (start == 0) {
+			score += SCORE_PREFIX;
+		}
+
+		size_t end = start + query[0].size();
+		for (size_t i = 1; i < query.size(); i++) {
+			size_t pos = title.find(query[i], end);
+			if (pos == std::string::npos) {
+				// a later start can not match either
+				return best;
+			}
+
+			score += SCORE_CHAR;
+			if (pos == end) {
+				score += SCORE_CONSECUTIVE;
+			} else {
+				int gap = static_cast<int>(pos - end);
+				score -= std::min(gap, SCORE_GAP_MAX);
+			}
+			if (is_word_start(title, pos)) {
+				score += SCORE_WORD;
+			}
+			end = pos + query[i].size();
+		}
+
+		score = std::max(score, 0);
+		if (score > best) {
+			best = score;
+		}
+	}
+	return best;
+}
+
+/**
+ * Order by score, most recently used and the order candidates were
+ * added.
+ */
+bool
+SearchMatcher::cmpEntry(const Entry *lhs, const Entry *rhs)
+{
+	if (lhs->score != rhs->score) {
+		return lhs->score > rhs->score;
+	}
+	if (lhs->mru != rhs->mru) {
+		return lhs->mru < rhs->mru;
+	}
+	return lhs < rhs;
+}
@@ -0,0 +1,72 @@
+//
+// SearchMatcher.hh for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#ifndef _PEKWM_SEARCHMATCHER_HH_
+#define _PEKWM_SEARCHMATCHER_HH_
+
+#include "config.h"
+
+#include "pekwm.hh"
+
+#include <string>
+#include <vector>
+
+/**
+ * Incremental fuzzy matcher used by the SearchDialog.
+ *
+ * Candidates match if all characters of the query appear in order,
+ * case insensitive, in the title. As a query extending the previous
+ * query can only match a subset of the previous matches, only those
+ * are tested when characters are appended.
+ */
+class SearchMatcher {
+public:
+	/** No match, returned by score. */
+	static const int NO_MATCH = -1;
+	/** MRU position of candidates not in the MRU list. */
+	static const uint MRU_NONE = static_cast<uint>(-1);
+
+	class Entry {
+	public:
+		Entry(void *data_, const std::string &title_, uint mru_);
+
+		void *data;
+		/** Lowercase title used for matching. */
+		std::string title;
+		/** Position in the MRU list, 0 being most recently used. */
+		uint mru;
+		int score;
+	};
+
+	SearchMatcher();
+	~SearchMatcher();
+
+	void clear();
+	void add(void *data, const std::string &title, uint mru = MRU_NONE);
+
+	const std::string &getQuery() const { return _query; }
+	size_t size() const { return _matches.size(); }
+
+	size_t match(const std::string &query, size_t max,
+		     std::vector<void*> &result);
+
+	static int score(const std::string &query, const std::string &title);
+
+private:
+	static int score(const std::vector<std::string> &query,
+			 const std::string &title);
+	static bool cmpEntry(const Entry *lhs, const Entry *rhs);
+
+	std::vector<Entry> _entries;
+	/** Query _matches was created from. */
+	std::string _query;
+	/** Entries matching _query, not sorted. */
+	std::vector<Entry*> _matches;
+};
+
+#endif // _PEKWM_SEARCHMATCHER_HH_
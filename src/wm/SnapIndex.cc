@@ -0,0 +1,186 @@
+//
+// SnapIndex.cc for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#include "SnapIndex.hh"
+#include "X11.hh"
+
+#include <algorithm>
+
+/**
+ * Check if the range x1 to x2 overlaps t1 to t2.
+ */
+static bool
+isBetween(int x1, int x2, int t1, int t2)
+{
+	if (x1 > t1) {
+		if (x1 < t2) {
+			return true;
+		}
+	} else if (x2 > t1) {
+		return true;
+	}
+	return false;
+}
+
+SnapIndex::SnapIndex()
+	: _wo_attract(0),
+	  _wo_resist(0),
+	  _edge_attract(0),
+	  _edge_resist(0)
+{
+}
+
+SnapIndex::~SnapIndex()
+{
+}
+
+/**
+ * Clear index and set distances used when snapping.
+ */
+void
+SnapIndex::reset(int wo_attract, int wo_resist,
+		 int edge_attract, int edge_resist)
+{
+	_wo_attract = wo_attract;
+	_wo_resist = wo_resist;
+	_edge_attract = edge_attract;
+	_edge_resist = edge_resist;
+
+	_left.clear();
+	_right.clear();
+	_top.clear();
+	_bottom.clear();
+	_heads.clear();
+}
+
+/**
+ * Add window to snap against, if multiple windows are within the snap
+ * distance the one added first is used.
+ */
+void
+SnapIndex::addWO(const Geometry &gm)
+{
+	uint order = _left.size();
+	int rx = gm.x + gm.width;
+	int by = gm.y + gm.height;
+	_left.push_back(Edge(gm.x, gm.y, by, order));
+	_right.push_back(Edge(rx, gm.y, by, order));
+	_top.push_back(Edge(gm.y, gm.x, rx, order));
+	_bottom.push_back(Edge(by, gm.x, rx, order));
+}
+
+void
+SnapIndex::addHead(const Geometry &head)
+{
+	_heads.push_back(head);
+}
+
+/**
+ * Sort edges, must be called after adding windows and before snap.
+ */
+void
+SnapIndex::finalize()
+{
+	std::sort(_left.begin(), _left.end());
+	std::sort(_right.begin(), _right.end());
+	std::sort(_top.begin(), _top.end());
+	std::sort(_bottom.begin(), _bottom.end());
+}
+
+/**
+ * Snap gm against windows and then head edges, only updates gm.
+ */
+void
+SnapIndex::snap(Geometry &gm) const
+{
+	if (_wo_attract > 0 || _wo_resist > 0) {
+		snapWO(gm);
+	}
+	if (_edge_attract > 0 || _edge_resist > 0) {
+		snapEdge(gm);
+	}
+}
+
+void
+SnapIndex::snapWO(Geometry &gm) const
+{
+	int x = gm.x + gm.width;
+	int y = gm.y + gm.height;
+
+	// right side of gm against left side of windows and left side of
+	// gm against right side of windows, lowest order wins.
+	const Edge *left = find(_left, x - _wo_resist, x + _wo_attract,
+				gm.y, y);
+	const Edge *right = find(_right, gm.x - _wo_attract,
+				 gm.x + _wo_resist, gm.y, y);
+	const Edge *top = find(_top, y - _wo_resist, y + _wo_attract,
+			       gm.x, x);
+	const Edge *bottom = find(_bottom, gm.y - _wo_attract,
+				  gm.y + _wo_resist, gm.x, x);
+
+	if (left && (! right || left->order <= right->order)) {
+		gm.x = left->pos - gm.width;
+	} else if (right) {
+		gm.x = right->pos;
+	}
+	if (top && (! bottom || top->order <= bottom->order)) {
+		gm.y = top->pos - gm.height;
+	} else if (bottom) {
+		gm.y = bottom->pos;
+	}
+}
+
+/**
+ * Find edge with the lowest order positioned between lo and hi overlapping
+ * start to end.
+ */
+const SnapIndex::Edge*
+SnapIndex::find(const std::vector<Edge> &edges, int lo, int hi,
+		int start, int end)
+{
+	const Edge *best = nullptr;
+	std::vector<Edge>::const_iterator it =
+		std::lower_bound(edges.begin(), edges.end(),
+				 Edge(lo, 0, 0, 0));
+	for (; it != edges.end() && it->pos <= hi; ++it) {
+		if ((best == nullptr || it->order < best->order)
+		    && isBetween(start, end, it->start, it->end)) {
+			best = &(*it);
+		}
+	}
+	return best;
+}
+
+void
+SnapIndex::snapEdge(Geometry &gm) const
+{
+	uint num = X11::getNearestHead(gm.x, gm.y);
+	if (num >= _heads.size()) {
+		return;
+	}
+	const Geometry &head = _heads[num];
+
+	if ((gm.x >= (head.x - _edge_resist))
+	    && (gm.x <= (head.x + _edge_attract))) {
+		gm.x = head.x;
+	} else if ((gm.x + gm.width)
+		   >= (head.x + head.width - _edge_attract)
+		   && ((gm.x + gm.width)
+		       <= (head.x + head.width + _edge_resist))) {
+		gm.x = head.x + head.width - gm.width;
+	}
+	if ((gm.y >= (head.y - _edge_resist))
+	    && (gm.y <= (head.y + _edge_attract))) {
+		gm.y = head.y;
+	} else if (((gm.y + gm.height)
+		    >= (head.y + head.height - _edge_attract))
+		   && ((gm.y + gm.height)
+		       <= (head.y + head.height + _edge_resist))) {
+		gm.y = head.y + head.height - gm.height;
+	}
+}
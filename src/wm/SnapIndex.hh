@@ -0,0 +1,81 @@
+//
+// SnapIndex.hh for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#ifndef _PEKWM_SNAPINDEX_HH_
+#define _PEKWM_SNAPINDEX_HH_
+
+#include "config.h"
+
+#include "Geometry.hh"
+#include "Types.hh"
+
+#include <vector>
+
+/**
+ * Index of window and head edges used when snapping a window being
+ * moved. Window edges are kept sorted on position so only the edges
+ * within the attract/resist distance are visited, built once when a
+ * move starts.
+ */
+class SnapIndex {
+public:
+	SnapIndex();
+	~SnapIndex();
+
+	void reset(int wo_attract, int wo_resist,
+		   int edge_attract, int edge_resist);
+	void addWO(const Geometry &gm);
+	void addHead(const Geometry &head);
+	void finalize();
+
+	void snap(Geometry &gm) const;
+
+	size_t numWO() const { return _left.size(); }
+
+private:
+	/** Window edge at pos, spanning start to end on the other axis. */
+	class Edge {
+	public:
+		Edge(int n_pos, int n_start, int n_end, uint n_order)
+			: pos(n_pos),
+			  start(n_start),
+			  end(n_end),
+			  order(n_order)
+		{
+		}
+
+		bool operator<(const Edge &rhs) const {
+			return pos < rhs.pos;
+		}
+
+		int pos;
+		int start;
+		int end;
+		/** Order the window was added in, lower wins. */
+		uint order;
+	};
+
+	void snapWO(Geometry &gm) const;
+	void snapEdge(Geometry &gm) const;
+	static const Edge *find(const std::vector<Edge> &edges,
+				int lo, int hi, int start, int end);
+
+	int _wo_attract;
+	int _wo_resist;
+	int _edge_attract;
+	int _edge_resist;
+
+	std::vector<Edge> _left;
+	std::vector<Edge> _right;
+	std::vector<Edge> _top;
+	std::vector<Edge> _bottom;
+	/** Head geometries, including edge, indexed on head number. */
+	std::vector<Geometry> _heads;
+};
+
+#endif // _PEKWM_SNAPINDEX_HH_
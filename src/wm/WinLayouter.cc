@@ -18,6 +18,8 @@
 #include "Workspaces.hh"
 #include "X11.hh"
 
+#include <algorithm>
+
 static Util::StringTo<WinLayouterType> win_layouter_type_map[] =
 	{{"SMART", WIN_LAYOUTER_SMART},
 	 {"CENTERED", WIN_LAYOUTER_CENTERED},
@@ -62,28 +64,139 @@ populateWvec(const PWinObj *wo, std::vector<PWinObj*> &wvec)
 	}
 }
 
-static PWinObj*
-isEmptySpace(int x, int y, const PWinObj* wo, std::vector<PWinObj*> &wvec)
+SmartPlacement::SmartPlacement(const Geometry &head, bool row, bool ltr,
+			       bool ttb)
+	: _head(head),
+	  _row(row),
+	  _ltr(ltr),
+	  _ttb(ttb)
 {
-	if (wo == nullptr) {
-		return nullptr;
+}
+
+SmartPlacement::~SmartPlacement()
+{
+}
+
+/**
+ * Add occupied space, geometries are expected to be added in stacking order
+ * as that decides which geometry is skipped when scanning.
+ */
+void
+SmartPlacement::add(const Geometry &gm)
+{
+	_rects.push_back(normalize(gm));
+}
+
+/**
+ * Find the first position, in placement order, where a geometry of the
+ * given size does not overlap any added geometry.
+ *
+ * @return true if space was found, position is set in x and y.
+ */
+bool
+SmartPlacement::find(uint width, uint height, uint offset_x, uint offset_y,
+		     int &x, int &y) const
+{
+	// space is searched with the offset included in the size, overlap
+	// is however checked without it in the direction of placement.
+	int pw = width + offset_x;
+	int ph = height + offset_y;
+	int cw = width;
+	int ch = height;
+	int dx = _ltr ? 0 : offset_x;
+	int dy = _ttb ? 0 : offset_y;
+	if (! _row) {
+		std::swap(pw, ph);
+		std::swap(cw, ch);
+		std::swap(dx, dy);
 	}
 
-	if (wvec.empty()) {
-		populateWvec(wo, wvec);
+	int nx, ny;
+	if (! findRow(normalize(_head), pw, ph, cw, ch, dx, dy, nx, ny)) {
+		return false;
 	}
 
-	for (unsigned i=0; i < wvec.size(); ++i) {
-		// Check if window is on some other windows space
-		if ((wvec[i]->getX() < signed(x + wo->getWidth())) &&
-		    (signed(wvec[i]->getX() + wvec[i]->getWidth()) > x) &&
-		    (wvec[i]->getY() < signed(y + wo->getHeight())) &&
-		    (signed(wvec[i]->getY() + wvec[i]->getHeight()) > y)) {
-			return wvec[i];
-		}
+	if (! _row) {
+		std::swap(nx, ny);
+		std::swap(pw, ph);
+	}
+	x = _ltr ? nx : 2 * _head.x + _head.width - nx - pw;
+	y = _ttb ? ny : 2 * _head.y + _head.height - ny - ph;
+	return true;
+}
+
+/**
+ * Transform geometry so that placement always is done row by row, left to
+ * right and top to bottom by mirroring on the head and swapping axis.
+ */
+SmartPlacement::Rect
+SmartPlacement::normalize(const Geometry &gm) const
+{
+	int x = _ltr ? gm.x : 2 * _head.x + _head.width - gm.rx();
+	int y = _ttb ? gm.y : 2 * _head.y + _head.height - gm.by();
+	int width = gm.width;
+	int height = gm.height;
+	if (! _row) {
+		std::swap(x, y);
+		std::swap(width, height);
+	}
+	return Rect(x, y, x + width, y + height);
+}
+
+/**
+ * Scan rows for free space, the only rows where the result can change
+ * are the ones where a geometry starts or stops overlapping the row so only
+ * these are scanned.
+ */
+bool
+SmartPlacement::findRow(const Rect &area, int pw, int ph, int cw, int ch,
+			int dx, int dy, int &x, int &y) const
+{
+	std::vector<int> rows;
+	rows.push_back(area.y);
+	std::vector<Rect>::const_iterator it(_rects.begin());
+	for (; it != _rects.end(); ++it) {
+		rows.push_back(it->by - dy);
+		rows.push_back(it->y - dy - ch + 1);
 	}
+	std::sort(rows.begin(), rows.end());
+	rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+	std::vector<const Rect*> band;
+	std::vector<int>::iterator row(rows.begin());
+	for (; row != rows.end(); ++row) {
+		if (*row < area.y || *row + ph > area.by) {
+			continue;
+		}
+
+		band.clear();
+		for (it = _rects.begin(); it != _rects.end(); ++it) {
+			if (it->y < *row + dy + ch && it->by > *row + dy) {
+				band.push_back(&*it);
+			}
+		}
+
+		int test_x = area.x;
+		while (test_x + pw <= area.rx) {
+			const Rect *hit = nullptr;
+			std::vector<const Rect*>::iterator b_it(band.begin());
+			for (; b_it != band.end(); ++b_it) {
+				if ((*b_it)->x < test_x + dx + cw
+				    && (*b_it)->rx > test_x + dx) {
+					hit = *b_it;
+					break;
+				}
+			}
 
-	return nullptr;
+			if (hit == nullptr) {
+				x = test_x;
+				y = *row;
+				return true;
+			}
+			test_x = hit->rx;
+		}
+	}
+	return false;
 }
 
 /**
@@ -99,94 +212,33 @@ private:
 	virtual bool layout(PWinObj *wo, Window parent,
 			    const Geometry &head_gm, int ptr_x, int ptr_y)
 	{
-		PWinObj *wo_e;
-		bool placed = false;
-		std::vector<PWinObj*> wvec;
 		Config* cfg = pekwm::config();
 
-		int step_x = (cfg->getPlacementLtR()) ? 1 : -1;
-		int step_y = (cfg->getPlacementTtB()) ? 1 : -1;
+		SmartPlacement placement(head_gm, cfg->getPlacementRow(),
+					 cfg->getPlacementLtR(),
+					 cfg->getPlacementTtB());
+		std::vector<PWinObj*> wvec;
+		populateWvec(wo, wvec);
+		std::vector<PWinObj*>::iterator it(wvec.begin());
+		for (; it != wvec.end(); ++it) {
+			placement.add((*it)->getGeometry());
+		}
+
+		int x, y;
+		if (! placement.find(wo->getWidth(), wo->getHeight(),
+				     cfg->getPlacementOffsetX(),
+				     cfg->getPlacementOffsetY(), x, y)) {
+			return false;
+		}
+
 		int offset_x = (cfg->getPlacementLtR())
 			? cfg->getPlacementOffsetX()
 			: -cfg->getPlacementOffsetX();
 		int offset_y = (cfg->getPlacementTtB())
 			? cfg->getPlacementOffsetY()
 			: -cfg->getPlacementOffsetY();
-		int start_x, start_y, test_x, test_y;
-
-		// Wrap these up, to get proper checking of space.
-		uint wo_width = wo->getWidth() + cfg->getPlacementOffsetX();
-		uint wo_height = wo->getHeight() + cfg->getPlacementOffsetY();
-
-		start_x = cfg->getPlacementLtR() ?
-			head_gm.x : head_gm.x + head_gm.width - wo_width;
-		start_y = cfg->getPlacementTtB() ?
-			head_gm.y : head_gm.y + head_gm.height - wo_height;
-
-		if (cfg->getPlacementRow()) { // row placement
-			test_y = start_y;
-			while (! placed
-			       && (cfg->getPlacementTtB()
-				   ? test_y + wo_height
-				     <= head_gm.y + head_gm.height
-				   : test_y >= head_gm.y)) {
-				test_x = start_x;
-				while (! placed
-				       && (cfg->getPlacementLtR()
-					   ? test_x + wo_width
-					     <= head_gm.x + head_gm.width
-					   : test_x >= head_gm.x)) {
-					// see if we can place the window here
-					wo_e = isEmptySpace(test_x, test_y,
-							    wo, wvec);
-					if (wo_e) {
-						placed = false;
-						test_x = cfg->getPlacementLtR()
-							? wo_e->getX()
-							  + wo_e->getWidth()
-							: wo_e->getX()
-							  - wo_width;
-					} else {
-						placed = true;
-						wo->move(test_x + offset_x,
-							 test_y + offset_y);
-					}
-				}
-				test_y += step_y;
-			}
-		} else { // column placement
-			test_x = start_x;
-			while (! placed
-			       && (cfg->getPlacementLtR()
-				   ? test_x + wo_width
-				     <= head_gm.x + head_gm.width
-				   : test_x >= head_gm.x)) {
-				test_y = start_y;
-				while (! placed
-				       && (cfg->getPlacementTtB()
-					   ? test_y + wo_height
-					     <= head_gm.y + head_gm.height
-					   : test_y >= head_gm.y)) {
-					// see if we can place the window here
-					wo_e = isEmptySpace(test_x, test_y,
-							    wo, wvec);
-					if (wo_e) {
-						placed = false;
-						test_y = cfg->getPlacementTtB()
-							? wo_e->getY()
-							  + wo_e->getHeight()
-							: wo_e->getY()
-							  - wo_height;
-					} else {
-						placed = true;
-						wo->move(test_x + offset_x,
-							 test_y + offset_y);
-					}
-				}
-				test_x += step_x;
-			}
-		}
-		return placed;
+		wo->move(x + offset_x, y + offset_y);
+		return true;
 	}
 };
 
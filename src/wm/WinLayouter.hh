@@ -13,6 +13,7 @@
 #include "tk/PWinObj.hh"
 
 #include <string>
+#include <vector>
 
 enum WinLayouterType {
 	WIN_LAYOUTER_SMART = (1 << 0),
@@ -45,6 +46,45 @@ private:
 	enum WinLayouterType _type;
 };
 
+/**
+ * Free space lookup used by the smart layouter. Geometries of occupied
+ * space are added up front, find then only tests positions where the set of
+ * overlapping geometries change instead of stepping one pixel at a time.
+ */
+class SmartPlacement {
+public:
+	SmartPlacement(const Geometry &head, bool row, bool ltr, bool ttb);
+	~SmartPlacement();
+
+	void add(const Geometry &gm);
+	bool find(uint width, uint height, uint offset_x, uint offset_y,
+		  int &x, int &y) const;
+
+private:
+	class Rect {
+	public:
+		Rect(int x_, int y_, int rx_, int by_)
+			: x(x_), y(y_), rx(rx_), by(by_)
+		{
+		}
+
+		int x;
+		int y;
+		int rx;
+		int by;
+	};
+
+	Rect normalize(const Geometry &gm) const;
+	bool findRow(const Rect &area, int pw, int ph, int cw, int ch,
+		     int dx, int dy, int &x, int &y) const;
+
+	Geometry _head;
+	bool _row;
+	bool _ltr;
+	bool _ttb;
+	std::vector<Rect> _rects;
+};
+
 enum WinLayouterType win_layouter_type_from_string(const std::string &name);
 
 WinLayouter *mkWinLayouter(const std::string &name);
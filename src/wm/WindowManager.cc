@@ -26,8 +26,10 @@
 #include "Util.hh"
 #include "X11.hh"
 
+#include "CtrlSocket.hh"
 #include "Os.hh"
 #include "RegexString.hh"
+#include "RestartSnapshot.hh"
 
 #include "KeyGrabber.hh"
 #include "MenuHandler.hh"
@@ -45,6 +47,7 @@
 #include "tk/PFont.hh"
 #include "tk/PTexture.hh"
 #include "tk/PWinObj.hh"
+#include "tk/StartupProfile.hh"
 #include "tk/TextureHandler.hh"
 #include "tk/Theme.hh"
 #include "tk/X11Util.hh"
@@ -134,8 +137,11 @@ WindowManager::start(const std::string &bin_dir,
 	} else {
 		P_DBG("pekwm_wm " << getpid() << " starting")
 
+		StartupProfile::phase("display");
 		wm->setupDisplay();
+		StartupProfile::phase("scan");
 		wm->scanWindows();
+		StartupProfile::phase("finish");
 		Frame::resetFrameIDs();
 
 		pekwm::rootWo()->setEwmhDesktopNames();
@@ -154,6 +160,12 @@ WindowManager::start(const std::string &bin_dir,
 		wm->execStartFile(skip_start);
 	}
 
+	if (StartupProfile::isEnabled()) {
+		StartupProfile::end();
+		StartupProfile::report(Debug::getStream(""));
+		StartupProfile::clear();
+	}
+
 	return wm;
 }
 
@@ -166,6 +178,7 @@ WindowManager::WindowManager(const std::string &bin_dir, Os *os,
 	  _reload(false),
 	  _restart(false),
 	  _select(mkOsSelect()),
+	  _ctrl(nullptr),
 	  _bg_pid(-1),
 	  _sys_process(nullptr),
 	  _event_handler(nullptr),
@@ -204,6 +217,7 @@ WindowManager::~WindowManager(void)
 	Workspaces::cleanup();
 
 	delete _sys_process;
+	delete _ctrl;
 	delete _select;
 	delete _os;
 	_wm = nullptr;
@@ -265,6 +279,10 @@ WindowManager::cleanup(void)
 		delete *it_f;
 	}
 
+	if (_restart && _restart_command.empty() && X11::getDpy()) {
+		saveRestartSnapshot();
+	}
+
 	// Delete all Clients.
 	while (Client::client_begin() != Client::client_end()) {
 		delete *Client::client_begin();
@@ -287,6 +305,21 @@ WindowManager::cleanup(void)
 	}
 }
 
+/**
+ * Write hints of all clients to the restart snapshot, read by the
+ * next process in scanWindows.
+ */
+void
+WindowManager::saveRestartSnapshot(void)
+{
+	RestartSnapshot snapshot;
+	Client::client_cit it = Client::client_begin();
+	for (; it != Client::client_end(); ++it) {
+		snapshot.add((*it)->getWindow(), (*it)->getPekwmHints());
+	}
+	snapshot.save(RestartSnapshot::path(DisplayString(X11::getDpy())));
+}
+
 /**
  * Setup display and claim resources.
  */
@@ -295,6 +328,9 @@ WindowManager::setupDisplay()
 {
 	_select->add(X11::getFd(), OsSelect::OS_SELECT_READ);
 
+	_ctrl = new CtrlServer(_select, this);
+	_ctrl->open(CtrlSocket::path(DisplayString(X11::getDpy())));
+
 	pekwm::autoProperties()->load();
 
 	Workspaces::setSize(pekwm::config()->getWorkspaces());
@@ -348,11 +384,24 @@ WindowManager::scanWindows(void)
 		}
 	}
 
+	// Re-use hints from the previous process when restarting,
+	// avoiding reading them back from every window.
+	RestartSnapshot snapshot;
+	std::string snapshot_path =
+		RestartSnapshot::path(DisplayString(X11::getDpy()));
+	if (snapshot.load(snapshot_path)) {
+		P_DBG("loaded restart snapshot with " << snapshot.size()
+		      << " windows");
+		Client::setRestartSnapshot(&snapshot);
+	}
+	unlink(snapshot_path.c_str());
+
 	for (it = win_list.begin(); it != win_list.end(); ++it) {
 		if (*it != None) {
 			createClient(*it, false);
 		}
 	}
+	Client::setRestartSnapshot(nullptr);
 
 	// Try to focus the ontop window, if no window we give root focus
 	PWinObj *wo = Workspaces::getTopFocusableWO(PWinObj::WO_FRAME);
@@ -900,14 +949,51 @@ WindowManager::getEvent(XEvent &ev)
 		ActionPerformed ap(nullptr, ae);
 		action_handler->handleAction(&ap);
 	} else if (_select->wait(tv)) {
-		if (_select->isSet(X11::getFd(),
-				   OsSelect::OS_SELECT_READ)) {
+		bool x11_ready = false;
+		int fd, mask;
+		while (_select->next(fd, mask)) {
+			if (fd == X11::getFd()) {
+				x11_ready = true;
+				continue;
+			} else if (_ctrl && _ctrl->handle(fd, mask)) {
+				continue;
+			}
+
+			std::map<int, FdHandler*>::iterator it =
+				_fd_handlers.find(fd);
+			if (it != _fd_handlers.end()) {
+				it->second->handleFd(fd, mask);
+			}
+		}
+
+		// fd handlers might have consumed the pending events, only
+		// read if there still are events to avoid blocking.
+		if (x11_ready && X11::pending() > 0) {
 			return X11::getNextEvent(ev);
 		}
 	}
 	return false;
 }
 
+/**
+ * Watch fd in the event loop, calling handler when it is ready for
+ * any of the operations in mask.
+ */
+void
+WindowManager::addFdHandler(int fd, int mask, FdHandler *handler)
+{
+	_fd_handlers[fd] = handler;
+	_select->add(fd, mask);
+}
+
+void
+WindowManager::removeFdHandler(int fd)
+{
+	if (_fd_handlers.erase(fd)) {
+		_select->remove(fd);
+	}
+}
+
 bool
 WindowManager::handleEventHandlerEvent(XEvent &ev)
 {
@@ -1817,6 +1903,132 @@ WindowManager::handlePekwmCmd(XClientMessageEvent *ev)
 	_pekwm_cmd_buf = "";
 }
 
+/**
+ * Handle request from the control socket. Lines starting with ? are
+ * queries, any other line is an action optionally prefixed with
+ * @window-id selecting the client to run the action on. The reply is a
+ * single line JSON object.
+ */
+void
+WindowManager::handleCtrlLine(const std::string &line, std::string &reply)
+{
+	P_TRACE("received control request: " << line);
+
+	JsonValueObject res;
+	if (line[0] == '?') {
+		ctrlQuery(line.substr(1), res);
+	} else {
+		ctrlAction(line, res);
+	}
+
+	std::ostringstream os;
+	os << res;
+	reply = os.str();
+}
+
+void
+WindowManager::ctrlAction(const std::string &line, JsonValueObject &res)
+{
+	PWinObj *wo = nullptr;
+	std::string::size_type start = 0;
+	if (line[0] == '@') {
+		start = line.find_first_of(" \t");
+		std::string id = line.substr(1, start - 1);
+		char *end;
+		Window win = strtoul(id.c_str(), &end, 0);
+		if (id.empty() || *end != '\0') {
+			res.set("status", new JsonValueString("error"));
+			res.set("error", new JsonValueString("invalid window "
+							     + id));
+			return;
+		}
+
+		// as with _PEKWM_CMD, unknown windows run without a client.
+		wo = Client::findClient(win);
+	}
+
+	Action action;
+	std::string action_str = start == std::string::npos
+		? "" : line.substr(start);
+	if (! ActionConfig::parseAction(action_str, action, CMD_OK)) {
+		res.set("status", new JsonValueString("error"));
+		res.set("error", new JsonValueString("invalid action "
+						     + action_str));
+		return;
+	}
+
+	ActionEvent ae;
+	ae.action_list.push_back(action);
+	ActionPerformed ap(wo, ae);
+	pekwm::actionHandler()->handleAction(&ap);
+	res.set("status", new JsonValueString("ok"));
+}
+
+/**
+ * Query window manager state, clients lists clients in the order they
+ * were managed and stacking lists clients from bottom to top.
+ */
+void
+WindowManager::ctrlQuery(const std::string &query, JsonValueObject &res)
+{
+	JsonValueArray *clients = new JsonValueArray();
+	if (query == "clients") {
+		Client::client_cit it(Client::client_begin());
+		for (; it != Client::client_end(); ++it) {
+			clients->add(ctrlClient(*it));
+		}
+	} else if (query == "stacking") {
+		std::vector<Window> windows;
+		Workspaces::buildClientList(windows, true);
+		std::vector<Window>::iterator it(windows.begin());
+		for (; it != windows.end(); ++it) {
+			Client *client = Client::findClient(*it);
+			if (client) {
+				clients->add(ctrlClient(client));
+			}
+		}
+	} else {
+		delete clients;
+		res.set("status", new JsonValueString("error"));
+		res.set("error", new JsonValueString("unknown query " + query));
+		return;
+	}
+
+	res.set("status", new JsonValueString("ok"));
+	res.set("clients", clients);
+}
+
+JsonValueObject*
+WindowManager::ctrlClient(Client *client)
+{
+	Frame *frame = nullptr;
+	if (client->getParent()
+	    && client->getParent()->isType(PWinObj::WO_FRAME)) {
+		frame = static_cast<Frame*>(client->getParent());
+	}
+
+	JsonValueObject *obj = new JsonValueObject();
+	const Geometry &gm = client->getGeometry();
+	obj->set("window", new JsonValueNumber(client->getWindow()));
+	obj->set("frame_id", new JsonValueNumber(frame ? frame->getId() : 0));
+	obj->set("workspace", new JsonValueNumber(client->getWorkspace()));
+	obj->set("title",
+		 new JsonValueString(client->getTitle()->getVisible()));
+	obj->set("name", new JsonValueString(client->getClassHint().h_name));
+	obj->set("class",
+		 new JsonValueString(client->getClassHint().h_class));
+	obj->set("x", new JsonValueNumber(gm.x));
+	obj->set("y", new JsonValueNumber(gm.y));
+	obj->set("width", new JsonValueNumber(gm.width));
+	obj->set("height", new JsonValueNumber(gm.height));
+	obj->set("active", new JsonValueBoolean(frame
+					       && frame->getActiveClient()
+					       == client));
+	obj->set("focused", new JsonValueBoolean(client->isFocused()));
+	obj->set("iconified", new JsonValueBoolean(client->isIconified()));
+	return obj;
+}
+
 /**
  * Receive data from XClientMessage building up the _pekwm_cmd_buf,
  * command can be split up in multiple messages due to size
@@ -22,7 +22,9 @@
 #include "EventLoop.hh"
 #include "ManagerWindows.hh"
 
+#include "CtrlSocket.hh"
 #include "Os.hh"
+#include "Json.hh"
 #include "tk/Action.hh"
 #include "tk/PWinObj.hh"
 
@@ -30,7 +32,8 @@
 #include <map>
 
 class WindowManager : public AppCtrl,
-		      public EventLoop
+		      public EventLoop,
+		      public CtrlServer::Handler
 {
 public:
 	static WindowManager *start(const std::string &bin_dir,
@@ -60,6 +63,11 @@ public:
 		_event_handler = event_handler;
 	}
 
+	// START - EventLoop interface.
+	virtual void addFdHandler(int fd, int mask, FdHandler *handler);
+	virtual void removeFdHandler(int fd);
+	// END - EventLoop interface.
+
 	// public event handlers used when doing grabbed actions
 	void handleKeyEvent(XKeyEvent *ev);
 	void handleButtonPressEvent(XButtonEvent *ev);
@@ -67,12 +75,21 @@ public:
 
 	bool setScale(double old_scale, double new_scale, bool reload=true);
 
+	// START - CtrlServer::Handler interface.
+	virtual void handleCtrlLine(const std::string &line,
+				    std::string &reply);
+	// END - CtrlServer::Handler interface.
+
 protected:
 	WindowManager(const std::string &bin_dir, Os *os, bool standalone);
 
 	void handlePekwmCmd(XClientMessageEvent *ev);
 	bool recvPekwmCmd(XClientMessageEvent *ev);
 
+	void ctrlAction(const std::string &line, JsonValueObject &res);
+	void ctrlQuery(const std::string &query, JsonValueObject &res);
+	static JsonValueObject *ctrlClient(Client *client);
+
 	void startBackground(const std::string& theme_dir,
 			     const std::string& texture);
 	void stopBackground();
@@ -82,6 +99,7 @@ protected:
 	void writeSysCommand(const std::string &cmd);
 
 private:
+	void saveRestartSnapshot(void);
 	void setupDisplay();
 	void scanWindows(void);
 	void execStartFile(bool skip_start);
@@ -158,6 +176,10 @@ private:
 	std::string _restart_command;
 	std::string _bg_args;
 	OsSelect *_select;
+	/** Control socket used by pekwm_ctrl, fds registered in _select. */
+	CtrlServer *_ctrl;
+	/** Handlers for fds registered in _select with addFdHandler. */
+	std::map<int, FdHandler*> _fd_handlers;
 	/** PID of the pekwm_bg helper */
 	pid_t _bg_pid;
 	/** ChildProcess for the pekwm_sys helper */
@@ -121,6 +121,8 @@ public:
 	static PWinObj* getTopFocusableWO(uint type_mask);
 	static void updateClientList(void);
 	static void updateClientStackingList(void);
+	static void buildClientList(std::vector<Window> &windows,
+				    bool report_all);
 	static void placeWoInsideScreen(PWinObj *wo);
 
 	static void giveInputFocus(PWinObj *wo, bool force = false);
@@ -207,8 +209,6 @@ private:
 
 	static void clearLayoutModels(void);
 
-	static void buildClientList(std::vector<Window> &windows,
-				    bool report_all);
 	static bool warpToWorkspace(uint num, int dir);
 
 	static bool lowerFullscreenWindows(Layer new_layer);
@@ -16,6 +16,8 @@
 #include "Util.hh"
 #include "pekwm_env.hh"
 
+#include "tk/StartupProfile.hh"
+
 #include <iostream>
 #include <string>
 #include <cstring>
@@ -49,6 +51,8 @@ printUsage(void)
 		  << std::endl;
 	std::cout << " --log-file   set log file." << std::endl;
 	std::cout << " --log-level  set log level." << std::endl;
+	std::cout << " --profile-startup report time spent in startup phases"
+		  << std::endl;
 	std::cout << " --replace    replace running window manager"
 		  << std::endl;
 	std::cout << " --skip-start do not run the start file" << std::endl;
@@ -142,6 +146,8 @@ main(int argc, char **argv)
 				std::cerr << "Failed to open log file "
 					  << argv[i] << std::endl;
 			}
+		} else if (strcmp("--profile-startup", argv[i]) == 0) {
+			StartupProfile::setEnabled(true);
 		} else if (strcmp("--replace", argv[i]) == 0) {
 			replace = true;
 		} else if (strcmp("--skip-start", argv[i]) == 0) {
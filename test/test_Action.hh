@@ -23,6 +23,11 @@ public:
 	static void testConstruct(void);
 	static void testParamI(void);
 	static void testParamS(void);
+	static void testActionEventList(void);
+
+private:
+	static ActionEvent *findLinear(ActionEventList &list, uint type,
+				       uint mod, uint sym);
 };
 
 TestAction::TestAction(void)
@@ -41,6 +46,7 @@ TestAction::run_test(TestSpec spec, bool status)
 	TEST_FN(spec, "construct", testConstruct());
 	TEST_FN(spec, "ParamI", testParamI());
 	TEST_FN(spec, "ParamS", testParamS());
+	TEST_FN(spec, "ActionEventList", testActionEventList());
 	return status;
 }
 
@@ -103,6 +109,80 @@ TestAction::testParamS(void)
 		     std::string("second"), a.getParamS(1));
 }
 
+/**
+ * Lookup in a large generated binding list, mixing MOD_ANY and BUTTON_ANY
+ * entries, must give the same result as a linear scan in list order.
+ */
+void
+TestAction::testActionEventList(void)
+{
+	ActionEventList list;
+	ASSERT_EQUAL("empty", static_cast<ActionEvent*>(nullptr),
+		     list.find(MOUSE_EVENT_PRESS, 0, 1));
+
+	uint mods[] = {0, ShiftMask, ControlMask, Mod1Mask, Mod4Mask,
+		       ShiftMask | Mod4Mask, MOD_ANY};
+	uint num_mods = sizeof(mods) / sizeof(mods[0]);
+	uint types[] = {MOUSE_EVENT_PRESS, MOUSE_EVENT_RELEASE,
+			MOUSE_EVENT_DOUBLE, MOUSE_EVENT_MOTION};
+	for (uint i = 0; i < 2000; i++) {
+		ActionEvent ae;
+		ae.type = types[i % 3];
+		ae.mod = mods[(i * 7) % num_mods];
+		ae.sym = (i * 13) % 97;
+		list.push_back(ae);
+	}
+	list.updateIndex();
+
+	for (uint type = 0; type < 4; type++) {
+		for (uint mod = 0; mod < num_mods - 1; mod++) {
+			for (uint sym = 0; sym < 100; sym++) {
+				ASSERT_EQUAL("find",
+					     findLinear(list, types[type],
+							mods[mod], sym),
+					     list.find(types[type], mods[mod],
+						       sym));
+			}
+		}
+	}
+
+	// later MOD_ANY/BUTTON_ANY binding does not shadow an earlier exact
+	// binding and vice versa.
+	ActionEventList order;
+	ActionEvent ae;
+	ae.type = MOUSE_EVENT_RELEASE;
+	ae.mod = MOD_ANY;
+	ae.sym = 1;
+	order.push_back(ae);
+	ae.mod = ShiftMask;
+	order.push_back(ae);
+	ae.sym = BUTTON_ANY;
+	order.push_back(ae);
+	order.updateIndex();
+	ASSERT_EQUAL("MOD_ANY first", &order[0],
+		     order.find(MOUSE_EVENT_RELEASE, ShiftMask, 1));
+	ASSERT_EQUAL("BUTTON_ANY", &order[2],
+		     order.find(MOUSE_EVENT_RELEASE, ShiftMask, 2));
+	ASSERT_EQUAL("no match", static_cast<ActionEvent*>(nullptr),
+		     order.find(MOUSE_EVENT_RELEASE, 0, 2));
+	ASSERT_EQUAL("type", static_cast<ActionEvent*>(nullptr),
+		     order.find(MOUSE_EVENT_PRESS, ShiftMask, 1));
+}
+
+ActionEvent*
+TestAction::findLinear(ActionEventList &list, uint type, uint mod, uint sym)
+{
+	ActionEventList::iterator it = list.begin();
+	for (; it != list.end(); ++it) {
+		if (it->type == type
+		    && (it->mod == MOD_ANY || it->mod == mod)
+		    && (it->sym == BUTTON_ANY || it->sym == sym)) {
+			return &*it;
+		}
+	}
+	return nullptr;
+}
+
 class TestActionConfig : public TestSuite{
 public:
 	TestActionConfig()
@@ -9,16 +9,31 @@
 #include "test.hh"
 #include "wm/AutoProperties.hh"
 #include "wm/WinLayouter.hh"
+#include "tk/ImageHandler.hh"
 
 class AutoPropertiesTest : public AutoProperties {
 public:
-	AutoPropertiesTest() : AutoProperties(nullptr) { }
+	AutoPropertiesTest(ImageHandler *image_handler = nullptr)
+		: AutoProperties(image_handler)
+	{
+	}
 	virtual ~AutoPropertiesTest() { }
 
 	int doParsePlacement(const std::string &str)
 	{
 		return AutoProperties::parsePlacement(str);
 	}
+
+	bool doLoad(const std::string &data)
+	{
+		CfgParserOpt opt("");
+		CfgParser cfg(opt);
+		if (! cfg.parse(data, CfgParserSource::SOURCE_STRING, true)) {
+			return false;
+		}
+		AutoProperties::load(cfg);
+		return true;
+	}
 };
 
 class TestAutoProperties : public TestSuite {
@@ -30,6 +45,7 @@ public:
 
 private:
 	static void testParsePlacement();
+	static void testFindAutoProperty();
 };
 
 TestAutoProperties::TestAutoProperties()
@@ -45,6 +61,7 @@ bool
 TestAutoProperties::run_test(TestSpec spec, bool status)
 {
 	TEST_FN(spec, "parsePlacement", testParsePlacement());
+	TEST_FN(spec, "findAutoProperty", testFindAutoProperty());
 	return status;
 }
 
@@ -61,3 +78,57 @@ TestAutoProperties::testParsePlacement()
 	ASSERT_EQUAL("multi", expected,
 		     apt.doParsePlacement("Centered MouseTopLeft"));
 }
+
+void
+TestAutoProperties::testFindAutoProperty()
+{
+	ImageHandler image_handler(1.0);
+	AutoPropertiesTest apt(&image_handler);
+	ASSERT_TRUE("load",
+		    apt.doLoad("Property = \"^xterm$,^XTerm$\" {\n"
+			       "  Title = \"^vim\"\n"
+			       "  Workspace = \"2\"\n"
+			       "}\n"
+			       "Property = \"^xterm,^XTerm\" {\n"
+			       "  ApplyOn = \"New\"\n"
+			       "  Workspace = \"3\"\n"
+			       "}\n"
+			       "Property = \"^xterm$,XTerm\" {\n"
+			       "  Workspace = \"4\"\n"
+			       "}\n"
+			       "Property = \".*,^Firefox$\" {\n"
+			       "  Workspace = \"5\"\n"
+			       "}\n"
+			       "Property = \"(a|b)term,.*\" {\n"
+			       "  Workspace = \"6\"\n"
+			       "}\n"));
+
+	ClassHint xterm("xterm", "XTerm", "", "vim main.cc", "");
+	AutoProperty *ap = apt.findAutoProperty(xterm);
+	ASSERT_TRUE("title", ap != nullptr);
+	ASSERT_EQUAL("title", 1, ap->workspace);
+
+	// list order is kept when mixing exact and prefix matches
+	xterm.title = "bash";
+	ap = apt.findAutoProperty(xterm, -1, APPLY_ON_NEW);
+	ASSERT_TRUE("apply on", ap != nullptr);
+	ASSERT_EQUAL("apply on", 2, ap->workspace);
+	ap = apt.findAutoProperty(xterm);
+	ASSERT_TRUE("exact", ap != nullptr);
+	ASSERT_EQUAL("exact", 2, ap->workspace);
+	ClassHint xterm2("xterm2", "XTerm", "", "", "");
+	ap = apt.findAutoProperty(xterm2, -1, APPLY_ON_RELOAD);
+	ASSERT_TRUE("prefix only", ap == nullptr);
+
+	ClassHint firefox("Navigator", "Firefox", "", "", "");
+	ap = apt.findAutoProperty(firefox);
+	ASSERT_TRUE("class index", ap != nullptr);
+	ASSERT_EQUAL("class index", 4, ap->workspace);
+
+	ClassHint bterm("bterm", "BTerm", "", "", "");
+	ap = apt.findAutoProperty(bterm);
+	ASSERT_TRUE("regex", ap != nullptr);
+	ASSERT_EQUAL("regex", 5, ap->workspace);
+	ClassHint other("other", "Other", "", "", "");
+	ASSERT_TRUE("no match", apt.findAutoProperty(other) == nullptr);
+}
@@ -21,6 +21,7 @@ public:
 	void testQuotedName();
 
 	void testEmptyVal(void);
+	void testValueEscape(void);
 	void testIncludeWithoutNewline(void);
 	void testExpandVar();
 	void testExpandCurlyVar();
@@ -43,6 +44,9 @@ public:
 	void testParseCurlyVar();
 	void testParseCurlyNotClosedVar();
 
+	// source
+	void testSourceGetUntil();
+
 	// keys
 	void testKeyDefaults();
 };
@@ -103,6 +107,35 @@ TestCfgParser::testEmptyVal(void)
 	ASSERT_EQUAL("value", "", entry->getValue());
 }
 
+void
+TestCfgParser::testValueEscape(void)
+{
+	const char *cfg =
+		"# comment\n"
+		"First = \"a \\\"quoted\\\" \\\\ value\"\n"
+		"Second = \"multi\\\nline\nvalue\" // comment\n"
+		"Third/Name = \"3\"; Fourth = \"4\"\n";
+	CfgParserSourceString *source =
+		new CfgParserSourceString(":memory:", cfg);
+
+	clear();
+	ASSERT_EQUAL("parse ok", true, parse(source));
+	CfgParser::Entry *entry = getEntryRoot()->findEntry("FIRST");
+	ASSERT_EQUAL("first", true, entry != nullptr);
+	ASSERT_EQUAL("first", "a \"quoted\" \\ value", entry->getValue());
+	ASSERT_EQUAL("first line", 2, entry->getLine());
+	entry = getEntryRoot()->findEntry("SECOND");
+	ASSERT_EQUAL("second", true, entry != nullptr);
+	ASSERT_EQUAL("second", "multiline\nvalue", entry->getValue());
+	entry = getEntryRoot()->findEntry("THIRD/NAME");
+	ASSERT_EQUAL("third", true, entry != nullptr);
+	ASSERT_EQUAL("third", "3", entry->getValue());
+	ASSERT_EQUAL("third line", 5, entry->getLine());
+	entry = getEntryRoot()->findEntry("FOURTH");
+	ASSERT_EQUAL("fourth", true, entry != nullptr);
+	ASSERT_EQUAL("fourth", "4", entry->getValue());
+}
+
 void
 TestCfgParser::testIncludeWithoutNewline(void)
 {
@@ -309,6 +342,26 @@ TestCfgParser::testParseCurlyNotClosedVar()
 	ASSERT_EQUAL("var", "", var);
 }
 
+void
+TestCfgParser::testSourceGetUntil()
+{
+	CfgParserSourceString source(":memory:", "name\n= value;");
+	std::string buf;
+	ASSERT_EQUAL("delim", '\n', source.get_until("\n=", buf));
+	ASSERT_EQUAL("buf", "name", buf);
+	ASSERT_EQUAL("line", 0, source.getLine());
+	ASSERT_EQUAL("get", '\n', source.get_char());
+	ASSERT_EQUAL("line", 1, source.getLine());
+	source.unget_char('\n');
+	ASSERT_EQUAL("unget line", 0, source.getLine());
+	ASSERT_EQUAL("get", '\n', source.get_char());
+
+	buf = "";
+	ASSERT_EQUAL("eof", EOF, source.get_until("#", buf));
+	ASSERT_EQUAL("buf", "= value;", buf);
+	ASSERT_EQUAL("get eof", EOF, source.get_char());
+}
+
 void
 TestCfgParser::testKeyDefaults()
 {
@@ -335,6 +388,7 @@ TestCfgParser::run_test(TestSpec spec, bool status)
 	TEST_FN(spec, "quoted name", testQuotedName());
 
 	TEST_FN(spec, "empty val", testEmptyVal());
+	TEST_FN(spec, "value escape", testValueEscape());
 	TEST_FN(spec, "INCLUDE without newline", testIncludeWithoutNewline());
 	TEST_FN(spec, "expand var", testExpandVar());
 	TEST_FN(spec, "expand curly var", testExpandCurlyVar());
@@ -357,6 +411,9 @@ TestCfgParser::run_test(TestSpec spec, bool status)
 	TEST_FN(spec, "${} variable", testParseCurlyVar());
 	TEST_FN(spec, "${ variable", testParseCurlyNotClosedVar());
 
+	// source
+	TEST_FN(spec, "source get_until", testSourceGetUntil());
+
 	// keys
 	TEST_FN(spec, "key defaults", testKeyDefaults());
 
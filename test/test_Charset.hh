@@ -6,6 +6,7 @@
 // See the LICENSE file for more information.
 //
 
+#include <clocale>
 #include <iostream>
 
 #include "test.hh"
@@ -60,6 +61,7 @@ public:
 private:
 	static void testToSystem(void);
 	static void testFromSystem(void);
+	static void testToLower(void);
 #ifdef PEKWM_HAVE_LOCALE_COMBINE
 	static void test_no_grouping_numpunct(void);
 #endif // PEKWM_HAVE_LOCALE_COMBINE
@@ -77,12 +79,32 @@ TestCharset::~TestCharset(void)
 bool
 TestCharset::run_test(TestSpec spec, bool status)
 {
+	TEST_FN(spec, "toLower", testToLower());
 #ifdef PEKWM_HAVE_LOCALE_COMBINE
 	TEST_FN(spec, "no_grouping_numpunct", test_no_grouping_numpunct());
 #endif // PEKWM_HAVE_LOCALE_COMBINE
 	return status;
 }
 
+void
+TestCharset::testToLower(void)
+{
+	ASSERT_EQUAL("ascii", "abc xyz", Charset::toLower("AbC XYZ"));
+
+	std::string prev_locale(setlocale(LC_CTYPE, nullptr));
+	if (setlocale(LC_CTYPE, "C.UTF-8")
+	    || setlocale(LC_CTYPE, "en_US.UTF-8")) {
+		std::string lower = Charset::toLower("\xc3\x84 \xd0\x96 "
+						     "\xe2\x82\xac "
+						     "\xef\xbc\xa1");
+		setlocale(LC_CTYPE, prev_locale.c_str());
+		ASSERT_EQUAL("non ascii",
+			     "\xc3\xa4 \xd0\xb6 \xe2\x82\xac "
+			     "\xef\xbd\x81",
+			     lower);
+	}
+}
+
 #ifdef PEKWM_HAVE_LOCALE_COMBINE
 void
 TestCharset::test_no_grouping_numpunct(void)
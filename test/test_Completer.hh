@@ -0,0 +1,110 @@
+//
+// test_Completer.hh for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#include "test.hh"
+#include "wm/Completer.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+extern "C" {
+#include <sys/stat.h>
+#include <unistd.h>
+}
+
+class TestCompleter : public TestSuite {
+public:
+	TestCompleter()
+		: TestSuite("Completer")
+	{
+	}
+
+	virtual bool run_test(TestSpec spec, bool status);
+
+	static void testPath();
+
+private:
+	static void touch(const std::string &path);
+};
+
+bool
+TestCompleter::run_test(TestSpec spec, bool status)
+{
+	TEST_FN(spec, "path", testPath());
+	return status;
+}
+
+void
+TestCompleter::testPath()
+{
+	std::ostringstream dir;
+	dir << "/tmp/pekwm-test-completer-" << getpid();
+	mkdir(dir.str().c_str(), 0700);
+	touch(dir.str() + "/pekwm_test_alpha");
+	touch(dir.str() + "/pekwm_test_beta");
+	touch(dir.str() + "/other");
+	touch(dir.str() + "/xtra");
+	touch(dir.str() + "/coollo");
+
+	std::string path = Util::getEnv("PATH");
+	Util::setEnv("PATH", dir.str());
+
+	Completer completer;
+	complete_list completions =
+		completer.find_completions("pekwm_test_", 11);
+	ASSERT_EQUAL("prefix", 2, completions.size());
+	ASSERT_EQUAL("prefix", "pekwm_test_alpha", completions[0]);
+	ASSERT_EQUAL("prefix", "pekwm_test_beta", completions[1]);
+
+	completions = completer.find_completions(dir.str() + "/ot", 0);
+	ASSERT_EQUAL("full path", 1, completions.size());
+	ASSERT_EQUAL("full path", dir.str() + "/other", completions[0]);
+
+	completions = completer.find_completions("ptb", 3);
+	ASSERT_EQUAL("subsequence", 1, completions.size());
+	ASSERT_EQUAL("subsequence", "pekwm_test_beta", completions[0]);
+
+	// earliest match first
+	completions = completer.find_completions("ta", 2);
+	ASSERT_EQUAL("subsequence rank", 3, completions.size());
+	ASSERT_EQUAL("subsequence rank", "xtra", completions[0]);
+	ASSERT_EQUAL("subsequence rank", "pekwm_test_alpha", completions[1]);
+	ASSERT_EQUAL("subsequence rank", "pekwm_test_beta", completions[2]);
+
+	// no subsequence matches if an action completed the word
+	completions = completer.find_completions("clo", 3);
+	ASSERT_TRUE("action", ! completions.empty());
+	ASSERT_TRUE("action", std::find(completions.begin(),
+					completions.end(), "coollo")
+		    == completions.end());
+
+	// new entries are picked up on refresh
+	touch(dir.str() + "/pekwm_test_gamma");
+	completer.refresh();
+	completions = completer.find_completions("pekwm_test_g", 12);
+	ASSERT_EQUAL("refresh", 1, completions.size());
+
+	Util::setEnv("PATH", path);
+	unlink((dir.str() + "/pekwm_test_alpha").c_str());
+	unlink((dir.str() + "/pekwm_test_beta").c_str());
+	unlink((dir.str() + "/pekwm_test_gamma").c_str());
+	unlink((dir.str() + "/other").c_str());
+	unlink((dir.str() + "/xtra").c_str());
+	unlink((dir.str() + "/coollo").c_str());
+	rmdir(dir.str().c_str());
+}
+
+void
+TestCompleter::touch(const std::string &path)
+{
+	FILE *fp = fopen(path.c_str(), "w");
+	if (fp) {
+		fclose(fp);
+	}
+}
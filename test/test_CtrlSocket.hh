@@ -0,0 +1,219 @@
+//
+// test_CtrlSocket.hh for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#include "test.hh"
+#include "CtrlSocket.hh"
+
+#include <algorithm>
+#include <sstream>
+
+extern "C" {
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <stdlib.h>
+#include <unistd.h>
+}
+
+/**
+ * Handler replying with the request length and the request itself.
+ */
+class TestCtrlHandler : public CtrlServer::Handler {
+public:
+	virtual void handleCtrlLine(const std::string &line,
+				    std::string &reply)
+	{
+		std::ostringstream os;
+		os << line.size() << " " << line.substr(0, 16);
+		reply = os.str();
+	}
+};
+
+/**
+ * Handler replying with 64k for every request.
+ */
+class TestCtrlLargeHandler : public CtrlServer::Handler {
+public:
+	virtual void handleCtrlLine(const std::string&, std::string &reply)
+	{
+		reply = std::string(64 * 1024, 'x');
+	}
+};
+
+class TestCtrlSocket : public TestSuite {
+public:
+	TestCtrlSocket()
+		: TestSuite("CtrlSocket")
+	{
+	}
+
+	virtual bool run_test(TestSpec spec, bool status);
+
+	static void testPath();
+	static void testRequests();
+	static void testOutMaxSize();
+
+private:
+	static std::string readReplies(CtrlServer &server, OsSelect *select,
+				       int fd, size_t lines);
+};
+
+bool
+TestCtrlSocket::run_test(TestSpec spec, bool status)
+{
+	TEST_FN(spec, "path", testPath());
+	TEST_FN(spec, "requests", testRequests());
+	TEST_FN(spec, "outMaxSize", testOutMaxSize());
+	return status;
+}
+
+void
+TestCtrlSocket::testPath()
+{
+	const char *runtime_dir = getenv("XDG_RUNTIME_DIR");
+	std::string runtime_dir_str(runtime_dir ? runtime_dir : "");
+
+	setenv("XDG_RUNTIME_DIR", "/run/user/1000", 1);
+	std::string path_xdg = CtrlSocket::path(":0.0");
+	std::string path_host = CtrlSocket::path("host/unix:1");
+	unsetenv("XDG_RUNTIME_DIR");
+	std::string path_tmp = CtrlSocket::path(":0");
+	if (runtime_dir) {
+		setenv("XDG_RUNTIME_DIR", runtime_dir_str.c_str(), 1);
+	}
+
+	ASSERT_EQUAL("xdg", "/run/user/1000/pekwm-ctrl-_0.sock", path_xdg);
+	ASSERT_EQUAL("host", "/run/user/1000/pekwm-ctrl-host_unix_1.sock",
+		     path_host);
+	std::ostringstream exp_tmp;
+	exp_tmp << "/tmp/pekwm-" << getuid() << "-ctrl-_0.sock";
+	ASSERT_EQUAL("tmp", exp_tmp.str(), path_tmp);
+}
+
+void
+TestCtrlSocket::testRequests()
+{
+	std::ostringstream path;
+	path << "/tmp/pekwm-test-ctrl-" << getpid() << ".sock";
+
+	TestCtrlHandler handler;
+	OsSelect *select = mkOsSelect();
+	CtrlServer server(select, &handler);
+	ASSERT_TRUE("open", server.open(path.str()));
+
+	int fd = CtrlSocket::connect(path.str());
+	ASSERT_TRUE("connect", fd != -1);
+
+	// multiple requests in a single write, replies in order. no
+	// limit on the request size.
+	std::string large(4096, 'x');
+	std::string req = "first\r\n\nsecond\n" + large + "\n";
+	ASSERT_EQUAL("write", static_cast<ssize_t>(req.size()),
+		     write(fd, req.c_str(), req.size()));
+	std::string replies = readReplies(server, select, fd, 3);
+	ASSERT_EQUAL("replies", "5 first\n6 second\n4096 xxxxxxxxxxxxxxxx\n",
+		     replies);
+	ASSERT_EQUAL("clients", 1, server.numClients());
+
+	// request without newline is handled when the client closes the
+	// write end.
+	ASSERT_EQUAL("write", 4, write(fd, "last", 4));
+	shutdown(fd, SHUT_WR);
+	replies = readReplies(server, select, fd, 1);
+	ASSERT_EQUAL("eof reply", "4 last\n", replies);
+
+	close(fd);
+	server.close();
+	delete select;
+
+	ASSERT_EQUAL("clients", 0, server.numClients());
+	ASSERT_TRUE("unlink", access(path.str().c_str(), F_OK) == -1);
+}
+
+/**
+ * Client sending requests without reading the replies is dropped once
+ * the pending replies exceed the limit.
+ */
+void
+TestCtrlSocket::testOutMaxSize()
+{
+	std::ostringstream path;
+	path << "/tmp/pekwm-test-ctrl-" << getpid() << ".sock";
+
+	TestCtrlLargeHandler handler;
+	OsSelect *select = mkOsSelect();
+	CtrlServer server(select, &handler);
+	ASSERT_TRUE("open", server.open(path.str()));
+
+	int fd = CtrlSocket::connect(path.str());
+	ASSERT_TRUE("connect", fd != -1);
+
+	std::string req;
+	for (int i = 0; i < 128; i++) {
+		req += "x\n";
+	}
+	ASSERT_EQUAL("write", static_cast<ssize_t>(req.size()),
+		     write(fd, req.c_str(), req.size()));
+	bool accepted = false;
+	for (int i = 0; i < 100; i++) {
+		struct timeval tv = {0, 10000};
+		if (select->wait(&tv)) {
+			int sfd, mask;
+			while (select->next(sfd, mask)) {
+				server.handle(sfd, mask);
+			}
+		}
+		accepted = accepted || server.numClients() == 1;
+		if (accepted && server.numClients() == 0) {
+			break;
+		}
+	}
+	ASSERT_TRUE("accepted", accepted);
+	ASSERT_EQUAL("dropped", 0, server.numClients());
+
+	close(fd);
+	server.close();
+	delete select;
+}
+
+/**
+ * Drive the server until the expected number of reply lines has been read
+ * from fd.
+ */
+std::string
+TestCtrlSocket::readReplies(CtrlServer &server, OsSelect *select, int fd,
+			    size_t lines)
+{
+	std::string replies;
+	char buf[1024];
+	for (int i = 0; i < 100; i++) {
+		struct timeval tv = {0, 10000};
+		if (select->wait(&tv)) {
+			int sfd, mask;
+			while (select->next(sfd, mask)) {
+				server.handle(sfd, mask);
+			}
+		}
+
+		struct timeval tv_fd = {0, 0};
+		fd_set rfds;
+		FD_ZERO(&rfds);
+		FD_SET(fd, &rfds);
+		if (::select(fd + 1, &rfds, nullptr, nullptr, &tv_fd) > 0) {
+			ssize_t len = read(fd, buf, sizeof(buf));
+			if (len > 0) {
+				replies.append(buf, len);
+			}
+		}
+
+		size_t num = std::count(replies.begin(), replies.end(), '\n');
+		if (num >= lines) {
+			break;
+		}
+	}
+	return replies;
+}
@@ -0,0 +1,151 @@
+//
+// test_DynamicCommand.hh for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#include "test.hh"
+#include "wm/DynamicCommand.hh"
+
+#include <map>
+
+/**
+ * EventLoop keeping track of registered fd handlers.
+ */
+class TestEventLoop : public EventLoop {
+public:
+	virtual void setEventHandler(EventHandler*) { }
+
+	virtual void addFdHandler(int fd, int, FdHandler *handler)
+	{
+		fds[fd] = handler;
+	}
+
+	virtual void removeFdHandler(int fd) { fds.erase(fd); }
+
+	/** Dispatch to handlers until none are registered, reads block. */
+	void run()
+	{
+		while (! fds.empty()) {
+			std::map<int, FdHandler*>::iterator it(fds.begin());
+			it->second->handleFd(it->first,
+					     OsSelect::OS_SELECT_READ);
+		}
+	}
+
+	std::map<int, FdHandler*> fds;
+};
+
+class TestDynamicCommandListener : public DynamicCommand::Listener {
+public:
+	TestDynamicCommandListener()
+		: done(0)
+	{
+	}
+
+	virtual void dynamicCommandDone(DynamicCommand*) { done++; }
+
+	int done;
+};
+
+class TestDynamicCommand : public TestSuite {
+public:
+	TestDynamicCommand()
+		: TestSuite("DynamicCommand")
+	{
+	}
+
+	virtual bool run_test(TestSpec spec, bool status);
+
+	static void testRun();
+	static void testTtl();
+	static void testStop();
+};
+
+bool
+TestDynamicCommand::run_test(TestSpec spec, bool status)
+{
+	TEST_FN(spec, "run", testRun());
+	TEST_FN(spec, "ttl", testTtl());
+	TEST_FN(spec, "stop", testStop());
+	return status;
+}
+
+void
+TestDynamicCommand::testRun()
+{
+	Os *os = mkOs();
+	TestEventLoop event_loop;
+	TestDynamicCommandListener listener;
+	DynamicCommand cmd(os, &event_loop,
+			   "echo \"Dynamic { }\"; echo $PATH | cut -d: -f1",
+			   "/pekwm/scripts", 0);
+	cmd.setListener(&listener);
+
+	ASSERT_FALSE("output", cmd.hasOutput());
+	ASSERT_TRUE("run", cmd.run());
+	ASSERT_TRUE("running", cmd.isRunning());
+	ASSERT_EQUAL("fd registered", 1, event_loop.fds.size());
+	// running again while running does not start another process
+	ASSERT_TRUE("run", cmd.run());
+	ASSERT_EQUAL("fd registered", 1, event_loop.fds.size());
+
+	event_loop.run();
+	ASSERT_FALSE("running", cmd.isRunning());
+	ASSERT_EQUAL("done", 1, listener.done);
+	ASSERT_TRUE("output", cmd.hasOutput());
+	ASSERT_EQUAL("output", "Dynamic { }\n/pekwm/scripts\n",
+		     cmd.getOutput());
+
+	delete os;
+}
+
+void
+TestDynamicCommand::testTtl()
+{
+	Os *os = mkOs();
+	TestEventLoop event_loop;
+	DynamicCommand cmd(os, &event_loop, "echo", "", 60);
+
+	time_t now = time(nullptr);
+	ASSERT_TRUE("no output", cmd.isExpired(now));
+	ASSERT_TRUE("run", cmd.run());
+	ASSERT_TRUE("running", cmd.isExpired(now));
+	event_loop.run();
+
+	now = time(nullptr);
+	ASSERT_FALSE("fresh", cmd.isExpired(now));
+	ASSERT_FALSE("fresh", cmd.isExpired(now + 30));
+	ASSERT_TRUE("expired", cmd.isExpired(now + 60));
+
+	DynamicCommand cmd_no_ttl(os, &event_loop, "echo", "", 0);
+	cmd_no_ttl.run();
+	event_loop.run();
+	ASSERT_TRUE("no ttl", cmd_no_ttl.isExpired(now));
+
+	delete os;
+}
+
+/**
+ * Stopping a running command does not wait for it to finish, the
+ * command ignores SIGTERM to detect a blocking wait.
+ */
+void
+TestDynamicCommand::testStop()
+{
+	Os *os = mkOs();
+	TestEventLoop event_loop;
+	DynamicCommand *cmd =
+		new DynamicCommand(os, &event_loop,
+				   "trap '' TERM; exec sleep 2", "", 0);
+	ASSERT_TRUE("run", cmd->run());
+
+	time_t start = time(nullptr);
+	delete cmd;
+	ASSERT_TRUE("no wait", time(nullptr) - start < 2);
+	ASSERT_EQUAL("fd removed", 0, event_loop.fds.size());
+
+	delete os;
+}
@@ -34,6 +34,8 @@ public:
 private:
 	static void testAppend();
 	static void testAppendAssign();
+	static void testPersistentBackoff();
+	static void testGetAlarmS();
 };
 TestExternalCommandData::TestExternalCommandData(void)
 	: TestSuite("ExternalCommandData")
@@ -49,6 +51,8 @@ TestExternalCommandData::run_test(TestSpec spec, bool status)
 {
 	TEST_FN(spec, "append", testAppend());
 	TEST_FN(spec, "appendAssign", testAppendAssign());
+	TEST_FN(spec, "persistentBackoff", testPersistentBackoff());
+	TEST_FN(spec, "getAlarmS", testGetAlarmS());
 	return status;
 }
 
@@ -87,3 +91,50 @@ TestExternalCommandData::testAppendAssign()
 	ecd.append("first line\nsecond line\n", "var");
 	ASSERT_EQUAL("multi line", "second line", var_data.get("var"));
 }
+
+void
+TestExternalCommandData::testPersistentBackoff()
+{
+	struct timespec now;
+	ExternalCommandData::CommandProcess cp("true", 4, "", true);
+	ASSERT_TRUE("persistent", cp.isPersistent());
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	ASSERT_TRUE("start immediately", cp.checkInterval(&now));
+
+	// exits right away, backoff doubles up to the interval
+	uint expected[] = {1, 2, 4, 4};
+	for (uint i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+		cp.reset();
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		ASSERT_FALSE("backoff", cp.checkInterval(&now));
+		time_t delay = cp.getNextInterval().tv_sec - now.tv_sec;
+		ASSERT_TRUE("backoff", delay <= expected[i]
+			    && delay >= static_cast<time_t>(expected[i]) - 1);
+	}
+
+	ExternalCommandData::CommandProcess cp_interval("true", 4, "", false);
+	cp_interval.reset();
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	ASSERT_TRUE("interval", cp_interval.getNextInterval().tv_sec
+		    - now.tv_sec >= 3);
+	ASSERT_EQUAL("interval", 1, cp_interval.getBackoffS());
+}
+
+void
+TestExternalCommandData::testGetAlarmS()
+{
+	struct timespec now = {100, 500000000};
+	struct timespec next = {100, 900000000};
+	ASSERT_EQUAL("sub second", 1,
+		     ExternalCommandData::getAlarmS(now, next));
+	next.tv_sec = 101;
+	next.tv_nsec = 100000000;
+	ASSERT_EQUAL("round up", 1, ExternalCommandData::getAlarmS(now, next));
+	next.tv_sec = 102;
+	next.tv_nsec = 600000000;
+	ASSERT_EQUAL("round up", 3, ExternalCommandData::getAlarmS(now, next));
+	next.tv_nsec = 500000000;
+	ASSERT_EQUAL("exact", 2, ExternalCommandData::getAlarmS(now, next));
+	next.tv_sec = 99;
+	ASSERT_EQUAL("passed", 1, ExternalCommandData::getAlarmS(now, next));
+}
@@ -0,0 +1,235 @@
+//
+// test_ImageHandler.hh for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#include "test.hh"
+#include "tk/ImageCache.hh"
+#include "tk/ImageHandler.hh"
+#include "tk/PImageLoaderPng.hh"
+
+#include <cstring>
+#include <sstream>
+
+extern "C" {
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+}
+
+class TestImageHandler : public TestSuite {
+public:
+	TestImageHandler()
+		: TestSuite("ImageHandler")
+	{
+	}
+
+	virtual bool run_test(TestSpec spec, bool status);
+
+#ifdef PEKWM_HAVE_IMAGE_PNG
+	void testHoldImages();
+	void testCache();
+#endif // PEKWM_HAVE_IMAGE_PNG
+
+private:
+	static uint countEntries(const std::string &dir);
+	static void ageEntries(const std::string &dir, time_t secs);
+	static void removeDir(const std::string &dir);
+};
+
+bool
+TestImageHandler::run_test(TestSpec spec, bool status)
+{
+#ifdef PEKWM_HAVE_IMAGE_PNG
+	TEST_FN(spec, "holdImages", testHoldImages());
+	TEST_FN(spec, "cache", testCache());
+#endif // PEKWM_HAVE_IMAGE_PNG
+	return status;
+}
+
+#ifdef PEKWM_HAVE_IMAGE_PNG
+void
+TestImageHandler::testHoldImages()
+{
+	std::ostringstream path;
+	path << "/tmp/pekwm-test-ih-" << getpid() << ".png";
+	uchar data[] = {255, 1, 2, 3};
+	ASSERT_TRUE("save", PImageLoaderPng::save(path.str(), data, 1, 1));
+
+	ImageHandler ih(1.0);
+	PImage *image = ih.getImage(path.str());
+	ASSERT_TRUE("load", image != nullptr);
+	ASSERT_EQUAL("cache hit", image, ih.getImage(path.str()));
+	ih.returnImage(image);
+	ih.returnImage(image);
+	ASSERT_EQUAL("freed", 0, ih.size());
+
+	// unreferenced images are kept while held and re-used
+	image = ih.getImage(path.str());
+	ih.holdImages();
+	ih.returnImage(image);
+	ASSERT_EQUAL("held", 1, ih.size());
+	ASSERT_EQUAL("held re-use", image, ih.getImage(path.str()));
+	ih.returnImage(image);
+	ih.releaseImages();
+	ASSERT_EQUAL("released", 0, ih.size());
+
+	// referenced images are kept on release
+	image = ih.getImage(path.str());
+	ih.holdImages();
+	ih.releaseImages();
+	ASSERT_EQUAL("referenced", 1, ih.size());
+	ih.returnImage(image);
+	ASSERT_EQUAL("freed", 0, ih.size());
+
+	// held images are not scaled again when re-used
+	ImageHandler ih_scaled(2.0);
+	image = ih_scaled.getImage(path.str());
+	ASSERT_EQUAL("scaled", 2, image->getWidth());
+	ih_scaled.holdImages();
+	ih_scaled.returnImage(image);
+	image = ih_scaled.getImage(path.str());
+	ASSERT_EQUAL("scaled re-use", 2, image->getWidth());
+	ih_scaled.releaseImages();
+	ih_scaled.returnImage(image);
+
+	unlink(path.str().c_str());
+}
+
+void
+TestImageHandler::testCache()
+{
+	std::ostringstream base;
+	base << "/tmp/pekwm-test-ic-" << getpid();
+	std::string cache_dir = base.str() + "/cache/images";
+	std::string path = base.str() + "/image.png";
+	mkdir(base.str().c_str(), 0700);
+	uchar data[] = {255, 1, 2, 3,  128, 4, 5, 6};
+	ASSERT_TRUE("save", PImageLoaderPng::save(path, data, 2, 1));
+
+	ImageCache cache(cache_dir, 2);
+	ASSERT_EQUAL("miss", nullptr, cache.load(path, 1.0));
+
+	ImageHandler ih(2.0);
+	ih.setCacheDir(cache_dir);
+	PImage *image = ih.getImage(path);
+	ASSERT_TRUE("load", image != nullptr);
+	ASSERT_EQUAL("scaled", 4, image->getWidth());
+	ih.returnImage(image);
+
+	// entry stored scaled
+	ASSERT_EQUAL("scale miss", nullptr, cache.load(path, 1.0));
+	image = cache.load(path, 2.0);
+	ASSERT_TRUE("hit", image != nullptr);
+	ASSERT_EQUAL("width", 4, image->getWidth());
+	ASSERT_EQUAL("height", 2, image->getHeight());
+	ASSERT_FALSE("alpha", image->useAlpha());
+	ASSERT_EQUAL("data", 0, memcmp(image->getData(), data, 4));
+
+	// modified file invalidates the entry
+	uchar data2[] = {255, 1, 2, 3,  255, 4, 5, 6,  255, 7, 8, 9};
+	ASSERT_TRUE("save", PImageLoaderPng::save(path, data2, 3, 1));
+	ASSERT_EQUAL("modified", nullptr, cache.load(path, 2.0));
+
+	// cache is limited to max entries
+	ASSERT_TRUE("save", cache.save(path, 1.0, image));
+	ASSERT_TRUE("save", cache.save(path, 2.0, image));
+	ASSERT_TRUE("save", cache.save(path, 3.0, image));
+	ASSERT_EQUAL("prune", 2, countEntries(cache_dir));
+
+	// cache is limited to max bytes, entries are 20 + 32 bytes
+	ImageCache cache_bytes(cache_dir, 256, 60);
+	ASSERT_TRUE("save", cache_bytes.save(path, 4.0, image));
+	ASSERT_EQUAL("prune bytes", 1, countEntries(cache_dir));
+
+	// large images are not cached
+	ImageCache cache_small(cache_dir, 256, 1024, 16);
+	ASSERT_FALSE("save large", cache_small.save(path, 5.0, image));
+
+	// entries are pruned least recently used first
+	removeDir(cache_dir);
+	ImageCache cache_lru(cache_dir, 2);
+	ASSERT_TRUE("save", cache_lru.save(path, 1.0, image));
+	ageEntries(cache_dir, 100);
+	ASSERT_TRUE("save", cache_lru.save(path, 2.0, image));
+	ageEntries(cache_dir, 50);
+	delete image;
+	image = cache_lru.load(path, 1.0);
+	ASSERT_TRUE("lru hit", image != nullptr);
+	ASSERT_TRUE("save", cache_lru.save(path, 3.0, image));
+	delete image;
+	ASSERT_EQUAL("lru prune", 2, countEntries(cache_dir));
+	image = cache_lru.load(path, 1.0);
+	ASSERT_TRUE("lru used", image != nullptr);
+	delete image;
+	ASSERT_EQUAL("lru unused", nullptr, cache_lru.load(path, 2.0));
+
+	removeDir(cache_dir);
+	rmdir((base.str() + "/cache").c_str());
+	unlink(path.c_str());
+	rmdir(base.str().c_str());
+}
+#endif // PEKWM_HAVE_IMAGE_PNG
+
+/**
+ * Count entries in dir, excluding . and ..
+ */
+uint
+TestImageHandler::countEntries(const std::string &dir)
+{
+	uint entries = 0;
+	DIR *dh = opendir(dir.c_str());
+	while (dh && readdir(dh)) {
+		entries++;
+	}
+	if (dh) {
+		closedir(dh);
+	}
+	return entries < 2 ? 0 : entries - 2;
+}
+
+/**
+ * Move modification time of all entries in dir secs seconds back.
+ */
+void
+TestImageHandler::ageEntries(const std::string &dir, time_t secs)
+{
+	DIR *dh = opendir(dir.c_str());
+	if (dh == nullptr) {
+		return;
+	}
+	struct dirent *entry;
+	while ((entry = readdir(dh)) != nullptr) {
+		std::string path = dir + "/" + entry->d_name;
+		struct stat st;
+		if (entry->d_name[0] == '.' || stat(path.c_str(), &st)) {
+			continue;
+		}
+		struct timeval tv[2] = {{0, 0}, {0, 0}};
+		tv[0].tv_sec = st.st_atime;
+		tv[1].tv_sec = st.st_mtime - secs;
+		utimes(path.c_str(), tv);
+	}
+	closedir(dh);
+}
+
+void
+TestImageHandler::removeDir(const std::string &dir)
+{
+	DIR *dh = opendir(dir.c_str());
+	if (dh == nullptr) {
+		return;
+	}
+	struct dirent *entry;
+	while ((entry = readdir(dh)) != nullptr) {
+		if (entry->d_name[0] != '.') {
+			unlink((dir + "/" + entry->d_name).c_str());
+		}
+	}
+	closedir(dh);
+	rmdir(dir.c_str());
+}
@@ -119,6 +119,7 @@ private:
 	static void testParseNumber();
 	static void testParseBoolean();
 	static void testParseNull();
+	static void testWrite();
 };
 
 TestJson::TestJson()
@@ -139,6 +140,7 @@ TestJson::run_test(TestSpec spec, bool status)
 	TEST_FN(spec, "parseNumber", testParseNumber());
 	TEST_FN(spec, "parseBoolean", testParseBoolean());
 	TEST_FN(spec, "parseNull", testParseNull());
+	TEST_FN(spec, "write", testWrite());
 	return status;
 }
 
@@ -471,3 +473,29 @@ TestJson::testParseNull()
 	ASSERT_TRUE("invalid", value == nullptr);
 	ASSERT_EQUAL("invalid", "expected null, got: nota", parser.getError());
 }
+
+void
+TestJson::testWrite()
+{
+	JsonValueObject obj;
+	obj.set("id", new JsonValueNumber(20971525));
+	obj.set("ratio", new JsonValueNumber(0.5));
+	obj.set("title", new JsonValueString("a \"b\"\\c\nd\x01"));
+
+	std::ostringstream os;
+	os << obj;
+	ASSERT_EQUAL("write",
+		     "{\"id\": 20971525, \"ratio\": 0.5, "
+		     "\"title\": \"a \\\"b\\\"\\\\c\\nd\\u0001\"}",
+		     os.str());
+
+	// written output must parse back to the same value
+	TestJsonParser parser;
+	JsonValueObject *value = parser.parseObject(os.str().c_str(), 1);
+	ASSERT_EQUAL("parse", "", parser.getError());
+	ASSERT_TRUE("parse", value != nullptr);
+	JsonValueString *title = jsonGetString(value, "title");
+	std::string title_str = title ? **title : "";
+	delete value;
+	ASSERT_EQUAL("parse", "a \"b\"\\c\nd\x01", title_str);
+}
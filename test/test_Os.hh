@@ -7,11 +7,18 @@
 //
 
 #include <iostream>
+#include <sstream>
 
 #include "test.hh"
 #include "Compat.hh"
 #include "Os.hh"
 
+extern "C" {
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+}
+
 class TestOsEnv : public TestSuite {
 public:
 	TestOsEnv()
@@ -87,3 +94,184 @@ TestOsEnv::testCEnv(void)
 
 	ASSERT_EQUAL("missing env", false, true);
 }
+
+class TestOsSelect : public TestSuite {
+public:
+	TestOsSelect()
+		: TestSuite("OsSelect")
+	{
+	}
+
+	virtual bool run_test(TestSpec spec, bool status);
+
+	static void testWait(void);
+	static void testRemove(void);
+	static void testFile(void);
+};
+
+bool
+TestOsSelect::run_test(TestSpec spec, bool status)
+{
+	TEST_FN(spec, "wait", testWait());
+	TEST_FN(spec, "remove", testRemove());
+	TEST_FN(spec, "file", testFile());
+	return status;
+}
+
+void
+TestOsSelect::testWait(void)
+{
+	int fds[2];
+	ASSERT_EQUAL("pipe", 0, pipe(fds));
+
+	OsSelect *select = mkOsSelect();
+	select->add(fds[0], OsSelect::OS_SELECT_READ);
+
+	struct timeval tv = {0, 0};
+	ASSERT_FALSE("no data", select->wait(&tv));
+
+	ASSERT_EQUAL("write", 1, write(fds[1], "x", 1));
+	bool ready = select->wait(&tv);
+	bool is_set = select->isSet(fds[0], OsSelect::OS_SELECT_READ);
+	int fd = -1, mask = 0;
+	bool has_next = select->next(fd, mask);
+	bool has_next_end = select->next(fd, mask);
+
+	delete select;
+	close(fds[0]);
+	close(fds[1]);
+
+	ASSERT_TRUE("data", ready);
+	ASSERT_TRUE("isSet", is_set);
+	ASSERT_TRUE("next", has_next);
+	ASSERT_EQUAL("next fd", fds[0], fd);
+	ASSERT_EQUAL("next mask", OsSelect::OS_SELECT_READ, mask);
+	ASSERT_FALSE("next end", has_next_end);
+}
+
+void
+TestOsSelect::testRemove(void)
+{
+	int fds[2];
+	ASSERT_EQUAL("pipe", 0, pipe(fds));
+
+	OsSelect *select = mkOsSelect();
+	select->add(fds[0], OsSelect::OS_SELECT_READ);
+	ASSERT_EQUAL("write", 1, write(fds[1], "x", 1));
+	select->remove(fds[0]);
+
+	struct timeval tv = {0, 1000};
+	bool ready = select->wait(&tv);
+
+	delete select;
+	close(fds[0]);
+	close(fds[1]);
+
+	ASSERT_FALSE("removed", ready);
+}
+
+/**
+ * Regular files are always readable, as reported by select, even if
+ * the select implementation can not poll them.
+ */
+void
+TestOsSelect::testFile(void)
+{
+	std::ostringstream path;
+	path << "/tmp/pekwm-test-select-" << getpid();
+	int fd = open(path.str().c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+	ASSERT_TRUE("open", fd != -1);
+	unlink(path.str().c_str());
+
+	OsSelect *select = mkOsSelect();
+	select->add(fd, OsSelect::OS_SELECT_READ);
+
+	struct timeval tv = {1, 0};
+	bool ready = select->wait(&tv);
+	bool is_set = select->isSet(fd, OsSelect::OS_SELECT_READ);
+	int next_fd = -1, mask = 0;
+	bool has_next = select->next(next_fd, mask);
+
+	select->remove(fd);
+	tv.tv_sec = 0;
+	bool removed_ready = select->wait(&tv);
+
+	delete select;
+	close(fd);
+
+	ASSERT_TRUE("ready", ready);
+	ASSERT_TRUE("isSet", is_set);
+	ASSERT_TRUE("next", has_next);
+	ASSERT_EQUAL("next fd", fd, next_fd);
+	ASSERT_EQUAL("next mask", OsSelect::OS_SELECT_READ, mask);
+	ASSERT_FALSE("removed", removed_ready);
+}
+
+class TestOsProcess : public TestSuite {
+public:
+	TestOsProcess()
+		: TestSuite("OsProcess")
+	{
+	}
+
+	virtual bool run_test(TestSpec spec, bool status);
+
+	static void testProcessExec(void);
+	static void testChildExec(void);
+};
+
+bool
+TestOsProcess::run_test(TestSpec spec, bool status)
+{
+	TEST_FN(spec, "processExec", testProcessExec());
+	TEST_FN(spec, "childExec", testChildExec());
+	return status;
+}
+
+void
+TestOsProcess::testProcessExec(void)
+{
+	std::vector<std::string> args;
+	args.push_back("sh");
+	args.push_back("-c");
+	args.push_back("exit 3");
+
+	Os *os = mkOs();
+	pid_t pid = os->processExec(args);
+	delete os;
+	ASSERT_TRUE("pid", pid > 0);
+
+	int status;
+	ASSERT_EQUAL("waitpid", pid, waitpid(pid, &status, 0));
+	ASSERT_TRUE("exited", WIFEXITED(status));
+	ASSERT_EQUAL("exit code", 3, WEXITSTATUS(status));
+}
+
+void
+TestOsProcess::testChildExec(void)
+{
+	std::vector<std::string> args;
+	args.push_back("sh");
+	args.push_back("-c");
+	args.push_back("echo $TEST_OS_PROCESS");
+
+	OsEnv env;
+	env.override("TEST_OS_PROCESS", "override");
+	Os *os = mkOs();
+	ChildProcess *process =
+		os->childExec(args, ChildProcess::CHILD_IO_STDOUT, &env);
+	delete os;
+	ASSERT_TRUE("process", process != nullptr);
+
+	std::string output;
+	char buf[64];
+	ssize_t ret;
+	while ((ret = read(process->getReadFd(), buf, sizeof(buf))) > 0) {
+		output.append(buf, ret);
+	}
+	int exitcode;
+	process->wait(exitcode);
+	delete process;
+
+	ASSERT_EQUAL("output", "override\n", output);
+}
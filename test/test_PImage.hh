@@ -8,6 +8,34 @@
 
 #include "test.hh"
 #include "tk/PImage.hh"
+#include "tk/PImageLoaderPng.hh"
+
+extern "C" {
+#include <string.h>
+#include <unistd.h>
+#include <X11/Xutil.h>
+}
+
+/**
+ * PImage with data set from a buffer, giving access to the data for
+ * verification.
+ */
+class TestDataPImage : public PImage {
+public:
+	TestDataPImage(uint width, uint height, const uchar *data)
+		: PImage()
+	{
+		_width = width;
+		_height = height;
+		_data = new uchar[width * height * 4];
+		memcpy(_data, data, width * height * 4);
+	}
+
+	uchar pixel(uint x, uint y, uint channel) const
+	{
+		return _data[(y * _width + x) * 4 + channel];
+	}
+};
 
 class TestPImage : public TestSuite {
 public:
@@ -19,16 +47,210 @@ public:
 	virtual bool run_test(TestSpec spec, bool status);
 
 	void testGetScaledDataPixel();
+	void testScaleSmoothUp();
+	void testScaleSmoothDown();
+	void testDrawAlphaFixed32();
+	void testDrawAlphaFixed24MSB();
+	void testDrawAlphaFixed16();
+#ifdef PEKWM_HAVE_IMAGE_PNG
+	void testPngSaveLoad();
+#endif // PEKWM_HAVE_IMAGE_PNG
+
+private:
+	static void initXImage(XImage &ximage, char *data, int width,
+			       int depth, int bits_per_pixel, int byte_order,
+			       ulong red_mask, ulong green_mask,
+			       ulong blue_mask);
 };
 
 bool
 TestPImage::run_test(TestSpec spec, bool status)
 {
 	TEST_FN(spec, "getScaledDataPixel", testGetScaledDataPixel());
+	TEST_FN(spec, "scaleSmoothUp", testScaleSmoothUp());
+	TEST_FN(spec, "scaleSmoothDown", testScaleSmoothDown());
+	TEST_FN(spec, "drawAlphaFixed32", testDrawAlphaFixed32());
+	TEST_FN(spec, "drawAlphaFixed24MSB", testDrawAlphaFixed24MSB());
+	TEST_FN(spec, "drawAlphaFixed16", testDrawAlphaFixed16());
+#ifdef PEKWM_HAVE_IMAGE_PNG
+	TEST_FN(spec, "pngSaveLoad", testPngSaveLoad());
+#endif // PEKWM_HAVE_IMAGE_PNG
 	return status;
 }
 
 void
 TestPImage::testGetScaledDataPixel()
 {
+	// single pixel source, used to read outside of the data
+	uchar data[] = {255, 10, 20, 30};
+	TestDataPImage image(1, 1, data);
+	image.scale(3, 2);
+	ASSERT_EQUAL("width", 3, image.getWidth());
+	ASSERT_EQUAL("height", 2, image.getHeight());
+	for (uint y = 0; y < 2; y++) {
+		for (uint x = 0; x < 3; x++) {
+			ASSERT_EQUAL("a", 255, image.pixel(x, y, 0));
+			ASSERT_EQUAL("r", 10, image.pixel(x, y, 1));
+			ASSERT_EQUAL("g", 20, image.pixel(x, y, 2));
+			ASSERT_EQUAL("b", 30, image.pixel(x, y, 3));
+		}
+	}
+}
+
+void
+TestPImage::testScaleSmoothUp()
+{
+	uchar data[] = {255, 0, 0, 0,
+			255, 200, 100, 40};
+	TestDataPImage image(2, 1, data);
+	image.scale(4, 1);
+	ASSERT_EQUAL("width", 4, image.getWidth());
+	// edges keep the source value, inner pixels are interpolated
+	ASSERT_EQUAL("r", 0, image.pixel(0, 0, 1));
+	ASSERT_EQUAL("r", 50, image.pixel(1, 0, 1));
+	ASSERT_EQUAL("r", 150, image.pixel(2, 0, 1));
+	ASSERT_EQUAL("r", 200, image.pixel(3, 0, 1));
+	ASSERT_EQUAL("g", 25, image.pixel(1, 0, 2));
+	ASSERT_EQUAL("b", 30, image.pixel(2, 0, 3));
+	ASSERT_EQUAL("a", 255, image.pixel(2, 0, 0));
+}
+
+void
+TestPImage::testScaleSmoothDown()
+{
+	// 4x4 with columns alternating between black and white, area
+	// filtering to 1x1 should average all pixels.
+	uchar data[4 * 4 * 4];
+	for (uint i = 0; i < 16; i++) {
+		uchar val = (i % 2) ? 255 : 0;
+		data[i * 4] = 255;
+		data[i * 4 + 1] = val;
+		data[i * 4 + 2] = val;
+		data[i * 4 + 3] = 0;
+	}
+	TestDataPImage image(4, 4, data);
+	image.scale(1, 1);
+	ASSERT_EQUAL("a", 255, image.pixel(0, 0, 0));
+	ASSERT_EQUAL("r", 128, image.pixel(0, 0, 1));
+	ASSERT_EQUAL("b", 0, image.pixel(0, 0, 3));
+
+	// 3 to 1 columns, uneven weights
+	uchar data3[] = {255, 30, 0, 0,
+			 255, 60, 0, 0,
+			 255, 90, 0, 0};
+	TestDataPImage image3(3, 1, data3);
+	image3.scale(1, 1);
+	ASSERT_EQUAL("r", 60, image3.pixel(0, 0, 1));
+}
+
+void
+TestPImage::testDrawAlphaFixed32()
+{
+	char data[3 * 4];
+	XImage ximage;
+	initXImage(ximage, data, 3, 24, 32, LSBFirst,
+		   0xff0000, 0xff00, 0xff);
+	XPutPixel(&ximage, 0, 0, 0x000000);
+	XPutPixel(&ximage, 1, 0, 0x405060);
+	XPutPixel(&ximage, 2, 0, 0x0064c8);
+
+	uchar argb[] = {255, 10, 20, 30,
+			0, 1, 2, 3,
+			128, 200, 100, 0};
+	PImage::drawAlphaFixed(&ximage, &ximage, 0, 0, 3, 1, argb);
+
+	ASSERT_EQUAL("solid", 0x0a141eul, XGetPixel(&ximage, 0, 0));
+	ASSERT_EQUAL("transparent", 0x405060ul, XGetPixel(&ximage, 1, 0));
+	ASSERT_EQUAL("blend", 0x646464ul, XGetPixel(&ximage, 2, 0));
+}
+
+void
+TestPImage::testDrawAlphaFixed24MSB()
+{
+	char data[2 * 3];
+	XImage ximage;
+	initXImage(ximage, data, 2, 24, 24, MSBFirst,
+		   0xff, 0xff00, 0xff0000);
+	XPutPixel(&ximage, 0, 0, 0x102030);
+	XPutPixel(&ximage, 1, 0, 0xc86400);
+
+	uchar argb[] = {255, 10, 20, 30,
+			128, 200, 100, 0};
+	PImage::drawAlphaFixed(&ximage, &ximage, 0, 0, 2, 1, argb);
+
+	ASSERT_EQUAL("solid", 0x1e140aul, XGetPixel(&ximage, 0, 0));
+	ASSERT_EQUAL("blend", 0x646464ul, XGetPixel(&ximage, 1, 0));
+	ASSERT_EQUAL("byte order", 30, static_cast<int>(data[0]));
+	ASSERT_EQUAL("byte order", 10, static_cast<int>(data[2]));
+}
+
+void
+TestPImage::testDrawAlphaFixed16()
+{
+	char data[2 * 2];
+	XImage ximage;
+	initXImage(ximage, data, 2, 16, 16, LSBFirst,
+		   0xf800, 0x07e0, 0x001f);
+	XPutPixel(&ximage, 0, 0, 0);
+	XPutPixel(&ximage, 1, 0, 0x1234);
+
+	uchar argb[] = {255, 0xf8, 0xfc, 0xf8,
+			0, 1, 2, 3};
+	PImage::drawAlphaFixed(&ximage, &ximage, 0, 0, 2, 1, argb);
+
+	ASSERT_EQUAL("solid", 0xfffful, XGetPixel(&ximage, 0, 0));
+}
+
+#ifdef PEKWM_HAVE_IMAGE_PNG
+void
+TestPImage::testPngSaveLoad()
+{
+	std::ostringstream path;
+	path << "/tmp/pekwm-test-png-" << getpid() << ".png";
+
+	// alpha is dropped when saving
+	uchar data[] = {128, 1, 2, 3,  255, 4, 5, 6,
+			255, 7, 8, 9,  0, 10, 11, 12};
+	ASSERT_TRUE("save", PImageLoaderPng::save(path.str(), data, 2, 2));
+
+	uint width, height;
+	bool use_alpha;
+	uchar *loaded = PImageLoaderPng::load(path.str(), width, height,
+					      use_alpha);
+	unlink(path.str().c_str());
+	ASSERT_TRUE("load", loaded != nullptr);
+	ASSERT_EQUAL("width", 2, width);
+	ASSERT_EQUAL("height", 2, height);
+	ASSERT_FALSE("alpha", use_alpha);
+	std::vector<int> expected, actual;
+	for (uint i = 0; i < sizeof(data); i++) {
+		expected.push_back(i % 4 ? data[i] : 255);
+		actual.push_back(loaded[i]);
+	}
+	delete [] loaded;
+	ASSERT_TRUE("data", expected == actual);
+}
+#endif // PEKWM_HAVE_IMAGE_PNG
+
+void
+TestPImage::initXImage(XImage &ximage, char *data, int width,
+		       int depth, int bits_per_pixel, int byte_order,
+		       ulong red_mask, ulong green_mask, ulong blue_mask)
+{
+	memset(&ximage, 0, sizeof(ximage));
+	ximage.width = width;
+	ximage.height = 1;
+	ximage.format = ZPixmap;
+	ximage.data = data;
+	ximage.byte_order = byte_order;
+	ximage.bitmap_unit = 32;
+	ximage.bitmap_bit_order = byte_order;
+	ximage.bitmap_pad = 8;
+	ximage.depth = depth;
+	ximage.bits_per_pixel = bits_per_pixel;
+	ximage.bytes_per_line = width * bits_per_pixel / 8;
+	ximage.red_mask = red_mask;
+	ximage.green_mask = green_mask;
+	ximage.blue_mask = blue_mask;
+	XInitImage(&ximage);
 }
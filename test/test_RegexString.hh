@@ -20,12 +20,14 @@ public:
 
 	virtual bool run_test(TestSpec spec, bool status);
 	static void testEdS(void);
+	static void testLiteral(void);
 };
 
 bool
 TestRegexString::run_test(TestSpec spec, bool status)
 {
 	TEST_FN(spec, "ed_s", testEdS());
+	TEST_FN(spec, "literal", testLiteral());
 	return status;
 }
 
@@ -39,3 +41,51 @@ TestRegexString::testEdS(void)
 	ASSERT_EQUAL("ed_s", "T: My", str);
 }
 
+
+void
+TestRegexString::testLiteral(void)
+{
+	RegexString exact("^xterm$");
+	ASSERT_EQUAL("exact", RegexString::MATCH_EXACT, exact.getMatchType());
+	ASSERT_EQUAL("exact", "xterm", exact.getLiteral());
+	ASSERT_TRUE("exact", exact == "xterm");
+	ASSERT_FALSE("exact", exact == "xterm2");
+
+	RegexString prefix("^XTerm");
+	ASSERT_EQUAL("prefix", RegexString::MATCH_PREFIX,
+		     prefix.getMatchType());
+	ASSERT_TRUE("prefix", prefix == "XTerm");
+	ASSERT_TRUE("prefix", prefix == "XTerm2");
+	ASSERT_FALSE("prefix", prefix == "xterm");
+
+	RegexString suffix("term$");
+	ASSERT_EQUAL("suffix", RegexString::MATCH_SUFFIX,
+		     suffix.getMatchType());
+	ASSERT_TRUE("suffix", suffix == "xterm");
+	ASSERT_FALSE("suffix", suffix == "terminal");
+
+	RegexString substr("/erm/!");
+	ASSERT_EQUAL("substring", RegexString::MATCH_SUBSTRING,
+		     substr.getMatchType());
+	ASSERT_FALSE("substring inverted", substr == "xterm");
+	ASSERT_TRUE("substring inverted", substr == "urxvt");
+
+	// escaped special characters are literal, a trailing escaped $ is
+	// not an anchor.
+	RegexString escaped("^a\\.b\\$");
+	ASSERT_EQUAL("escaped", RegexString::MATCH_PREFIX,
+		     escaped.getMatchType());
+	ASSERT_EQUAL("escaped", "a.b$", escaped.getLiteral());
+	ASSERT_TRUE("escaped", escaped == "a.b$c");
+	ASSERT_FALSE("escaped", escaped == "axb$");
+
+	RegexString regex("^(a|b)$");
+	ASSERT_EQUAL("regex", RegexString::MATCH_REGEX, regex.getMatchType());
+	ASSERT_TRUE("regex", regex == "b");
+	RegexString icase("/^XTERM$/i");
+	ASSERT_EQUAL("icase", RegexString::MATCH_REGEX, icase.getMatchType());
+	ASSERT_TRUE("icase", icase == "xterm");
+	RegexString gnu_escape("^\\wterm");
+	ASSERT_EQUAL("gnu escape", RegexString::MATCH_REGEX,
+		     gnu_escape.getMatchType());
+}
@@ -0,0 +1,165 @@
+//
+// test_RestartSnapshot.hh for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#include "test.hh"
+#include "wm/RestartSnapshot.hh"
+
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+extern "C" {
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+}
+
+class TestRestartSnapshot : public TestSuite {
+public:
+	TestRestartSnapshot()
+		: TestSuite("RestartSnapshot")
+	{
+	}
+
+	virtual bool run_test(TestSpec spec, bool status);
+
+	static void testSaveLoad();
+	static void testLoadInvalid();
+	static void testLoadVersion();
+
+private:
+	static std::string tmpPath();
+};
+
+bool
+TestRestartSnapshot::run_test(TestSpec spec, bool status)
+{
+	TEST_FN(spec, "saveLoad", testSaveLoad());
+	TEST_FN(spec, "loadInvalid", testLoadInvalid());
+	TEST_FN(spec, "loadVersion", testLoadVersion());
+	return status;
+}
+
+void
+TestRestartSnapshot::testSaveLoad()
+{
+	RestartSnapshot::hint_map hints;
+	hints[PEKWM_FRAME_ID] = RestartSnapshot::Hint(true, 3);
+	hints[PEKWM_FRAME_ORDER] = RestartSnapshot::Hint(true, 1);
+	hints[PEKWM_FRAME_DECOR] = RestartSnapshot::Hint(false, 0);
+
+	RestartSnapshot snapshot;
+	snapshot.add(0x400001, hints);
+	snapshot.add(0x400002, RestartSnapshot::hint_map());
+	ASSERT_EQUAL("size", 1, snapshot.size());
+
+	std::string path = tmpPath();
+	ASSERT_TRUE("save", snapshot.save(path));
+
+	RestartSnapshot loaded;
+	ASSERT_TRUE("load", loaded.load(path));
+	unlink(path.c_str());
+	ASSERT_EQUAL("size", 1, loaded.size());
+	ASSERT_EQUAL("missing", nullptr, loaded.find(0x400002));
+
+	const RestartSnapshot::hint_map *l_hints = loaded.find(0x400001);
+	ASSERT_TRUE("found", l_hints != nullptr);
+	ASSERT_EQUAL("hints", 3, l_hints->size());
+	RestartSnapshot::hint_map::const_iterator it =
+		l_hints->find(PEKWM_FRAME_ID);
+	ASSERT_TRUE("id", it != l_hints->end());
+	ASSERT_TRUE("id", it->second.is_set);
+	ASSERT_EQUAL("id", 3, it->second.value);
+	it = l_hints->find(PEKWM_FRAME_DECOR);
+	ASSERT_TRUE("decor", it != l_hints->end());
+	ASSERT_FALSE("decor", it->second.is_set);
+}
+
+void
+TestRestartSnapshot::testLoadInvalid()
+{
+	std::string path = tmpPath();
+	RestartSnapshot snapshot;
+	ASSERT_FALSE("missing", snapshot.load(path));
+
+	FILE *fp = fopen(path.c_str(), "w");
+	fputs("not a snapshot", fp);
+	fclose(fp);
+	ASSERT_FALSE("magic", snapshot.load(path));
+
+	// truncated after the window count
+	RestartSnapshot::hint_map hints;
+	hints[PEKWM_FRAME_ID] = RestartSnapshot::Hint(true, 1);
+	RestartSnapshot valid;
+	valid.add(0x400001, hints);
+	valid.save(path);
+	truncate(path.c_str(), 24);
+	ASSERT_FALSE("truncated", snapshot.load(path));
+	ASSERT_EQUAL("truncated", 0, snapshot.size());
+
+	unlink(path.c_str());
+}
+
+void
+TestRestartSnapshot::testLoadVersion()
+{
+	std::string path = tmpPath();
+	RestartSnapshot::hint_map hints;
+	hints[PEKWM_FRAME_ID] = RestartSnapshot::Hint(true, 1);
+	RestartSnapshot valid;
+	valid.add(0x400001, hints);
+	valid.save(path);
+
+	// snapshot from a different version, the header no longer match.
+	FILE *fp = fopen(path.c_str(), "r+");
+	fputs("PEKWMRS1", fp);
+	fclose(fp);
+
+	RestartSnapshot snapshot;
+	ASSERT_FALSE("old version", snapshot.load(path));
+	ASSERT_EQUAL("old version", 0, snapshot.size());
+
+	// hints unknown to this version are skipped
+	int64_t now = time(nullptr);
+	uint32_t num_windows = 1, win = 0x400001, num_hints = 2;
+	uint32_t is_set = 1;
+	int64_t value = 4;
+	fp = fopen(path.c_str(), "w");
+	fputs("PEKWMRS2", fp);
+	fwrite(&now, sizeof(now), 1, fp);
+	fwrite(&num_windows, sizeof(num_windows), 1, fp);
+	fwrite(&win, sizeof(win), 1, fp);
+	fwrite(&num_hints, sizeof(num_hints), 1, fp);
+	const char *names[] = {"_PEKWM_FRAME_UNKNOWN", "_PEKWM_FRAME_ID"};
+	for (int i = 0; i < 2; i++) {
+		uint32_t len = strlen(names[i]);
+		fwrite(&len, sizeof(len), 1, fp);
+		fwrite(names[i], 1, len, fp);
+		fwrite(&is_set, sizeof(is_set), 1, fp);
+		fwrite(&value, sizeof(value), 1, fp);
+	}
+	fclose(fp);
+
+	ASSERT_TRUE("unknown hint", snapshot.load(path));
+	unlink(path.c_str());
+	const RestartSnapshot::hint_map *l_hints = snapshot.find(0x400001);
+	ASSERT_TRUE("unknown hint", l_hints != nullptr);
+	ASSERT_EQUAL("unknown hint", 1, l_hints->size());
+	RestartSnapshot::hint_map::const_iterator it =
+		l_hints->find(PEKWM_FRAME_ID);
+	ASSERT_TRUE("unknown hint", it != l_hints->end());
+	ASSERT_EQUAL("unknown hint", 4, it->second.value);
+}
+
+std::string
+TestRestartSnapshot::tmpPath()
+{
+	std::ostringstream path;
+	path << "/tmp/pekwm-test-snapshot-" << getpid();
+	return path.str();
+}
@@ -0,0 +1,130 @@
+//
+// test_SearchMatcher.hh for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#include "test.hh"
+#include "wm/SearchMatcher.hh"
+
+#include <clocale>
+
+class TestSearchMatcher : public TestSuite {
+public:
+	TestSearchMatcher()
+		: TestSuite("SearchMatcher")
+	{
+	}
+
+	virtual bool run_test(TestSpec spec, bool status);
+
+	static void testScore();
+	static void testMatch();
+	static void testMatchUtf8();
+};
+
+bool
+TestSearchMatcher::run_test(TestSpec spec, bool status)
+{
+	TEST_FN(spec, "score", testScore());
+	TEST_FN(spec, "match", testMatch());
+	TEST_FN(spec, "matchUtf8", testMatchUtf8());
+	return status;
+}
+
+void
+TestSearchMatcher::testScore()
+{
+	ASSERT_EQUAL("empty", SearchMatcher::NO_MATCH,
+		     SearchMatcher::score("", "xterm"));
+	ASSERT_EQUAL("no match", SearchMatcher::NO_MATCH,
+		     SearchMatcher::score("xz", "xterm"));
+	ASSERT_EQUAL("order", SearchMatcher::NO_MATCH,
+		     SearchMatcher::score("mx", "xterm"));
+	ASSERT_TRUE("subsequence",
+		    SearchMatcher::score("xtm", "xterm")
+		    != SearchMatcher::NO_MATCH);
+
+	// prefix before word start before inside a word
+	int prefix = SearchMatcher::score("ter", "terminal");
+	int word = SearchMatcher::score("ter", "my terminal");
+	int inside = SearchMatcher::score("ter", "xterm");
+	ASSERT_TRUE("prefix", prefix > word);
+	ASSERT_TRUE("word", word > inside);
+
+	// consecutive before spread out, best start is used
+	ASSERT_TRUE("consecutive",
+		    SearchMatcher::score("ab", "xaby")
+		    > SearchMatcher::score("ab", "xaxb"));
+	ASSERT_EQUAL("best start",
+		     SearchMatcher::score("fo", "a fo"),
+		     SearchMatcher::score("fo", "xf a fo"));
+}
+
+void
+TestSearchMatcher::testMatch()
+{
+	int term = 1, emacs = 2, tmux = 3, htop = 4;
+	SearchMatcher matcher;
+	matcher.add(&htop, "htop", 0);
+	matcher.add(&term, "Terminal");
+	matcher.add(&emacs, "emacs: term.c", 1);
+	matcher.add(&tmux, "tmux", 2);
+
+	std::vector<void*> result;
+	ASSERT_EQUAL("empty", 0, matcher.match("", 10, result));
+	ASSERT_EQUAL("empty", 0, result.size());
+
+	ASSERT_EQUAL("t", 4, matcher.match("T", 10, result));
+	ASSERT_EQUAL("t", 4, result.size());
+	// prefix and MRU
+	ASSERT_EQUAL("t", &tmux, result[0]);
+
+	ASSERT_EQUAL("te", 2, matcher.match("te", 10, result));
+	ASSERT_EQUAL("te", &term, result[0]);
+	ASSERT_EQUAL("te", &emacs, result[1]);
+	ASSERT_EQUAL("te", "te", matcher.getQuery());
+
+	// narrowed from the previous matches
+	ASSERT_EQUAL("tem", 2, matcher.match("tem", 10, result));
+	ASSERT_EQUAL("tem", &term, result[0]);
+	ASSERT_EQUAL("temi", 1, matcher.match("temi", 10, result));
+
+	// not extending the previous query, match all candidates
+	ASSERT_EQUAL("to", 1, matcher.match("to", 10, result));
+	ASSERT_EQUAL("to", &htop, result[0]);
+
+	// only the best results are returned
+	ASSERT_EQUAL("max", 4, matcher.match("t", 2, result));
+	ASSERT_EQUAL("max", 2, result.size());
+	ASSERT_EQUAL("max", &tmux, result[0]);
+
+	matcher.clear();
+	ASSERT_EQUAL("clear", 0, matcher.match("t", 10, result));
+}
+
+void
+TestSearchMatcher::testMatchUtf8()
+{
+	// multi-byte characters only match whole characters, the bytes
+	// of \xc3\xa4 are found in \xc3\xa5\xe2\x82\xa4 but not the
+	// character.
+	ASSERT_EQUAL("partial", SearchMatcher::NO_MATCH,
+		     SearchMatcher::score("\xc3\xa4", "\xc3\xa5\xe2\x82\xa4"));
+	ASSERT_TRUE("whole", SearchMatcher::score("\xc3\xa4", "b\xc3\xa4r")
+		    != SearchMatcher::NO_MATCH);
+
+	std::string prev_locale(setlocale(LC_CTYPE, nullptr));
+	if (setlocale(LC_CTYPE, "C.UTF-8")
+	    || setlocale(LC_CTYPE, "en_US.UTF-8")) {
+		int apple = 1;
+		SearchMatcher matcher;
+		matcher.add(&apple, "\xc3\x84PPLE");
+		std::vector<void*> result;
+		size_t num = matcher.match("\xc3\xa4p", 10, result);
+		setlocale(LC_CTYPE, prev_locale.c_str());
+		ASSERT_EQUAL("case", 1, num);
+	}
+}
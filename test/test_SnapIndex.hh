@@ -0,0 +1,114 @@
+//
+// test_SnapIndex.hh for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#include "test.hh"
+#include "wm/SnapIndex.hh"
+
+class TestSnapIndex : public TestSuite {
+public:
+	TestSnapIndex()
+		: TestSuite("SnapIndex")
+	{
+	}
+
+	virtual bool run_test(TestSpec spec, bool status);
+
+	static void testSnapWO();
+	static void testSnapOrder();
+	static void testSnapEdge();
+};
+
+bool
+TestSnapIndex::run_test(TestSpec spec, bool status)
+{
+	TEST_FN(spec, "snapWO", testSnapWO());
+	TEST_FN(spec, "snapOrder", testSnapOrder());
+	TEST_FN(spec, "snapEdge", testSnapEdge());
+	return status;
+}
+
+void
+TestSnapIndex::testSnapWO()
+{
+	SnapIndex index;
+	index.reset(10, 5, 0, 0);
+	index.addWO(Geometry(100, 100, 100, 100));
+	for (int i = 0; i < 100; i++) {
+		// far away windows, not affecting the result
+		index.addWO(Geometry(400 + i, 400 + i, 50, 50));
+	}
+	index.finalize();
+	ASSERT_EQUAL("size", 101, index.numWO());
+
+	// right side of gm attracted to left side of window
+	Geometry gm(45, 120, 50, 50);
+	index.snap(gm);
+	ASSERT_EQUAL("attract left", Geometry(50, 120, 50, 50), gm);
+
+	// left side of gm attracted to right side of window
+	gm = Geometry(208, 150, 50, 50);
+	index.snap(gm);
+	ASSERT_EQUAL("attract right", Geometry(200, 150, 50, 50), gm);
+
+	// resist when moving into the window
+	gm = Geometry(196, 150, 50, 50);
+	index.snap(gm);
+	ASSERT_EQUAL("resist right", Geometry(200, 150, 50, 50), gm);
+
+	// top of gm attracted to bottom of window
+	gm = Geometry(150, 195, 50, 50);
+	index.snap(gm);
+	ASSERT_EQUAL("attract bottom", Geometry(150, 200, 50, 50), gm);
+
+	// not overlapping on the other axis, no snap
+	gm = Geometry(45, 300, 50, 50);
+	index.snap(gm);
+	ASSERT_EQUAL("no overlap", Geometry(45, 300, 50, 50), gm);
+
+	// outside of attract distance
+	gm = Geometry(30, 120, 50, 50);
+	index.snap(gm);
+	ASSERT_EQUAL("outside", Geometry(30, 120, 50, 50), gm);
+}
+
+void
+TestSnapIndex::testSnapOrder()
+{
+	SnapIndex index;
+	index.reset(10, 10, 0, 0);
+	index.addWO(Geometry(100, 0, 100, 100));
+	index.addWO(Geometry(96, 0, 100, 100));
+	index.finalize();
+
+	// both within distance, first added window wins
+	Geometry gm(45, 10, 50, 50);
+	index.snap(gm);
+	ASSERT_EQUAL("order", 50, gm.x);
+}
+
+void
+TestSnapIndex::testSnapEdge()
+{
+	SnapIndex index;
+	index.reset(0, 0, 10, 5);
+	index.addHead(Geometry(0, 0, 800, 600));
+	index.addHead(Geometry(800, 0, 800, 600));
+	index.finalize();
+
+	Geometry gm(8, 545, 100, 50);
+	index.snap(gm);
+	ASSERT_EQUAL("head 0", Geometry(0, 550, 100, 50), gm);
+
+	gm = Geometry(1493, 3, 100, 50);
+	index.snap(gm);
+	ASSERT_EQUAL("head 1", Geometry(1500, 0, 100, 50), gm);
+
+	gm = Geometry(400, 300, 100, 50);
+	index.snap(gm);
+	ASSERT_EQUAL("no snap", Geometry(400, 300, 100, 50), gm);
+}
@@ -0,0 +1,200 @@
+//
+// test_SysInfoData.hh for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#include "test.hh"
+#include "panel/SysInfoData.hh"
+
+#include <cstdio>
+#include <sstream>
+
+extern "C" {
+#include <sys/stat.h>
+#include <unistd.h>
+}
+
+class TestSysInfoData : public TestSuite {
+public:
+	TestSysInfoData();
+	virtual ~TestSysInfoData();
+
+	virtual bool run_test(TestSpec spec, bool status);
+
+private:
+	static void testFile();
+	static void testCpu();
+	static void testNet();
+	static void testDisk();
+	static void testPower();
+
+	static void writeFile(const std::string& path, const std::string& data);
+};
+
+TestSysInfoData::TestSysInfoData()
+	: TestSuite("SysInfoData")
+{
+}
+
+TestSysInfoData::~TestSysInfoData()
+{
+}
+
+bool
+TestSysInfoData::run_test(TestSpec spec, bool status)
+{
+	TEST_FN(spec, "file", testFile());
+	TEST_FN(spec, "cpu", testCpu());
+	TEST_FN(spec, "net", testNet());
+	TEST_FN(spec, "disk", testDisk());
+	TEST_FN(spec, "power", testPower());
+	return status;
+}
+
+void
+TestSysInfoData::testFile()
+{
+	std::ostringstream path;
+	path << "/tmp/pekwm-test-sysinfo-" << getpid();
+	writeFile(path.str(), "first");
+
+	SysInfoFile file;
+	ASSERT_TRUE("open", file.open(path.str()));
+	std::string data;
+	ASSERT_TRUE("read", file.read(data));
+	ASSERT_EQUAL("read", "first", data);
+
+	// content larger than the initial buffer, re-read from the start
+	std::string large(10000, 'x');
+	writeFile(path.str(), large);
+	ASSERT_TRUE("re-read", file.read(data));
+	ASSERT_EQUAL("re-read", large, data);
+
+	unlink(path.str().c_str());
+	SysInfoFile missing;
+	ASSERT_FALSE("missing", missing.open(path.str()));
+	ASSERT_FALSE("missing", missing.read(data));
+}
+
+void
+TestSysInfoData::testCpu()
+{
+	VarData var_data;
+	SysInfoCpu cpu(var_data);
+	cpu.parse("cpu  100 0 100 800 0 0 0 0 0 0\n"
+		  "cpu0 50 0 50 400 0 0 0 0 0 0\n"
+		  "intr 1 2 3\n");
+	ASSERT_EQUAL("first sample", "", var_data.get("sysinfo_cpu_percent"));
+
+	cpu.parse("cpu  150 0 150 850 50 0 0 0 0 0\n"
+		  "cpu0 100 0 100 400 0 0 0 0 0 0\n"
+		  "intr 1 2 3\n");
+	ASSERT_EQUAL("total", "50", var_data.get("sysinfo_cpu_percent"));
+	ASSERT_EQUAL("core", "100", var_data.get("sysinfo_cpu0_percent"));
+}
+
+void
+TestSysInfoData::testNet()
+{
+	VarData var_data;
+	SysInfoNet net(var_data);
+	std::string header =
+		"Inter-|   Receive                            "
+		"                    |  Transmit\n"
+		" face |bytes    packets errs drop fifo frame "
+		"compressed multicast|bytes    packets errs drop fifo colls "
+		"carrier compressed\n";
+	net.parse(header
+		  + "    lo:    1000      10    0    0    0     0 "
+		  "         0         0     1000      10    0    0    0     0"
+		  "       0          0\n"
+		  + "  eth0: 2000 20 0 0 0 0 0 0 500 5 0 0 0 0 0 0\n", 0.0);
+	ASSERT_EQUAL("first sample", "", var_data.get("sysinfo_net_eth0_rx"));
+
+	net.parse(header
+		  + "    lo:    1000      10    0    0    0     0 "
+		  "         0         0     1000      10    0    0    0     0"
+		  "       0          0\n"
+		  + "  eth0: 6000 20 0 0 0 0 0 0 1500 5 0 0 0 0 0 0\n", 2.0);
+	ASSERT_EQUAL("rx", "2000", var_data.get("sysinfo_net_eth0_rx"));
+	ASSERT_EQUAL("tx", "500", var_data.get("sysinfo_net_eth0_tx"));
+	ASSERT_EQUAL("lo", "0", var_data.get("sysinfo_net_lo_rx"));
+
+	// counter reset
+	net.parse("  eth0: 10 20 0 0 0 0 0 0 10 5 0 0 0 0 0 0\n", 1.0);
+	ASSERT_EQUAL("reset", "0", var_data.get("sysinfo_net_eth0_rx"));
+}
+
+void
+TestSysInfoData::testDisk()
+{
+	VarData var_data;
+	SysInfoDisk disk(var_data);
+	disk.parse("   7       0 loop0 10 0 20 0 0 0 0 0 0 0 0\n"
+		   " 259       0 nvme0n1 100 0 200 0 50 0 100 0 0 0 0\n",
+		   0.0);
+	disk.parse("   7       0 loop0 10 0 40 0 0 0 0 0 0 0 0\n"
+		   " 259       0 nvme0n1 100 0 204 0 50 0 108 0 0 0 0\n",
+		   2.0);
+	ASSERT_EQUAL("read", "1024", var_data.get("sysinfo_disk_nvme0n1_read"));
+	ASSERT_EQUAL("write", "2048",
+		     var_data.get("sysinfo_disk_nvme0n1_write"));
+	ASSERT_EQUAL("loop", "", var_data.get("sysinfo_disk_loop0_read"));
+}
+
+void
+TestSysInfoData::testPower()
+{
+	std::ostringstream path;
+	path << "/tmp/pekwm-test-power-" << getpid();
+	std::string bat = path.str() + "/BAT0";
+	std::string ac = path.str() + "/AC";
+	mkdir(path.str().c_str(), 0700);
+	mkdir(bat.c_str(), 0700);
+	mkdir(ac.c_str(), 0700);
+	writeFile(bat + "/capacity", "87\n");
+	writeFile(bat + "/status", "Discharging\n");
+	writeFile(ac + "/online", "0\n");
+
+	VarData var_data;
+	SysInfoPower power(var_data, path.str());
+	ASSERT_TRUE("open", power.open());
+	power.update(1.0);
+	ASSERT_EQUAL("capacity", "87",
+		     var_data.get("sysinfo_power_BAT0_capacity"));
+	ASSERT_EQUAL("status", "Discharging",
+		     var_data.get("sysinfo_power_BAT0_status"));
+	ASSERT_EQUAL("online", "0", var_data.get("sysinfo_power_AC_online"));
+
+	writeFile(bat + "/capacity", "86\n");
+	power.update(1.0);
+	ASSERT_EQUAL("capacity", "86",
+		     var_data.get("sysinfo_power_BAT0_capacity"));
+
+	unlink((bat + "/capacity").c_str());
+	unlink((bat + "/status").c_str());
+	unlink((ac + "/online").c_str());
+	rmdir(bat.c_str());
+	rmdir(ac.c_str());
+	rmdir(path.str().c_str());
+
+	SysInfoPower missing(var_data, path.str());
+	ASSERT_FALSE("missing", missing.open());
+}
+
+/**
+ * Write data to path, truncating the file keeping the inode so already
+ * open file descriptors see the new content.
+ */
+void
+TestSysInfoData::writeFile(const std::string& path, const std::string& data)
+{
+	FILE *fp = fopen(path.c_str(), "w");
+	if (fp) {
+		fwrite(data.c_str(), 1, data.size(), fp);
+		fclose(fp);
+	}
+}
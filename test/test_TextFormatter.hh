@@ -18,6 +18,23 @@ public:
 private:
 	static void testPreprocess();
 	static void testFormat();
+	static void testCompile();
+	static void testObserver();
+};
+
+/**
+ * Observer counting notifications.
+ */
+class TestTextFormatterObserver : public Observer {
+public:
+	TestTextFormatterObserver()
+		: num(0)
+	{
+	}
+
+	virtual void notify(Observable*, Observation*) { num++; }
+
+	int num;
 };
 
 TestTextFormatter::TestTextFormatter()
@@ -34,6 +51,8 @@ TestTextFormatter::run_test(TestSpec spec, bool status)
 {
 	TEST_FN(spec, "preprocess", testPreprocess());
 	TEST_FN(spec, "format", testFormat());
+	TEST_FN(spec, "compile", testCompile());
+	TEST_FN(spec, "observer", testObserver());
 	return status;
 }
 
@@ -64,3 +83,66 @@ TestTextFormatter::testFormat()
 	std::string str("\"%FIELD\"");
 	ASSERT_EQUAL("expand vars", "\"value\"", tf.format(str))
 }
+
+void
+TestTextFormatter::testCompile()
+{
+	VarData var_data;
+	var_data.set("FIELD", "value");
+	WmState wm_state(var_data);
+	TextFormatter tf(var_data, wm_state);
+
+	TextFormatter::segment_vector segments;
+	std::string str("a \\%b %FIELD \"%OTHER\" %:WORKSPACE_NAME: % c");
+	tf.compile(str, segments);
+	ASSERT_EQUAL("segments", 7, segments.size());
+	ASSERT_EQUAL("text", TextFormatter::SEGMENT_TEXT, segments[0].type);
+	ASSERT_EQUAL("text", "a %b ", segments[0].text);
+	ASSERT_EQUAL("field", TextFormatter::SEGMENT_FIELD, segments[1].type);
+	ASSERT_EQUAL("field", var_data.getFieldId("FIELD"),
+		     segments[1].field_id);
+	ASSERT_EQUAL("wm state", TextFormatter::SEGMENT_WM_STATE,
+		     segments[5].type);
+	ASSERT_EQUAL("format", tf.format(str), tf.format(segments));
+	ASSERT_EQUAL("format", "a %b value \"\"   c", tf.format(segments));
+
+	var_data.set("OTHER", "other");
+	ASSERT_EQUAL("format", tf.format(str), tf.format(segments));
+}
+
+void
+TestTextFormatter::testObserver()
+{
+	VarData var_data;
+	WmState wm_state(var_data);
+	TestTextFormatterObserver observer;
+	TestTextFormatterObserver other_observer;
+
+	TextFormatObserver *tfo =
+		new TextFormatObserver(var_data, wm_state, &observer,
+				       "%FIELD %FIELD %OTHER");
+	TextFormatObserver other_tfo(var_data, wm_state, &other_observer,
+				     "%UNRELATED");
+	ASSERT_FALSE("fixed", tfo->isFixed());
+
+	var_data.set("FIELD", "1");
+	ASSERT_EQUAL("field", 1, observer.num);
+	var_data.set("FIELD", "1");
+	ASSERT_EQUAL("unchanged", 1, observer.num);
+	var_data.set("OTHER", "2");
+	ASSERT_EQUAL("other", 2, observer.num);
+	var_data.set("UNRELATED", "3");
+	ASSERT_EQUAL("unrelated", 2, observer.num);
+	ASSERT_EQUAL("unrelated", 1, other_observer.num);
+	ASSERT_EQUAL("format", "1 1 2", tfo->format());
+
+	FieldObservation match(var_data.getFieldId("OTHER"), "OTHER");
+	ASSERT_TRUE("match", tfo->match(&match));
+	FieldObservation no_match(var_data.getFieldId("UNRELATED"),
+				  "UNRELATED");
+	ASSERT_FALSE("match", tfo->match(&no_match));
+
+	delete tfo;
+	var_data.set("FIELD", "4");
+	ASSERT_EQUAL("removed", 2, observer.num);
+}
@@ -23,6 +23,9 @@ private:
 	static void testTimeoutMsToTimespec();
 	static void testTimespecDiffToTimeval();
 	static void testGetNextTimeout();
+	static void testReplace();
+	static void testRemove();
+	static void testStats();
 };
 
 TestTimeouts::TestTimeouts(void)
@@ -39,7 +42,10 @@ TestTimeouts::run_test(TestSpec spec, bool status)
 {
 	TEST_FN(spec, "timeout_ms_to_timespec", testTimeoutMsToTimespec());
 	TEST_FN(spec, "timespec_diff_to_timeval", testTimespecDiffToTimeval());
-	TEST_FN(spec, "getNextTimeout", testTimeoutMsToTimespec());
+	TEST_FN(spec, "getNextTimeout", testGetNextTimeout());
+	TEST_FN(spec, "replace", testReplace());
+	TEST_FN(spec, "remove", testRemove());
+	TEST_FN(spec, "stats", testStats());
 	return status;
 }
 
@@ -112,3 +118,67 @@ TestTimeouts::testGetNextTimeout()
 		     timeouts.getNextTimeout(&tv, action));
 	ASSERT_TRUE("timeval", action.getKey() != 3);
 }
+
+void
+TestTimeouts::testReplace()
+{
+	Timeouts timeouts;
+	timeouts.add(TimeoutAction(1, 5000));
+	timeouts.add(TimeoutAction(2, 6000));
+	timeouts.add(TimeoutAction(3, 7000));
+	ASSERT_EQUAL("size", 3, timeouts.size());
+
+	// replace moving action first and last
+	timeouts.replace(TimeoutAction(3, 0));
+	timeouts.replace(TimeoutAction(1, 8000));
+	ASSERT_EQUAL("size", 3, timeouts.size());
+
+	struct timeval *tv;
+	TimeoutAction action;
+	ASSERT_TRUE("action", timeouts.getNextTimeout(&tv, action));
+	ASSERT_EQUAL("action", 3, action.getKey());
+	ASSERT_FALSE("wait", timeouts.getNextTimeout(&tv, action));
+	ASSERT_TRUE("wait", tv != nullptr);
+	ASSERT_EQUAL("wait", 5, tv->tv_sec);
+}
+
+void
+TestTimeouts::testRemove()
+{
+	Timeouts timeouts;
+	for (int i = 0; i < 10; i++) {
+		timeouts.add(TimeoutAction(i, (i % 3) * 1000 - i));
+	}
+	ASSERT_TRUE("remove", timeouts.remove(4));
+	ASSERT_FALSE("remove", timeouts.remove(4));
+	ASSERT_EQUAL("size", 9, timeouts.size());
+
+	// expired actions (0, 3, 6, 9) come in order of timeout
+	int expected[] = {9, 6, 3, 0};
+	struct timeval *tv;
+	TimeoutAction action;
+	for (int i = 0; i < 4; i++) {
+		ASSERT_TRUE("action", timeouts.getNextTimeout(&tv, action));
+		ASSERT_EQUAL("action", expected[i], action.getKey());
+	}
+	ASSERT_FALSE("wait", timeouts.getNextTimeout(&tv, action));
+	ASSERT_EQUAL("size", 5, timeouts.size());
+}
+
+void
+TestTimeouts::testStats()
+{
+	Timeouts timeouts;
+	timeouts.add(TimeoutAction(1, 0));
+	timeouts.add(TimeoutAction(2, 0));
+	timeouts.add(TimeoutAction(3, 5000));
+
+	struct timeval *tv;
+	TimeoutAction action;
+	ASSERT_TRUE("expired", timeouts.getNextTimeout(&tv, action));
+	ASSERT_TRUE("expired", timeouts.getNextTimeout(&tv, action));
+	ASSERT_FALSE("wait", timeouts.getNextTimeout(&tv, action));
+
+	ASSERT_EQUAL("fired", 2, timeouts.getStats().fired);
+	ASSERT_EQUAL("waits", 1, timeouts.getStats().waits);
+}
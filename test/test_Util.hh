@@ -157,6 +157,7 @@ public:
 	virtual bool run_test(TestSpec spec, bool status);
 
 	static void testSplitString(void);
+	static void testStringToIndex(void);
 	static void assertSplitString(const std::string& msg,
 				      uint e_ret,
 				      std::vector<std::string> e_toks,
@@ -170,6 +171,7 @@ bool
 TestUtil::run_test(TestSpec spec, bool status)
 {
 	TEST_FN(spec, "splitString", testSplitString());
+	TEST_FN(spec, "StringToIndex", testStringToIndex());
 	return status;
 }
 
@@ -186,6 +188,42 @@ TestUtil::testSplitString(void)
 	assertSplitString("no limit", 3, no_limit, "1,2,3", ",");
 }
 
+void
+TestUtil::testStringToIndex(void)
+{
+	Util::StringTo<int> map[] =
+		{{"One", 1},
+		 {"Two", 2},
+		 {"Three", 3},
+		 {"one", 4},
+		 {nullptr, -1}};
+	Util::StringToIndex<int> index(map);
+	ASSERT_EQUAL("case", 1, index.get("ONE"));
+	ASSERT_EQUAL("first wins", 1, index.get("one"));
+	ASSERT_EQUAL("two", 2, index.get("two"));
+	ASSERT_EQUAL("three", 3, index.get("tHREE"));
+	ASSERT_EQUAL("missing", -1, index.get("Four"));
+	ASSERT_EQUAL("empty", -1, index.get(""));
+
+	// all entries of a larger table are found, same as StringToGet
+	std::vector<std::string> names;
+	for (int i = 0; i < 100; i++) {
+		names.push_back("Name" + std::to_string(i));
+	}
+	std::vector<Util::StringTo<int> > large;
+	for (int i = 0; i < 100; i++) {
+		Util::StringTo<int> entry = {names[i].c_str(), i};
+		large.push_back(entry);
+	}
+	Util::StringTo<int> end = {nullptr, -1};
+	large.push_back(end);
+	Util::StringToIndex<int> large_index(&large[0]);
+	for (int i = 0; i < 100; i++) {
+		ASSERT_EQUAL(names[i], Util::StringToGet(&large[0], names[i]),
+			     large_index.get(names[i]));
+	}
+}
+
 void
 TestUtil::assertSplitString(const std::string& msg,
 			    uint e_ret, std::vector<std::string> e_toks,
@@ -0,0 +1,209 @@
+//
+// test_WinLayouter.hh for pekwm
+// Copyright (C) 2025 Claes Nästén <pekdon@gmail.com>
+//
+// This program is licensed under the GNU GPL.
+// See the LICENSE file for more information.
+//
+
+#include "test.hh"
+#include "wm/WinLayouter.hh"
+
+class TestSmartPlacement : public TestSuite {
+public:
+	TestSmartPlacement();
+	virtual ~TestSmartPlacement();
+
+	bool run_test(TestSpec spec, bool status);
+
+	static void testFindEmpty();
+	static void testFindFull();
+	static void testFindDirection();
+	static void testFindCompare();
+
+private:
+	static bool findScan(const std::vector<Geometry> &gms,
+			     const Geometry &head, bool row, bool ltr,
+			     bool ttb, uint width, uint height,
+			     uint offset_x, uint offset_y, int &x, int &y);
+};
+
+TestSmartPlacement::TestSmartPlacement()
+	: TestSuite("SmartPlacement")
+{
+}
+
+TestSmartPlacement::~TestSmartPlacement()
+{
+}
+
+bool
+TestSmartPlacement::run_test(TestSpec spec, bool status)
+{
+	TEST_FN(spec, "findEmpty", testFindEmpty());
+	TEST_FN(spec, "findFull", testFindFull());
+	TEST_FN(spec, "findDirection", testFindDirection());
+	TEST_FN(spec, "findCompare", testFindCompare());
+	return status;
+}
+
+void
+TestSmartPlacement::testFindEmpty()
+{
+	SmartPlacement placement(Geometry(100, 50, 800, 600),
+				 true, true, true);
+	int x, y;
+	ASSERT_TRUE("find", placement.find(200, 100, 0, 0, x, y));
+	ASSERT_EQUAL("find", 100, x);
+	ASSERT_EQUAL("find", 50, y);
+
+	ASSERT_FALSE("too large", placement.find(801, 100, 0, 0, x, y));
+}
+
+void
+TestSmartPlacement::testFindFull()
+{
+	SmartPlacement placement(Geometry(0, 0, 800, 600), true, true, true);
+	placement.add(Geometry(0, 0, 400, 600));
+	placement.add(Geometry(400, 0, 400, 300));
+	placement.add(Geometry(400, 400, 400, 200));
+
+	int x, y;
+	ASSERT_TRUE("find", placement.find(400, 100, 0, 0, x, y));
+	ASSERT_EQUAL("find", 400, x);
+	ASSERT_EQUAL("find", 300, y);
+	ASSERT_FALSE("no space", placement.find(400, 101, 0, 0, x, y));
+	ASSERT_FALSE("no space", placement.find(401, 10, 0, 0, x, y));
+}
+
+void
+TestSmartPlacement::testFindDirection()
+{
+	Geometry head(0, 0, 800, 600);
+	Geometry occupied(0, 0, 100, 100);
+	int x, y;
+
+	SmartPlacement ltr_ttb(head, true, true, true);
+	ltr_ttb.add(occupied);
+	ASSERT_TRUE("find", ltr_ttb.find(100, 100, 0, 0, x, y));
+	ASSERT_EQUAL("ltr ttb", 100, x);
+	ASSERT_EQUAL("ltr ttb", 0, y);
+
+	SmartPlacement rtl_btt(head, true, false, false);
+	rtl_btt.add(occupied);
+	ASSERT_TRUE("find", rtl_btt.find(100, 100, 0, 0, x, y));
+	ASSERT_EQUAL("rtl btt", 700, x);
+	ASSERT_EQUAL("rtl btt", 500, y);
+
+	SmartPlacement col(head, false, true, true);
+	col.add(occupied);
+	ASSERT_TRUE("find", col.find(100, 100, 0, 0, x, y));
+	ASSERT_EQUAL("column", 0, x);
+	ASSERT_EQUAL("column", 100, y);
+}
+
+/**
+ * Compare result with pixel by pixel scanning over a set of pseudo random
+ * layouts in all placement directions.
+ */
+void
+TestSmartPlacement::testFindCompare()
+{
+	Geometry head(10, 20, 320, 240);
+	uint seed = 42;
+	for (int layout = 0; layout < 40; layout++) {
+		std::vector<Geometry> gms;
+		for (int i = 0; i < 1 + layout / 2; i++) {
+			seed = seed * 1103515245 + 12345;
+			int gx = head.x + (seed >> 8) % head.width;
+			seed = seed * 1103515245 + 12345;
+			int gy = head.y + (seed >> 8) % head.height;
+			seed = seed * 1103515245 + 12345;
+			uint gw = 10 + (seed >> 8) % 120;
+			seed = seed * 1103515245 + 12345;
+			uint gh = 10 + (seed >> 8) % 90;
+			gms.push_back(Geometry(gx, gy, gw, gh));
+		}
+
+		for (int mode = 0; mode < 16; mode++) {
+			bool row = mode & 1;
+			bool ltr = mode & 2;
+			bool ttb = mode & 4;
+			uint offset = (mode & 8) ? 5 : 0;
+
+			SmartPlacement placement(head, row, ltr, ttb);
+			std::vector<Geometry>::iterator it(gms.begin());
+			for (; it != gms.end(); ++it) {
+				placement.add(*it);
+			}
+
+			int ex = 0, ey = 0, x = 0, y = 0;
+			bool expected = findScan(gms, head, row, ltr, ttb,
+						 60, 40, offset, offset,
+						 ex, ey);
+			std::ostringstream msg;
+			msg << "layout " << layout << " mode " << mode;
+			ASSERT_EQUAL(msg.str(), expected,
+				     placement.find(60, 40, offset, offset,
+						    x, y));
+			if (expected) {
+				ASSERT_EQUAL(msg.str(), ex, x);
+				ASSERT_EQUAL(msg.str(), ey, y);
+			}
+		}
+	}
+}
+
+/**
+ * Reference implementation scanning one row/column at a time.
+ */
+bool
+TestSmartPlacement::findScan(const std::vector<Geometry> &gms,
+			     const Geometry &head, bool row, bool ltr,
+			     bool ttb, uint width, uint height,
+			     uint offset_x, uint offset_y, int &x, int &y)
+{
+	int step_x = ltr ? 1 : -1;
+	int step_y = ttb ? 1 : -1;
+	int p_width = width + offset_x;
+	int p_height = height + offset_y;
+	int start_x = ltr ? head.x : head.rx() - p_width;
+	int start_y = ttb ? head.y : head.by() - p_height;
+
+	int outer = row ? start_y : start_x;
+	while (row ? (ttb ? outer + p_height <= head.by() : outer >= head.y)
+		   : (ltr ? outer + p_width <= head.rx() : outer >= head.x)) {
+		int inner = row ? start_x : start_y;
+		while (row
+		       ? (ltr ? inner + p_width <= head.rx() : inner >= head.x)
+		       : (ttb ? inner + p_height <= head.by()
+			  : inner >= head.y)) {
+			int test_x = row ? inner : outer;
+			int test_y = row ? outer : inner;
+			int hit = -1;
+			for (uint i = 0; i < gms.size(); i++) {
+				if (gms[i].x < test_x + int(width)
+				    && gms[i].rx() > test_x
+				    && gms[i].y < test_y + int(height)
+				    && gms[i].by() > test_y) {
+					hit = i;
+					break;
+				}
+			}
+			if (hit == -1) {
+				x = test_x;
+				y = test_y;
+				return true;
+			}
+			if (row) {
+				inner = ltr ? gms[hit].rx()
+					    : gms[hit].x - p_width;
+			} else {
+				inner = ttb ? gms[hit].by()
+					    : gms[hit].y - p_height;
+			}
+		}
+		outer += row ? step_y : step_x;
+	}
+	return false;
+}
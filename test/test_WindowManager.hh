@@ -8,6 +8,7 @@
 
 #include "test.hh"
 #include "test_Mock.hh"
+#include "Ctrl.hh"
 #include "wm/Config.hh"
 #include "wm/WindowManager.hh"
 
@@ -17,9 +18,6 @@ extern "C" {
 #include <X11/Xlib.h>
 }
 
-#define UNITTEST
-#include "ctrl/pekwm_ctrl.cc"
-
 class TestWindowManager : public TestSuite,
 			  public WindowManager {
 public:
@@ -85,7 +83,8 @@ TestWindowManager::assertSendRecvCommand(const std::string& msg,
 					 const std::string& cmd)
 {
 	std::vector<XClientMessageEvent> evs;
-	sendCommand(cmd, None, send_message, reinterpret_cast<void*>(&evs));
+	Ctrl::sendCommand(cmd, None, send_message,
+			  reinterpret_cast<void*>(&evs));
 	ASSERT_EQUAL(msg + " sendCommand", expected_size, evs.size());
 	std::vector<XClientMessageEvent>::iterator it = evs.begin();
 	for (; it != evs.end(); ++it) {
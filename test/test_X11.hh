@@ -27,6 +27,9 @@ public:
 	static void assertParseGeometryVal(const std::string &msg,
 					   const std::string &str,
 					   int e_ret, int e_val);
+	static void testNormalizeColorName(void);
+	static void testParseHexColor(void);
+	static void testTrueColorPixel(void);
 };
 
 TestX11::TestX11(void)
@@ -44,6 +47,9 @@ TestX11::run_test(TestSpec spec, bool status)
 {
 	TEST_FN(spec, "parseGeometry", testParseGeometry());
 	TEST_FN(spec, "parseGeometryVal", testParseGeometryVal());
+	TEST_FN(spec, "normalizeColorName", testNormalizeColorName());
+	TEST_FN(spec, "parseHexColor", testParseHexColor());
+	TEST_FN(spec, "trueColorPixel", testTrueColorPixel());
 	return status;
 }
 
@@ -105,3 +111,73 @@ TestX11::assertParseGeometryVal(const std::string &msg,
 	ASSERT_EQUAL(msg + " ret", e_ret, ret);
 	ASSERT_EQUAL(msg + " val", e_val, val);
 }
+
+void
+TestX11::testNormalizeColorName(void)
+{
+	ASSERT_EQUAL("hex", "#aabbcc", normalizeColorName("#AAbbCC"));
+	ASSERT_EQUAL("name", "lightblue", normalizeColorName("Light Blue"));
+	ASSERT_EQUAL("trim", "red", normalizeColorName(" red\t"));
+}
+
+void
+TestX11::testParseHexColor(void)
+{
+	XColor xc;
+	ASSERT_TRUE("rrggbb", parseHexColor("#ff8001", xc));
+	ASSERT_EQUAL("rrggbb red", 0xff00, xc.red);
+	ASSERT_EQUAL("rrggbb green", 0x8000, xc.green);
+	ASSERT_EQUAL("rrggbb blue", 0x0100, xc.blue);
+
+	ASSERT_TRUE("rgb", parseHexColor("#f0A", xc));
+	ASSERT_EQUAL("rgb red", 0xf000, xc.red);
+	ASSERT_EQUAL("rgb green", 0x0000, xc.green);
+	ASSERT_EQUAL("rgb blue", 0xa000, xc.blue);
+
+	ASSERT_TRUE("rrrrggggbbbb", parseHexColor("#123456789abc", xc));
+	ASSERT_EQUAL("rrrrggggbbbb red", 0x1234, xc.red);
+	ASSERT_EQUAL("rrrrggggbbbb green", 0x5678, xc.green);
+	ASSERT_EQUAL("rrrrggggbbbb blue", 0x9abc, xc.blue);
+
+	ASSERT_FALSE("name", parseHexColor("red", xc));
+	ASSERT_FALSE("length", parseHexColor("#ff80", xc));
+	ASSERT_FALSE("digit", parseHexColor("#ff80zz", xc));
+	ASSERT_FALSE("too long", parseHexColor("#123456789abcdef", xc));
+}
+
+void
+TestX11::testTrueColorPixel(void)
+{
+	XColor xc;
+	parseHexColor("#ff8001", xc);
+
+	setTrueColorMasks(0, 0, 0);
+	ASSERT_FALSE("disabled", getTrueColorPixel(xc));
+
+	setTrueColorMasks(0xff0000, 0x00ff00, 0x0000ff);
+	ASSERT_TRUE("888", getTrueColorPixel(xc));
+	ASSERT_EQUAL("888", 0xff8001UL, xc.pixel);
+	ASSERT_EQUAL("888 red", 0xffff, xc.red);
+	ASSERT_EQUAL("888 green", 0x8080, xc.green);
+	ASSERT_EQUAL("888 blue", 0x0101, xc.blue);
+
+	parseHexColor("#ffffff", xc);
+	ASSERT_TRUE("white", getTrueColorPixel(xc));
+	ASSERT_EQUAL("white", 0xffffffUL, xc.pixel);
+	ASSERT_EQUAL("white red", 0xffff, xc.red);
+	ASSERT_EQUAL("white green", 0xffff, xc.green);
+	ASSERT_EQUAL("white blue", 0xffff, xc.blue);
+
+	parseHexColor("#ff8001", xc);
+	setTrueColorMasks(0xf800, 0x07e0, 0x001f);
+	ASSERT_TRUE("565", getTrueColorPixel(xc));
+	ASSERT_EQUAL("565", (0x1fUL << 11) | (0x20UL << 5), xc.pixel);
+	ASSERT_EQUAL("565 red", 0xffff, xc.red);
+	ASSERT_EQUAL("565 green", 0x8208, xc.green);
+	ASSERT_EQUAL("565 blue", 0x0000, xc.blue);
+
+	setTrueColorMasks(0xf0f000, 0x00ff00, 0x0000ff);
+	ASSERT_FALSE("non-contiguous", getTrueColorPixel(xc));
+
+	setTrueColorMasks(0, 0, 0);
+}
@@ -15,9 +15,12 @@
 #include "test_Action.hh"
 #include "test_ActionHandler.hh"
 #include "test_AutoProperties.hh"
+#include "test_Completer.hh"
 #include "test_Config.hh"
+#include "test_DynamicCommand.hh"
 #include "test_ColorPalette.hh"
 #include "test_FontHandler.hh"
+#include "test_ImageHandler.hh"
 #include "test_Frame.hh"
 #include "test_InputDialog.hh"
 #include "test_ManagerWindows.hh"
@@ -30,7 +33,11 @@
 #include "test_PImage.hh"
 #include "test_PMenu.hh"
 #include "test_PSurface.hh"
+#include "test_RestartSnapshot.hh"
+#include "test_SearchMatcher.hh"
+#include "test_SnapIndex.hh"
 #include "test_Theme.hh"
+#include "test_WinLayouter.hh"
 #include "test_WindowManager.hh"
 #include "test_Workspaces.hh"
 #include "test_X11.hh"
@@ -55,14 +62,23 @@ main_tests(int argc, char *argv[])
 	TestActionConfig testActionConfig;
 	TestActionHandler testActionHandler;
 
+	// Completer
+	TestCompleter testCompleter;
+
 	// Config
 	TestConfig testConfig;
 
 	TestColorPalette testColorPalette;
 
+	// DynamicCommand
+	TestDynamicCommand testDynamicCommand;
+
 	// Frame
 	TestFrame testFrame;
 
+	// ImageHandler
+	TestImageHandler testImageHandler;
+
 	// InputDialog
 	TestInputBuffer testInputBuffer;
 
@@ -82,13 +98,28 @@ main_tests(int argc, char *argv[])
 #endif // PEKWM_HAVE_PANGO
 	TestPFontXmb testPFontXmb;
 
+	// PImage
+	TestPImage testPImage;
+
 	// PMenu
 	TestPMenu testPMenu;
 	TestPSurface testPSurface;
 
+	// RestartSnapshot
+	TestRestartSnapshot testRestartSnapshot;
+
+	// SearchMatcher
+	TestSearchMatcher testSearchMatcher;
+
+	// SnapIndex
+	TestSnapIndex testSnapIndex;
+
 	// Theme
 	TestTheme testTheme;
 
+	// WinLayouter
+	TestSmartPlacement testSmartPlacement;
+
 	// WindowManager
 	TestWindowManager testWindowManager;
 	TestWorkspaces testWorkspaces;
@@ -10,10 +10,19 @@
 
 #include "test.hh"
 
-#define UNITTEST
-#include "ctrl/pekwm_ctrl.cc"
+#include "Ctrl.hh"
 
+#include <cstring>
+#include <sstream>
 #include <utility>
+#include <vector>
+
+extern "C" {
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+}
 
 class TestPekwmCtrl : public TestSuite {
 public:
@@ -23,6 +32,8 @@ public:
 	virtual bool run_test(TestSpec spec, bool status);
 
 	static void testSendCmd(void);
+	static void testCtrlRequest(void);
+	static void testCtrlBatch(void);
 };
 
 TestPekwmCtrl::TestPekwmCtrl(void)
@@ -38,6 +49,8 @@ bool
 TestPekwmCtrl::run_test(TestSpec spec, bool status)
 {
 	TEST_FN(spec, "sendCmd", testSendCmd());
+	TEST_FN(spec, "ctrlRequest", testCtrlRequest());
+	TEST_FN(spec, "ctrlBatch", testCtrlBatch());
 	return status;
 }
 
@@ -65,7 +78,7 @@ TestPekwmCtrl::testSendCmd(void)
 
 	// single message
 	bufs.clear();
-	sendCommand("1 message",
+	Ctrl::sendCommand("1 message",
 		    None, send_message, vbufs);
 	ASSERT_EQUAL("send 1", 1, bufs.size());
 	ASSERT_EQUAL("send 1 buf", "1 message", bufs[0].first);
@@ -73,7 +86,7 @@ TestPekwmCtrl::testSendCmd(void)
 
 	// two messages
 	bufs.clear();
-	sendCommand("2 messages 012345678",
+	Ctrl::sendCommand("2 messages 012345678",
 		    None, send_message, vbufs);
 	ASSERT_EQUAL("send 2", 2, bufs.size());
 	ASSERT_EQUAL("send 2 buf 1", "2 messages 01234567", bufs[0].first);
@@ -83,7 +96,7 @@ TestPekwmCtrl::testSendCmd(void)
 
 	// two messages
 	bufs.clear();
-	sendCommand("3 messages with extra padding 0123456789",
+	Ctrl::sendCommand("3 messages with extra padding 0123456789",
 		    None, send_message, vbufs);
 	ASSERT_EQUAL("send 3", 3, bufs.size());
 	ASSERT_EQUAL("send 3 buf 1", "3 messages with ext", bufs[0].first);
@@ -94,6 +107,73 @@ TestPekwmCtrl::testSendCmd(void)
 	ASSERT_EQUAL("send 3 op 3", 3, bufs[2].second);
 }
 
+void
+TestPekwmCtrl::testCtrlRequest(void)
+{
+	ASSERT_EQUAL("no client", "Close\n", Ctrl::mkRequest("Close", None));
+	ASSERT_EQUAL("client", "@4194305 Close\n",
+		     Ctrl::mkRequest("Close", 4194305));
+	// newlines would split the request in two
+	ASSERT_EQUAL("newline", "Exec a b\n",
+		     Ctrl::mkRequest("Exec a\nb", None));
+
+	ASSERT_TRUE("ok", Ctrl::isReplyOk("{\"status\": \"ok\"}"));
+	ASSERT_FALSE("error",
+		     Ctrl::isReplyOk("{\"error\": \"invalid action\", "
+				     "\"status\": \"error\"}"));
+	// status must be parsed, not found anywhere in the reply
+	ASSERT_FALSE("error message",
+		     Ctrl::isReplyOk("{\"error\": \"\\\"status\\\": "
+				     "\\\"ok\\\"\", \"status\": \"error\"}"));
+	ASSERT_TRUE("compact", Ctrl::isReplyOk("{\"status\":\"ok\"}"));
+	ASSERT_FALSE("invalid", Ctrl::isReplyOk("\"status\": \"ok\""));
+}
+
+/**
+ * Batch requests read from a regular file, as with pekwm_ctrl -a batch
+ * < file, with a child process replying ok to every request.
+ */
+void
+TestPekwmCtrl::testCtrlBatch(void)
+{
+	std::ostringstream path;
+	path << "/tmp/pekwm-test-ctrl-" << getpid();
+	int in_fd = open(path.str().c_str(), O_RDWR | O_CREAT | O_TRUNC,
+			 0600);
+	ASSERT_TRUE("open", in_fd != -1);
+	unlink(path.str().c_str());
+	std::string reqs("Close\nExec true\n");
+	ASSERT_TRUE("write", Ctrl::write(in_fd, reqs));
+	lseek(in_fd, 0, SEEK_SET);
+
+	int sv[2];
+	ASSERT_EQUAL("socketpair", 0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+	pid_t pid = fork();
+	if (pid == 0) {
+		close(sv[0]);
+		std::string reqs_read;
+		char c;
+		while (read(sv[1], &c, 1) == 1) {
+			reqs_read += c;
+			if (c == '\n') {
+				Ctrl::write(sv[1], "{\"status\": \"ok\"}\n");
+			}
+		}
+		_exit(reqs_read == reqs ? 0 : 1);
+	}
+	close(sv[1]);
+
+	bool res = Ctrl::batch(in_fd, sv[0]);
+	int status = -1;
+	waitpid(pid, &status, 0);
+	close(sv[0]);
+	close(in_fd);
+
+	ASSERT_TRUE("batch", res);
+	ASSERT_TRUE("requests", WIFEXITED(status));
+	ASSERT_EQUAL("requests", 0, WEXITSTATUS(status));
+}
+
 int
 main(int argc, char *argv[])
 {
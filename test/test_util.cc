@@ -14,6 +14,7 @@
 #include "test_CfgParser.hh"
 #include "test_Charset.hh"
 #include "test_Cond.hh"
+#include "test_CtrlSocket.hh"
 #include "test_Daytime.hh"
 #include "test_Geometry.hh"
 #include "test_Json.hh"
@@ -36,6 +37,7 @@ main(int argc, char *argv[])
 	TestCfgParser testCfgParser;
 	TestCharset testCharset;
 	TestCond testCond;
+	TestCtrlSocket testCtrlSocket;
 	TestDaytime testDaytime;
 	TestGeometry testGeometry;
 	TestGeometryOverlap testGeometryOverlap;
@@ -53,6 +55,8 @@ main(int argc, char *argv[])
 	TestGenerator testGenerator;
 	TestUtil testUtil;
 	TestOsEnv testOsEnv;
+	TestOsSelect testOsSelect;
+	TestOsProcess testOsProcess;
 
 	return TestSuite::main(argc, argv);
 }